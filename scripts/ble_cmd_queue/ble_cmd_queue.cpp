@@ -0,0 +1,128 @@
+// Stress-tests the BLE command queue (src/ble/BleCommandQueue.hpp) on a PC: one producer
+// thread in the role of the NimBLE host task, one consumer in the role of the loop, with
+// 200k commands each way. Every command carries its sequence number in the payload; the
+// consumer checks order, gaps and torn slots.
+//
+//   retry  the producer retries a full queue: every command arrives, in order, intact
+//   drop   the producer drops on full like ControlCallbacks::onWrite: the ones that
+//          arrive are in order and intact, and arrived + dropped() = sent
+//
+// Build (from the repo root):
+//   g++ -std=c++17 -O2 -Wall -Wextra -pthread -Isrc -o ble_cmd_queue scripts/ble_cmd_queue/ble_cmd_queue.cpp
+//
+//   ble_cmd_queue [count]        default 200000 per mode
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "ble/BleCommandQueue.hpp"
+
+namespace {
+
+int g_failures = 0;
+
+void expect(bool ok, const char* what) {
+  printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+  if (!ok) g_failures++;
+}
+
+// Payload derived from the sequence number, so a slot copied while the
+// producer rewrote it shows up as a mismatch
+BleCommand make(uint32_t seq) {
+  BleCommand c;
+  c.kind = (seq & 1) ? BleCommand::Flash : BleCommand::Relay;
+  c.a = (uint8_t)seq;
+  c.b = (uint8_t)(seq >> 8);
+  c.c = (uint8_t)(seq >> 16);
+  c.enqueuedUs = seq;
+  return c;
+}
+
+bool intact(const BleCommand& c) {
+  const BleCommand want = make(c.enqueuedUs);
+  return c.kind == want.kind && c.a == want.a && c.b == want.b && c.c == want.c;
+}
+
+struct Result {
+  uint32_t received = 0;
+  uint32_t outOfOrder = 0;
+  uint32_t gaps = 0;
+  uint32_t torn = 0;
+  uint32_t fullSeen = 0;    // producer-side push() failures
+};
+
+Result run(uint32_t count, bool retry) {
+  BleCommandQueue q;
+  Result r;
+  std::atomic<bool> done{false};
+
+  std::thread consumer([&] {
+    BleCommand c;
+    uint32_t next = 0;
+    for (;;) {
+      // 'done' is read before the last pop, so nothing pushed before it is missed
+      const bool last = done.load(std::memory_order_acquire);
+      if (!q.pop(c)) {
+        if (last) break;
+        std::this_thread::yield();
+        continue;
+      }
+      r.received++;
+      if (!intact(c)) r.torn++;
+      if (c.enqueuedUs < next) r.outOfOrder++;
+      else if (c.enqueuedUs > next && retry) r.gaps++;
+      next = c.enqueuedUs + 1;
+      // The loop drains a batch per pass, then does a pass worth of other
+      // work; the producer fills the queue meanwhile
+      if ((r.received & 15) == 0) {
+        for (int k = 0; k < 4; ++k) std::this_thread::yield();
+      }
+    }
+  });
+
+  for (uint32_t seq = 0; seq < count; ++seq) {
+    const BleCommand c = make(seq);
+    while (!q.push(c)) {
+      r.fullSeen++;
+      if (!retry) break;
+      std::this_thread::yield();
+    }
+    // Without retries, send in bursts of 24 (more than CAPACITY) so some are dropped
+    if (!retry && seq % 24 == 23) std::this_thread::yield();
+  }
+  done.store(true, std::memory_order_release);
+  consumer.join();
+
+  expect(q.dropped() == r.fullSeen, "dropped() counts every full push");
+  return r;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t count = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 0) : 200000;
+
+  printf("retry on full, %u commands\n", count);
+  {
+    const Result r = run(count, true);
+    printf("    %u received, queue full %u times\n", r.received, r.fullSeen);
+    expect(r.fullSeen > 0, "queue ran full");
+    expect(r.received == count, "every command arrives");
+    expect(r.outOfOrder == 0 && r.gaps == 0, "in order, no gaps");
+    expect(r.torn == 0, "no torn slots");
+  }
+
+  printf("drop on full, %u commands\n", count);
+  {
+    const Result r = run(count, false);
+    printf("    %u received, %u dropped\n", r.received, r.fullSeen);
+    expect(r.fullSeen > 0 && r.received > count / 10, "some dropped, some delivered");
+    expect(r.received + r.fullSeen == count, "arrived + dropped = sent");
+    expect(r.outOfOrder == 0, "in order");
+    expect(r.torn == 0, "no torn slots");
+  }
+
+  printf("%s\n", g_failures ? "FAIL" : "all checks passed");
+  return g_failures ? 1 : 0;
+}
@@ -0,0 +1,310 @@
+// Decodes binary status packets (characteristic 0000a120, see src/ble/BleStatusPacket.hpp)
+// captured from a phone's BLE logger or nRF Connect, and compares the binary and JSON
+// status formats: host encode time, payload bytes and radio airtime per notify. Also
+// simulates a session to compare the change-driven notifier with the old 1 s timer.
+//
+// Build (from the repo root):
+//   g++ -std=c++17 -O2 -Isrc -o ble_status scripts/ble_status/ble_status.cpp src/ble/StatusNotifier.cpp
+//
+//   ble_status 01 2a 01 00 ...             decode one packet (hex, spaces/colons optional)
+//   ble_status - < packets.txt             decode one packet per line
+//   ble_status --bench [N]                 encode N packets (default 1000000) each way
+//   ble_status --sim [minutes] [seed]      notify rate and change latency, timer vs StatusNotifier
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ble/BleStatusPacket.hpp"
+#include "ble/StatusNotifier.hpp"
+
+namespace {
+
+// RotaryMode in src/main.cpp; P3..P8 mean whatever the active channel profile maps
+const char* kRotaryNames[] = {"P1 OFF", "P2 RF", "P3", "P4", "P5", "P6", "P7", "P8"};
+
+const char* kFlagNames[] = {"12V", "lvpLatched", "lvpBypass", "outvLatched", "outvBypass",
+                            "cooldown", "startupGuard", "lvpWarn", "revWarn", "revLatched",
+                            "sequence", "diag", "bleed", "wiggle"};
+
+bool parseHex(const char* text, std::vector<uint8_t>& out) {
+  out.clear();
+  int nibble = -1;
+  for (const char* c = text; *c; ++c) {
+    int v;
+    if (*c >= '0' && *c <= '9') v = *c - '0';
+    else if (*c >= 'a' && *c <= 'f') v = *c - 'a' + 10;
+    else if (*c >= 'A' && *c <= 'F') v = *c - 'A' + 10;
+    else if (*c == ' ' || *c == ':' || *c == '-' || *c == '\t' || *c == '\r' || *c == '\n') continue;
+    else return false;
+    if (nibble < 0) {
+      nibble = v;
+    } else {
+      out.push_back((uint8_t)(nibble << 4 | v));
+      nibble = -1;
+    }
+  }
+  return nibble < 0 && !out.empty();
+}
+
+void printStatus(const BleStatusPacket::Status& s) {
+  printf("seq %u  flags 0x%04x", s.seq, s.flags);
+  for (unsigned b = 0; b < sizeof(kFlagNames) / sizeof(kFlagNames[0]); ++b) {
+    if (s.flags & (1u << b)) printf(" %s", kFlagNames[b]);
+  }
+  printf("\n  faults 0x%04x  cooldown %us  relays 0x%02x  bleed 0x%02x\n",
+         s.faultMask, s.cooldownSecs, s.relayMask, s.bleedMask);
+  if (s.loadMilliAmps == BleStatusPacket::LOAD_NONE) printf("  load --");
+  else printf("  load %.3f A", s.loadMilliAmps / 1000.0);
+  if (s.srcMilliVolts == BleStatusPacket::MV_NONE) printf("  src --");
+  else printf("  src %.3f V", s.srcMilliVolts / 1000.0);
+  if (s.outMilliVolts == BleStatusPacket::MV_NONE) printf("  out --");
+  else printf("  out %.3f V", s.outMilliVolts / 1000.0);
+  if (s.sohPct == BleStatusPacket::SOH_UNKNOWN) printf("  soh --\n");
+  else printf("  soh %u%%\n", s.sohPct);
+  printf("  profile %u  rotary %s\n", s.profileId,
+         s.rotaryPos < sizeof(kRotaryNames) / sizeof(kRotaryNames[0]) ? kRotaryNames[s.rotaryPos] : "?");
+}
+
+int decodeOne(const char* text) {
+  std::vector<uint8_t> bytes;
+  BleStatusPacket::Status s;
+  if (!parseHex(text, bytes)) {
+    fprintf(stderr, "ble_status: not hex: %s\n", text);
+    return 1;
+  }
+  if (!BleStatusPacket::decode(bytes.data(), bytes.size(), s)) {
+    fprintf(stderr, "ble_status: %zu bytes is not a status packet (need %zu, version >= 1)\n",
+            bytes.size(), BleStatusPacket::SIZE);
+    return 1;
+  }
+  if (bytes[0] != BleStatusPacket::VERSION) {
+    printf("(version %u, newer fields ignored)\n", bytes[0]);
+  }
+  printStatus(s);
+  return 0;
+}
+
+// A typical running-lights status: the same document TltbBleService serializes
+// with ArduinoJson, floats printed at the precision ArduinoJson keeps for them.
+size_t statusJson(const BleStatusPacket::Status& s, char* out, size_t cap) {
+  return (size_t)snprintf(out, cap,
+      "{\"mode\":\"HD\",\"activeLabel\":\"TAIL\",\"cooldownSecsRemaining\":%u,\"faultMask\":%u,"
+      "\"statusFlags\":%u,\"loadAmps\":%g,\"srcVoltage\":%g,\"outVoltage\":%g,\"soh\":%u,\"relayMask\":%u}",
+      s.cooldownSecs, s.faultMask, s.flags, s.loadMilliAmps / 1000.0f, s.srcMilliVolts / 1000.0f,
+      s.outMilliVolts / 1000.0f, s.sohPct, s.relayMask);
+}
+
+int bench(long n) {
+  BleStatusPacket::Status s;
+  s.flags = BleStatusPacket::kFlagTwelveVoltEnabled;
+  s.relayMask = 0x18;
+  s.sohPct = 87;
+  s.rotaryPos = 5;
+
+  using Clock = std::chrono::steady_clock;
+  uint8_t packet[BleStatusPacket::SIZE];
+  char json[512];
+  size_t jsonLen = 0;
+  uint32_t sink = 0;
+
+  auto t0 = Clock::now();
+  for (long i = 0; i < n; ++i) {
+    s.seq = (uint8_t)i;
+    s.loadMilliAmps = BleStatusPacket::toMilliAmps(4.213f + (i & 7) * 0.011f);
+    s.srcMilliVolts = BleStatusPacket::toMilliVolts(12.84f - (i & 3) * 0.01f);
+    s.outMilliVolts = BleStatusPacket::toMilliVolts(12.71f);
+    BleStatusPacket::encode(s, packet);
+    sink += packet[9];
+  }
+  const double binNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / n;
+
+  t0 = Clock::now();
+  for (long i = 0; i < n; ++i) {
+    s.seq = (uint8_t)i;
+    s.loadMilliAmps = BleStatusPacket::toMilliAmps(4.213f + (i & 7) * 0.011f);
+    s.srcMilliVolts = BleStatusPacket::toMilliVolts(12.84f - (i & 3) * 0.01f);
+    jsonLen = statusJson(s, json, sizeof(json));
+    sink += (uint8_t)json[jsonLen / 2];
+  }
+  const double jsonNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / n;
+
+  BleStatusPacket::Status back;
+  if (!BleStatusPacket::decode(packet, sizeof(packet), back) || back.sohPct != s.sohPct) {
+    fprintf(stderr, "ble_status: round trip failed\n");
+    return 1;
+  }
+
+  printf("%ld packets  (checksum %u)\n", n, sink);
+  printf("%-8s %6s %10s %14s %14s\n", "format", "bytes", "encode ns", "air us (27B)", "air us (251B)");
+  printf("%-8s %6zu %10.1f %14u %14u\n", "json", jsonLen, jsonNs,
+         BleStatusPacket::airtimeUs(jsonLen), BleStatusPacket::airtimeUs(jsonLen, 251));
+  printf("%-8s %6zu %10.1f %14u %14u\n", "binary", BleStatusPacket::SIZE, binNs,
+         BleStatusPacket::airtimeUs(BleStatusPacket::SIZE), BleStatusPacket::airtimeUs(BleStatusPacket::SIZE, 251));
+  return 0;
+}
+
+// ---- Session simulation ----
+// A driver at the trailer: knob / RF changes every 10-40 s (not forced, so the
+// old timer shows them up to 1 s late), an app command about once a minute
+// (forced in both), a 30 s hazard flash every 5 minutes, and load/voltage noise
+// on top of the per-relay load. The loop runs every 5 ms like main.cpp's.
+
+struct SimRng {
+  uint32_t s;
+  uint32_t next() { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+  uint32_t range(uint32_t lo, uint32_t hi) { return lo + next() % (hi - lo + 1); }
+  float noise() { return ((int)(next() % 2001) - 1000) / 1000.0f; }  // -1..1
+};
+
+struct SimEvent {
+  uint32_t tMs;
+  uint8_t relayMask;
+  uint8_t rotaryPos;    // 0xFF = knob not moved
+  bool forced;
+};
+
+struct SimResult {
+  uint32_t notifies = 0, idleNotifies = 0, idleMs = 0;
+  std::vector<uint32_t> latency;   // event -> first notify carrying it
+};
+
+// Old behaviour: every 1000 ms, or at once when forced
+struct FixedTimer {
+  bool force = true;
+  uint32_t last = 0;
+  bool due(uint32_t now) {
+    if (!force && now - last < 1000) return false;
+    force = false;
+    last = now;
+    return true;
+  }
+};
+
+std::vector<SimEvent> simEvents(uint32_t durationMs, uint32_t seed) {
+  SimRng rng{seed};
+  std::vector<SimEvent> ev;
+  uint8_t mask = 0, pos = 0;
+  for (uint32_t t = rng.range(10000, 40000); t < durationMs; t += rng.range(10000, 40000)) {
+    pos = (uint8_t)rng.range(2, 7);
+    mask = (uint8_t)(1u << (pos - 2));
+    ev.push_back({t, mask, pos, false});
+  }
+  for (uint32_t t = rng.range(30000, 90000); t < durationMs; t += rng.range(30000, 90000)) {
+    ev.push_back({t, (uint8_t)(1u << rng.range(0, 5)), 0xFF, true});
+  }
+  for (uint32_t start = 120000; start + 30000 < durationMs; start += 300000) {
+    for (uint32_t t = start; t < start + 30000; t += 333) {   // 90 fpm, 50% duty
+      ev.push_back({t, (uint8_t)(((t - start) / 333) % 2 ? 0x00 : 0x03), 0xFF, false});
+    }
+  }
+  std::sort(ev.begin(), ev.end(), [](const SimEvent& a, const SimEvent& b) { return a.tMs < b.tMs; });
+  return ev;
+}
+
+template <class Policy>
+SimResult simulate(const std::vector<SimEvent>& ev, uint32_t durationMs, uint32_t seed, Policy decide) {
+  SimRng rng{seed ^ 0x9e3779b9u};
+  SimResult r;
+  BleStatusPacket::Status s;
+  s.sohPct = 91;
+  s.flags = BleStatusPacket::kFlagTwelveVoltEnabled;
+  size_t next = 0;
+  uint32_t lastEventMs = 0;
+  std::vector<uint32_t> waiting;   // events not yet carried by a notify
+  float loadA = 0.3f;              // idle draw of the trailer module
+  for (uint32_t t = 0; t < durationMs; t += 5) {
+    bool forced = false;
+    while (next < ev.size() && ev[next].tMs <= t) {
+      const SimEvent& e = ev[next++];
+      const uint8_t pos = e.rotaryPos == 0xFF ? s.rotaryPos : e.rotaryPos;
+      forced |= e.forced;
+      if (e.relayMask == s.relayMask && pos == s.rotaryPos) continue;   // nothing to show
+      s.relayMask = e.relayMask;
+      s.rotaryPos = pos;
+      waiting.push_back(e.tMs);
+      lastEventMs = e.tMs;
+    }
+    // The load settles 20 ms after a relay change (inrush, INA sample period)
+    if (t - lastEventMs >= 20) loadA = 0.3f + 2.1f * __builtin_popcount(s.relayMask);
+    s.loadMilliAmps = BleStatusPacket::toMilliAmps(loadA + 0.03f * rng.noise());
+    s.srcMilliVolts = BleStatusPacket::toMilliVolts(12.8f - 0.02f * loadA + 0.01f * rng.noise());
+    s.outMilliVolts = BleStatusPacket::toMilliVolts(12.7f - 0.03f * loadA + 0.01f * rng.noise());
+    const bool idle = t - lastEventMs > 5000 && waiting.empty();
+    if (idle) r.idleMs += 5;
+    if (decide(t, s, forced)) {
+      r.notifies++;
+      if (idle) r.idleNotifies++;
+      for (uint32_t e : waiting) r.latency.push_back(t - e);
+      waiting.clear();
+    }
+  }
+  return r;
+}
+
+void printSim(const char* name, const SimResult& r, uint32_t durationMs) {
+  std::vector<uint32_t> l = r.latency;
+  std::sort(l.begin(), l.end());
+  auto pct = [&](int p) { return l.empty() ? 0u : l[(l.size() - 1) * p / 100]; };
+  double mean = 0;
+  for (uint32_t v : l) mean += v;
+  mean = l.empty() ? 0 : mean / l.size();
+  printf("%-10s %9.1f %9.1f %7.0f %5u %5u %5u %5u\n", name, r.notifies * 60000.0 / durationMs,
+         r.idleMs ? r.idleNotifies * 60000.0 / r.idleMs : 0.0, mean, pct(50), pct(90), pct(99),
+         l.empty() ? 0u : l.back());
+}
+
+int simulateSessions(uint32_t minutes, uint32_t seed) {
+  const uint32_t durationMs = minutes * 60000u;
+  const std::vector<SimEvent> ev = simEvents(durationMs, seed);
+
+  FixedTimer timer;
+  const SimResult old = simulate(ev, durationMs, seed, [&](uint32_t t, const BleStatusPacket::Status&, bool forced) {
+    timer.force |= forced;
+    return timer.due(t);
+  });
+  StatusNotifier notifier;
+  const SimResult fresh = simulate(ev, durationMs, seed, [&](uint32_t t, const BleStatusPacket::Status& s, bool forced) {
+    if (forced) notifier.force();
+    return notifier.decide(t, s) != StatusNotifier::None;
+  });
+
+  printf("%u min, %zu events, seed %u\n", minutes, ev.size(), seed);
+  printf("%-10s %9s %9s %7s %5s %5s %5s %5s\n", "policy", "notif/min", "idle/min", "mean", "p50", "p90", "p99", "max");
+  printSim("timer 1s", old, durationMs);
+  printSim("change", fresh, durationMs);
+  const StatusNotifier::Stats& st = notifier.stats();
+  printf("change: %u on change, %u heartbeat, %u forced (latency in ms, event -> notify)\n",
+         st.change, st.heartbeat, st.forced);
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc >= 2 && !strcmp(argv[1], "--bench")) {
+    return bench(argc >= 3 ? atol(argv[2]) : 1000000L);
+  }
+  if (argc >= 2 && !strcmp(argv[1], "--sim")) {
+    return simulateSessions(argc >= 3 ? (uint32_t)atoi(argv[2]) : 60u, argc >= 4 ? (uint32_t)atoi(argv[3]) : 1u);
+  }
+  if (argc == 2 && !strcmp(argv[1], "-")) {
+    char line[512];
+    int rc = 0;
+    while (fgets(line, sizeof(line), stdin)) {
+      if (line[0] == '\n' || line[0] == '#') continue;
+      rc |= decodeOne(line);
+    }
+    return rc;
+  }
+  if (argc < 2) {
+    fprintf(stderr, "usage: ble_status <hex bytes...> | ble_status - | ble_status --bench [N] | ble_status --sim [minutes] [seed]\n");
+    return 2;
+  }
+  std::string all;
+  for (int i = 1; i < argc; ++i) all += argv[i];
+  return decodeOne(all.c_str());
+}
@@ -0,0 +1,113 @@
+// Checks the load-current block analysis (src/sensors/SpectrumBlock.cpp, the math behind
+// LoadSpectrum) on a PC against synthetic blocks with known answers: DC only, DC plus one
+// sine, two tones, a tone above Nyquist that must fold, and sensor-like noise.
+//
+// Build (from the repo root):
+//   g++ -std=c++17 -O2 -Wall -Wextra -Isrc -o load_spectrum scripts/load_spectrum/load_spectrum.cpp
+//       src/sensors/SpectrumBlock.cpp
+//
+//   load_spectrum [-v]        -v prints every result
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "sensors/SpectrumBlock.hpp"
+
+namespace {
+
+constexpr float kSampleHz = 370.0f;     // INA226 conversion rate the sampler runs at
+constexpr float kPi = 3.14159265358979f;
+
+struct Tone { float hz, amps; };
+
+bool g_verbose = false;
+int  g_failures = 0;
+
+void expect(bool ok, const char* what) {
+  printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+  if (!ok) g_failures++;
+}
+
+bool near(float v, float want, float tol) { return std::fabs(v - want) <= tol; }
+
+SpectrumBlock::Result run(SpectrumBlock& block, float dc, const Tone* tones, int n, float noise = 0.0f) {
+  static float amps[SpectrumBlock::N];
+  std::mt19937 rng(7);
+  std::normal_distribution<float> gauss(0.0f, noise > 0.0f ? noise : 1.0f);
+  for (uint16_t i = 0; i < SpectrumBlock::N; ++i) {
+    const float t = i / kSampleHz;
+    float a = dc;
+    for (int k = 0; k < n; ++k) a += tones[k].amps * std::sin(2.0f * kPi * tones[k].hz * t + 0.3f * k);
+    if (noise > 0.0f) a += gauss(rng);
+    amps[i] = a;
+  }
+  const uint32_t spanUs = (uint32_t)std::lround((SpectrumBlock::N - 1) * 1e6 / kSampleHz);
+  SpectrumBlock::Result r;
+  block.analyse(amps, spanUs, r);
+  if (g_verbose) {
+    printf("    %.1f Hz  mean %.4f  rms %.4f  ripple %.2f%%  peaks:", r.sampleHz, r.meanA, r.rmsA, r.ripplePct);
+    for (uint8_t k = 0; k < r.peakCount; ++k) printf(" %.2f Hz %.3f A", r.freqHz[k], r.ampA[k]);
+    printf("\n");
+  }
+  return r;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  g_verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+  SpectrumBlock block;
+  if (!block.begin()) { printf("begin failed\n"); return 1; }
+  const float binHz = kSampleHz / SpectrumBlock::N;
+  printf("%u-point blocks at %.0f Hz (bin %.2f Hz)%s\n", (unsigned)SpectrumBlock::N, kSampleHz, binHz,
+         SpectrumBlock::accelerated() ? ", esp-dsp" : "");
+
+  printf("DC 3 A\n");
+  {
+    SpectrumBlock::Result r = run(block, 3.0f, nullptr, 0);
+    expect(r.valid && near(r.sampleHz, kSampleHz, 0.5f), "valid, sample rate from the span");
+    expect(near(r.meanA, 3.0f, 1e-4f) && near(r.rmsA, 3.0f, 1e-4f), "mean = RMS = 3 A");
+    expect(r.ripplePct < 0.01f, "no ripple");
+    expect(r.peakCount == 0, "no tones");
+  }
+
+  printf("DC 2 A + 1 A sine at 50 Hz\n");
+  {
+    const Tone t[] = {{50.0f, 1.0f}};
+    SpectrumBlock::Result r = run(block, 2.0f, t, 1);
+    expect(near(r.meanA, 2.0f, 0.02f), "mean 2 A");
+    expect(near(r.rmsA, std::sqrt(4.5f), 0.02f), "RMS sqrt(2^2 + 1^2/2) = 2.121 A");
+    expect(near(r.ripplePct, 35.36f, 1.0f), "ripple 35.4 %");
+    expect(r.peakCount >= 1 && near(r.freqHz[0], 50.0f, binHz / 2), "strongest tone 50 Hz (within half a bin)");
+    expect(r.peakCount >= 1 && near(r.ampA[0], 1.0f, 0.2f), "tone amplitude 1 A (Hann scalloping <= 15 %)");
+  }
+
+  printf("1 A at 40 Hz + 0.4 A at 120 Hz on 1.5 A\n");
+  {
+    const Tone t[] = {{40.0f, 1.0f}, {120.0f, 0.4f}};
+    SpectrumBlock::Result r = run(block, 1.5f, t, 2);
+    expect(r.peakCount >= 2, "two tones");
+    expect(r.peakCount >= 2 && near(r.freqHz[0], 40.0f, binHz / 2) && near(r.freqHz[1], 120.0f, binHz / 2),
+           "strongest first: 40 Hz, then 120 Hz");
+    expect(r.peakCount >= 2 && r.ampA[0] > r.ampA[1] && near(r.ampA[1], 0.4f, 0.08f), "120 Hz about 0.4 A");
+  }
+
+  printf("0.8 A at 250 Hz (above Nyquist) on 1 A\n");
+  {
+    const Tone t[] = {{250.0f, 0.8f}};
+    SpectrumBlock::Result r = run(block, 1.0f, t, 1);
+    expect(r.peakCount >= 1 && near(r.freqHz[0], kSampleHz - 250.0f, binHz / 2), "folds to 120 Hz");
+  }
+
+  printf("0.6 A at 90 Hz on 2 A with 20 mA sensor noise\n");
+  {
+    const Tone t[] = {{90.0f, 0.6f}};
+    SpectrumBlock::Result r = run(block, 2.0f, t, 1, 0.02f);
+    expect(r.peakCount == 1 && near(r.freqHz[0], 90.0f, binHz / 2), "one tone, noise bins rejected");
+    expect(near(r.rmsA, std::sqrt(4.0f + 0.18f + 0.0004f), 0.02f), "RMS includes the noise");
+  }
+
+  printf("%s\n", g_failures ? "FAIL" : "all checks passed");
+  return g_failures ? 1 : 0;
+}
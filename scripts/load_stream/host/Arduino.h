@@ -0,0 +1,4 @@
+// Host stand-in for the Arduino core: LoadSampler.hpp only needs the fixed-width types.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
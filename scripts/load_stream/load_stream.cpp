@@ -0,0 +1,245 @@
+// Runs the live load stream (src/ble/LoadStream.cpp) on a PC against a simulated INA226
+// ring at the sampler's ~370 S/s and a simulated notify path, with the loop cadence of
+// src/main.cpp. Checks the output rate and grid, that a rate change or stop sends the
+// half-filled packet instead of dropping it, small-MTU packing, no packet spanning a ring
+// overrun, and the back-off and recovery when notifies fail.
+//
+// Build (from the repo root):
+//   g++ -std=c++17 -O2 -Wall -Wextra -Iscripts/load_stream/host -Isrc -o load_stream
+//       scripts/load_stream/load_stream.cpp src/ble/LoadStream.cpp
+//
+//   load_stream [-v]        -v prints the stream's own [BLE] log
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "ble/LoadStream.hpp"
+
+namespace {
+
+constexpr uint32_t kSampleUs = 2700;     // INA226 conversion period the sampler runs at
+constexpr uint32_t kLoopMs = 5;
+
+// The sampler ring: one producer, take() as in src/sensors/LoadSampler.cpp
+std::vector<LoadSampler::Sample> g_ring;
+uint32_t g_head = 0;
+uint32_t g_nextUs = 1000;
+
+}  // namespace
+
+namespace LoadSampler {
+size_t take(Reader& r, Sample* out, size_t max) {
+  if (!r.primed) {
+    r.cursor = g_head;
+    r.primed = true;
+    return 0;
+  }
+  if (g_head - r.cursor > RING_SIZE - 8) {
+    const uint32_t fresh = g_head - (RING_SIZE / 2);
+    r.lost += fresh - r.cursor;
+    r.cursor = fresh;
+  }
+  size_t n = 0;
+  while (n < max && r.cursor != g_head) out[n++] = g_ring[r.cursor++];
+  return n;
+}
+}  // namespace LoadSampler
+
+namespace {
+
+struct Packet {
+  uint32_t sentMs;
+  uint8_t seq, rate, count;
+  uint32_t t0Us;
+  uint16_t mv;
+  size_t len;
+  int16_t firstMa;
+  uint32_t endUs() const { return t0Us + count * (1000000u / rate); }
+};
+
+struct Sim {
+  LoadStream stream;
+  std::vector<Packet> packets;
+  std::vector<uint32_t> attemptMs;   // every send, delivered or not
+  uint32_t nowMs = 0;
+  int failEvery = 0;                 // every Nth notify fails (0 = none)
+  size_t payloadMax = LoadStream::MAX_PAYLOAD;
+  float amps = 2.0f;
+  int logLines = 0;
+  bool verbose = false;
+
+  Sim(bool v) : verbose(v) {
+    g_ring.clear();
+    g_head = 0;
+    g_nextUs = 1000;
+    stream.setLogger([this](const char* line) {
+      logLines++;
+      if (verbose) printf("    %s\n", line);
+    });
+  }
+
+  // Sampler runs up to 'nowMs'; the loop then services the stream
+  void step(bool loopRuns = true) {
+    nowMs += kLoopMs;
+    while (g_nextUs < nowMs * 1000u) {
+      g_ring.push_back({g_nextUs, amps});
+      g_head++;
+      g_nextUs += kSampleUs;
+    }
+    if (!loopRuns) return;
+    stream.service(nowMs, 12700, payloadMax, [this](const uint8_t* d, size_t len) {
+      attemptMs.push_back(nowMs);
+      if (failEvery && attemptMs.size() % failEvery == 0) return false;
+      Packet p;
+      p.sentMs = nowMs;
+      p.seq = d[1];
+      p.rate = d[2];
+      p.count = d[3];
+      p.t0Us = (uint32_t)d[4] | d[5] << 8 | d[6] << 16 | (uint32_t)d[7] << 24;
+      p.mv = (uint16_t)(d[8] | d[9] << 8);
+      p.len = len;
+      p.firstMa = (int16_t)(d[10] | d[11] << 8);
+      packets.push_back(p);
+      return true;
+    });
+  }
+
+  void runMs(uint32_t ms) {
+    for (uint32_t end = nowMs + ms; nowMs < end;) step();
+  }
+};
+
+int g_failures = 0;
+
+void expect(bool ok, const char* what) {
+  printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+  if (!ok) g_failures++;
+}
+
+uint32_t samplesIn(const std::vector<Packet>& ps) {
+  uint32_t n = 0;
+  for (const Packet& p : ps) n += p.count;
+  return n;
+}
+
+// Packets at one rate follow each other on one grid
+bool contiguous(const std::vector<Packet>& ps, size_t from, size_t to) {
+  for (size_t i = from + 1; i < to; ++i) {
+    if (ps[i].rate == ps[i - 1].rate && ps[i].t0Us != ps[i - 1].endUs()) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+
+  printf("100 Hz for 60 s\n");
+  {
+    Sim s(verbose);
+    s.stream.request(100);
+    s.runMs(60000);
+    const uint32_t n = samplesIn(s.packets);
+    uint32_t worstAgeMs = 0;
+    bool valuesOk = true, seqOk = true;
+    for (size_t i = 0; i < s.packets.size(); ++i) {
+      const Packet& p = s.packets[i];
+      const uint32_t age = p.sentMs - p.t0Us / 1000;
+      if (age > worstAgeMs) worstAgeMs = age;
+      valuesOk &= p.firstMa == 2000 && p.mv == 12700 && p.rate == 100;
+      seqOk &= i == 0 || p.seq == (uint8_t)(s.packets[i - 1].seq + 1);
+    }
+    if (verbose) printf("    %zu packets, %u samples, oldest sample waited %u ms\n", s.packets.size(), n, worstAgeMs);
+    expect(n >= 5980 && n <= 6000, "about 100 samples/s reach the app");
+    expect(contiguous(s.packets, 0, s.packets.size()), "one unbroken 10 ms grid");
+    expect(seqOk && valuesOk, "seq +1 per packet, 2000 mA, 12.7 V, rate 100");
+    expect(worstAgeMs <= LoadStream::FLUSH_MS + 2 * kLoopMs + 10, "oldest sample waits about FLUSH_MS at most");
+    expect(s.logLines == 1, "one log line (stream on)");
+  }
+
+  printf("rate change and stop with a half-filled packet\n");
+  {
+    Sim s(verbose);
+    s.stream.request(100);
+    s.runMs(2000);
+    // Change the rate halfway between flushes, with samples already packed
+    while (s.nowMs - s.attemptMs.back() < LoadStream::FLUSH_MS / 2) s.step();
+    const uint32_t changeMs = s.nowMs;
+    const size_t before = s.packets.size();
+    s.stream.request(50);
+    s.step();
+    expect(s.packets.size() == before + 1 && s.packets.back().rate == 100, "the 100 Hz samples are sent on the change");
+    expect(s.packets.back().endUs() / 1000 + 20 >= changeMs, "... up to the change (one bucket in progress)");
+    s.runMs(2000);
+    const Packet& p50 = s.packets[before + 1];
+    expect(p50.rate == 50 && p50.t0Us >= s.packets[before].endUs(), "then 50 Hz from the change on");
+    while (s.nowMs - s.attemptMs.back() < LoadStream::FLUSH_MS / 2) s.step();
+    const uint32_t stopMs = s.nowMs;
+    const size_t beforeStop = s.packets.size();
+    s.stream.request(0);
+    s.runMs(500);
+    expect(s.packets.size() == beforeStop + 1 && s.packets.back().endUs() / 1000 + 30 >= stopMs,
+           "stop sends the last packet, then nothing");
+    expect(!s.stream.active(), "inactive after stop");
+  }
+
+  printf("MTU 23 (20-byte payloads)\n");
+  {
+    Sim s(verbose);
+    s.payloadMax = 20;
+    s.stream.request(100);
+    s.runMs(5000);
+    bool small = true;
+    for (const Packet& p : s.packets) small &= p.len <= 20 && p.count <= 5;
+    expect(small, "every packet fits: header + 5 samples");
+    expect(samplesIn(s.packets) >= 490 && contiguous(s.packets, 0, s.packets.size()), "no samples lost");
+  }
+
+  printf("loop parked 3 s (ring overrun)\n");
+  {
+    Sim s(verbose);
+    s.stream.request(100);
+    s.runMs(1000);
+    const uint32_t parkUs = s.nowMs * 1000u;
+    for (int i = 0; i < 600; ++i) s.step(false);
+    const uint32_t resumeUs = s.nowMs * 1000u;
+    s.runMs(1000);
+    // The ring keeps the newest half (256 samples = 690 ms) of the stall
+    const uint32_t keptFromUs = resumeUs - (LoadSampler::RING_SIZE / 2) * kSampleUs - 10000;
+    bool spans = false;
+    for (const Packet& p : s.packets) spans |= p.t0Us < keptFromUs && p.endUs() > parkUs + 20000;
+    expect(!spans, "no packet spans the lost samples");
+    size_t gapAt = 0;
+    for (size_t i = 1; i < s.packets.size(); ++i) {
+      if (s.packets[i].t0Us != s.packets[i - 1].endUs()) gapAt = i;
+    }
+    expect(gapAt > 0 && contiguous(s.packets, 0, gapAt) && contiguous(s.packets, gapAt, s.packets.size()),
+           "one restart of the grid, unbroken on both sides");
+  }
+
+  printf("every 3rd notify fails for 10 s, then clean\n");
+  {
+    Sim s(verbose);
+    s.stream.request(100);
+    s.runMs(2000);
+    s.failEvery = 3;
+    s.runMs(10000);
+    const uint8_t backedOffHz = s.stream.rateHz();
+    const uint32_t failed = s.stream.failures();
+    s.failEvery = 0;
+    s.runMs(30000);
+    if (verbose) printf("    backed off to %u Hz after %u failures\n", backedOffHz, failed);
+    expect(failed > 0 && backedOffHz < 100, "backs off: longer flushes, then a lower rate");
+    expect(backedOffHz >= LoadStream::MIN_HZ, "never below MIN_HZ");
+    expect(s.stream.rateHz() == 100, "recovers to 100 Hz once notifies succeed");
+    const uint32_t tailFrom = s.nowMs - 5000;
+    uint32_t tail = 0;
+    for (const Packet& p : s.packets) if (p.sentMs > tailFrom) tail += p.count;
+    expect(tail >= 480, "... at the full sample rate");
+  }
+
+  printf("%s\n", g_failures ? "FAIL" : "all checks passed");
+  return g_failures ? 1 : 0;
+}
@@ -0,0 +1,50 @@
+// Host stand-in for the Arduino core pieces the relay driver uses: a simulated millis()
+// clock, and pinMode()/digitalWrite() that count calls and drive a model of the pads
+// (see host/soc/gpio_reg.h for the register side).
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+
+#define INPUT  0x01
+#define OUTPUT 0x03
+#define LOW    0
+#define HIGH   1
+
+extern uint32_t g_hostMillis;
+inline uint32_t millis() { return g_hostMillis; }
+
+// GPIO model: output-enable and OUT latch per pin; a relay input is sunk
+// (channel ON) while its pin is enabled with the latch LOW
+struct HostGpio {
+  uint64_t enable = 0;
+  uint64_t outHigh = 0;
+  uint32_t pinModes = 0;        // pinMode() calls (GPIO matrix reconfiguration)
+  uint32_t digitalWrites = 0;
+  uint32_t regWrites = 0;       // W1TS/W1TC register writes
+  void (*onChange)() = nullptr; // called after every pad change, to sample glitches
+};
+extern HostGpio g_gpio;
+
+inline void pinMode(int pin, int mode) {
+  g_gpio.pinModes++;
+  if (mode == OUTPUT) g_gpio.enable |= 1ull << pin;
+  else g_gpio.enable &= ~(1ull << pin);
+  if (g_gpio.onChange) g_gpio.onChange();
+}
+
+inline void digitalWrite(int pin, int level) {
+  g_gpio.digitalWrites++;
+  if (level) g_gpio.outHigh |= 1ull << pin;
+  else g_gpio.outHigh &= ~(1ull << pin);
+  if (g_gpio.onChange) g_gpio.onChange();
+}
+
+inline bool hostPinSinks(int pin) {
+  return ((g_gpio.enable >> pin) & 1) && !((g_gpio.outHigh >> pin) & 1);
+}
+
+// FreeRTOS critical sections: single-threaded here
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(m) ((void)(m))
+#define portEXIT_CRITICAL(m) ((void)(m))
@@ -0,0 +1,14 @@
+// Host stand-in for the ESP32-S3 GPIO output-enable set/clear registers the relay driver
+// writes, applied to the pad model in host/Arduino.h.
+#pragma once
+#include "Arduino.h"
+
+enum HostGpioReg { GPIO_ENABLE_W1TS_REG, GPIO_ENABLE_W1TC_REG, GPIO_ENABLE1_W1TS_REG, GPIO_ENABLE1_W1TC_REG };
+
+inline void REG_WRITE(HostGpioReg reg, uint32_t bits) {
+  g_gpio.regWrites++;
+  const uint64_t b = (reg == GPIO_ENABLE1_W1TS_REG || reg == GPIO_ENABLE1_W1TC_REG) ? (uint64_t)bits << 32 : bits;
+  if (reg == GPIO_ENABLE_W1TS_REG || reg == GPIO_ENABLE1_W1TS_REG) g_gpio.enable |= b;
+  else g_gpio.enable &= ~b;
+  if (g_gpio.onChange) g_gpio.onChange();
+}
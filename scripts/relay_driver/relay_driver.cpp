@@ -0,0 +1,214 @@
+// Benchmarks the shadow-state relay driver (src/relays.cpp) against the driver it replaced
+// on a PC, by counting pin and register operations on a model of the GPIO pads. Each
+// scenario runs the loop's per-pass enforcement at 10 ms for 100 s: the old pass turned
+// every output off with relayOff() (pinMode(INPUT)) and then the wanted ones back on,
+// the new one applies the wanted mask with one relaysUpdate(). Also checks that channels
+// which stay on are never released mid-pass and that a LEFT-off/BRAKE-on change is two
+// adjacent register writes.
+//
+// Build (from the repo root):
+//   g++ -std=c++17 -O2 -Wall -Wextra -Iscripts/relay_driver/host -Isrc -o relay_driver
+//       scripts/relay_driver/relay_driver.cpp src/relays.cpp
+//
+//   relay_driver
+#include <cstdio>
+
+#include "relays.hpp"
+
+uint32_t g_hostMillis = 0;
+HostGpio g_gpio;
+
+namespace {
+
+// The driver before the shadow mask (inline helpers in relays.hpp): every call
+// reconfigures the pad, whether or not the channel changes
+namespace legacy {
+bool on[R_COUNT] = {};
+
+void sinkOn(int pin) {
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, LOW);
+}
+void floatOff(int pin) { pinMode(pin, INPUT); }
+void relayOn(int r) { sinkOn(RELAY_PIN[r]); on[r] = true; }
+void relayOff(int r) { floatOff(RELAY_PIN[r]); on[r] = false; }
+void begin() {
+  for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+}
+
+// enforceRotaryMode() before: all outputs off, then the mode's channels on
+void enforce(uint8_t want) {
+  for (int i = 0; i < (int)R_ENABLE; ++i) relayOff(i);
+  for (int i = 0; i < (int)R_ENABLE; ++i) if (want & (1u << i)) relayOn(i);
+}
+}  // namespace legacy
+
+void enforceNew(uint8_t want) { relaysUpdate(RELAY_MASK_OUTPUTS, want & RELAY_MASK_OUTPUTS); }
+
+// Pad watcher: per-channel sink transitions within the current pass, and the
+// number of pad operations between one channel's release and another's sink
+struct Watch {
+  uint8_t  prev = 0;
+  uint32_t flips[R_COUNT] = {};
+  uint32_t ops = 0;
+  int32_t  releasedAt[R_COUNT] = {};
+  int32_t  sunkAt[R_COUNT] = {};
+
+  uint8_t sample() const {
+    uint8_t m = 0;
+    for (int i = 0; i < (int)R_COUNT; ++i) if (hostPinSinks(RELAY_PIN[i])) m |= (uint8_t)(1u << i);
+    return m;
+  }
+  void beginPass() {
+    prev = sample();
+    for (int i = 0; i < (int)R_COUNT; ++i) { flips[i] = 0; releasedAt[i] = sunkAt[i] = -1; }
+  }
+  void change() {
+    ops++;
+    const uint8_t now = sample();
+    for (int i = 0; i < (int)R_COUNT; ++i) {
+      const uint8_t bit = (uint8_t)(1u << i);
+      if ((now ^ prev) & bit) {
+        flips[i]++;
+        if (now & bit) sunkAt[i] = (int32_t)ops;
+        else releasedAt[i] = (int32_t)ops;
+      }
+    }
+    prev = now;
+  }
+};
+
+Watch g_watch;
+
+struct Tally {
+  uint32_t pinModes = 0, digitalWrites = 0, regWrites = 0;
+  uint32_t glitches = 0;    // a channel released and re-sunk (or the reverse) in one pass
+};
+
+// One pass of either driver with the pad watcher armed; counts glitches
+template <class Fn>
+void pass(Fn enforce, uint8_t want, Tally& t) {
+  const uint32_t pm = g_gpio.pinModes, dw = g_gpio.digitalWrites, rw = g_gpio.regWrites;
+  g_watch.beginPass();
+  const uint8_t before = g_watch.prev;
+  enforce(want);
+  const uint8_t after = g_watch.sample();
+  for (int i = 0; i < (int)R_ENABLE; ++i) {
+    const uint8_t bit = (uint8_t)(1u << i);
+    const uint32_t expected = ((before ^ after) & bit) ? 1 : 0;
+    if (g_watch.flips[i] > expected) t.glitches++;
+  }
+  t.pinModes += g_gpio.pinModes - pm;
+  t.digitalWrites += g_gpio.digitalWrites - dw;
+  t.regWrites += g_gpio.regWrites - rw;
+  g_hostMillis += 10;
+}
+
+void reset() {
+  g_gpio = HostGpio{};
+  g_gpio.onChange = [] { g_watch.change(); };
+  g_hostMillis = 1000;
+  legacy::begin();
+  relaysBegin();
+  g_gpio.pinModes = g_gpio.digitalWrites = g_gpio.regWrites = 0;
+}
+
+int g_failures = 0;
+
+void expect(bool ok, const char* what) {
+  printf("  %-62s %s\n", what, ok ? "ok" : "FAIL");
+  if (!ok) g_failures++;
+}
+
+void report(const char* name, const Tally& t) {
+  printf("    %-7s pinMode %6u  digitalWrite %6u  register writes %5u  glitches %5u\n", name, t.pinModes,
+         t.digitalWrites, t.regWrites, t.glitches);
+}
+
+constexpr int kPasses = 10000;    // 100 s of 10 ms loop passes
+
+// Runs the same per-pass wanted masks through both drivers
+template <class WantFn>
+void compare(WantFn want, Tally& oldT, Tally& newT) {
+  reset();
+  for (int p = 0; p < kPasses; ++p) pass(legacy::enforce, want(p), oldT);
+  reset();
+  for (int p = 0; p < kPasses; ++p) pass(enforceNew, want(p), newT);
+}
+
+}  // namespace
+
+int main() {
+  printf("P5 BRAKE held for 100 s\n");
+  {
+    Tally o, n;
+    compare([](int) { return relayBit(R_BRAKE); }, o, n);
+    report("old", o);
+    report("new", n);
+    expect(o.pinModes >= 7u * kPasses, "old: 7 pinMode() per pass");
+    expect(n.pinModes == 0 && n.regWrites == 1, "new: one register write (the first pass), then none");
+  }
+
+  printf("P5 in RV mode (LEFT+RIGHT as brake) held for 100 s\n");
+  {
+    Tally o, n;
+    const uint8_t rv = relayBit(R_LEFT) | relayBit(R_RIGHT);
+    compare([rv](int) { return rv; }, o, n);
+    report("old", o);
+    report("new", n);
+    expect(o.glitches >= 2u * (kPasses - 1), "old: LEFT and RIGHT released and re-sunk every pass");
+    expect(n.glitches == 0, "new: no glitches");
+  }
+
+  printf("LEFT flashing at 90 fpm over TAIL for 100 s\n");
+  {
+    Tally o, n;
+    // 667 ms period, half on; TAIL stays on throughout
+    auto want = [](int p) {
+      const bool lit = ((p * 10) % 667) < 333;
+      return (uint8_t)(relayBit(R_TAIL) | (lit ? relayBit(R_LEFT) : 0));
+    };
+    compare(want, o, n);
+    report("old", o);
+    report("new", n);
+    expect(o.glitches >= kPasses - 1, "old: TAIL released and re-sunk every pass");
+    expect(n.glitches == 0, "new: TAIL untouched, LEFT flips only on its edges");
+    expect(n.regWrites <= 2u * (kPasses * 10 / 667 + 1) + 1, "new: one register write per flash edge");
+  }
+
+  printf("LEFT off / BRAKE on in one pass\n");
+  {
+    Tally o, n;
+    reset();
+    pass(legacy::enforce, relayBit(R_LEFT), o);
+    pass(legacy::enforce, relayBit(R_BRAKE), o);
+    const int32_t oldGap = g_watch.sunkAt[R_BRAKE] - g_watch.releasedAt[R_LEFT];
+    reset();
+    pass(enforceNew, relayBit(R_LEFT), n);
+    const uint32_t before = g_gpio.regWrites;
+    pass(enforceNew, relayBit(R_BRAKE), n);
+    const int32_t newGap = g_watch.sunkAt[R_BRAKE] - g_watch.releasedAt[R_LEFT];
+    printf("    pad operations from LEFT release to BRAKE sink: old %d, new %d\n", oldGap, newGap);
+    expect(g_gpio.regWrites - before == 2, "new: two register writes (release, then sink)");
+    expect(newGap == 1, "new: adjacent, inside one critical section");
+    expect(oldGap > newGap, "old: other pin reconfigurations in between");
+  }
+
+  printf("driver counters\n");
+  {
+    reset();
+    const RelayDriverStats s0 = relaysStats();
+    Tally n;
+    for (int p = 0; p < 1000; ++p) pass(enforceNew, (p / 100) & 1 ? relayBit(R_TAIL) : 0, n);
+    const RelayDriverStats s1 = relaysStats();
+    printf("    %u requests, %u applied, %u register writes\n", s1.requests - s0.requests,
+           s1.applies - s0.applies, s1.regWrites - s0.regWrites);
+    expect(s1.requests - s0.requests == 1000, "relaysStats(): one request per pass");
+    expect(s1.applies - s0.applies == 9 && s1.regWrites - s0.regWrites == n.regWrites,
+           "relaysStats(): applies and register writes match the pads");
+    expect(relayEdgeCount(R_TAIL) == 5, "relayEdgeCount(): one per OFF->ON");
+  }
+
+  printf("%s\n", g_failures ? "FAIL" : "all checks passed");
+  return g_failures ? 1 : 0;
+}
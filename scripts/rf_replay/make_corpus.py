@@ -0,0 +1,159 @@
+# Generates synthetic RF recordings (RfRecord "RFR1" streams, see src/rf/RfRecord.hpp) for
+# rf_replay. Each remote press is a run of repeated pulse trains with per-pulse timing
+# jitter. Shop hiss is added between presses. After every capture that should confirm a
+# frame, the generator writes the frame record the device would have written. So
+# "rf_replay <file> --check" checks OokDecoder against known answers on a PC.
+#
+# Usage (from the repo root, after building rf_replay as described in rf_replay.cpp):
+#   python3 scripts/rf_replay/make_corpus.py /tmp/rfcorpus
+#   rf_replay /tmp/rfcorpus/families.rfr --check
+#   rf_replay /tmp/rfcorpus/generic_only.rfr --save-codes /tmp/rfcorpus/generic_only.bin
+#   rf_replay /tmp/rfcorpus/generic_only.rfr --codes /tmp/rfcorpus/generic_only.bin --check
+#
+# Corpora:
+#   families.rfr   every chip decoder plus the generic table, at several base pulse
+#                  lengths and jitter levels, with hiss between presses
+#   generic_only.rfr  chip-shaped codes only the generic table decodes: 1:3 codes with a
+#                  PT2262-invalid "10" pair below EV1527's 200 us minimum, and an
+#                  HT12E frame below its 150 us minimum. Replayed against the codes it
+#                  learned, the registry must keep the generic table enabled.
+
+import argparse
+import random
+import struct
+from pathlib import Path
+
+MAGIC = b'RFR1'
+MAX_US = 0x7FFF
+REPEATS = 6          # frames per press; the decoder confirms from the second on
+REPEAT_MS = 40
+PRESS_GAP_MS = 1600
+
+
+class Recording:
+    def __init__(self, seed):
+        self.rng = random.Random(seed)
+        self.out = bytearray(MAGIC)
+        self.t = 1000
+        self.frames = 0
+
+    def capture(self, pulses):
+        self.out += b'C' + struct.pack('<IH', self.t, len(pulses))
+        for us, level in pulses:
+            self.out += struct.pack('<H', max(1, min(us, MAX_US)) | (0x8000 if level else 0))
+
+    def frame(self, value, bits, protocol):
+        self.out += b'F' + struct.pack('<IIBB', self.t, value, bits, protocol)
+        self.frames += 1
+
+    def jitter(self, us, pct):
+        return int(us * (1 + self.rng.uniform(-pct, pct) / 100))
+
+    # One frame: data pulse pairs MSB first. Non-inverted trains end with a
+    # HIGH sync lead; inverted ones (HT12E, HT6P20B) start with a HIGH pilot
+    # and send each bit LOW first, as the chips do.
+    def train(self, r):
+        hi = 0 if r.inverted else 1
+        p = []
+        if r.inverted:
+            p.append((self.jitter(r.t, r.jit), 1))
+        for i in range(r.bits - 1, -1, -1):
+            a, b = r.one if (r.value >> i) & 1 else r.zero
+            p.append((self.jitter(r.t * a, r.jit), hi))
+            p.append((self.jitter(r.t * b, r.jit), 1 - hi))
+        if not r.inverted:
+            p.append((self.jitter(r.t, r.jit), 1))
+        return p
+
+    # A press as the device records it: the first capture only primes the
+    # repeat check, each later one confirms a frame
+    def press(self, r, repeats=REPEATS, expect=True):
+        for k in range(repeats):
+            self.capture(self.train(r))
+            if k and expect:
+                self.frame(r.value, r.bits, r.protocol)
+            self.t += REPEAT_MS
+        self.t += PRESS_GAP_MS
+
+    # AGC hiss: level trains of random length and timing
+    def hiss(self, count):
+        for _ in range(count):
+            n = self.rng.randint(8, 60)
+            lv = self.rng.randint(0, 1)
+            self.capture([(self.rng.randint(20, 1600), (lv + i) & 1) for i in range(n)])
+            self.t += self.rng.randint(6, 40)
+        self.t += PRESS_GAP_MS
+
+    def save(self, path):
+        Path(path).write_bytes(bytes(self.out))
+        print(f'{path}: {len(self.out)} bytes, {self.frames} expected frames')
+
+
+class Remote:
+    def __init__(self, name, value, bits, protocol, t, zero, one, inverted=False, jit=8):
+        self.name, self.value, self.bits, self.protocol = name, value, bits, protocol
+        self.t, self.zero, self.one, self.inverted, self.jit = t, zero, one, inverted, jit
+
+
+def pt2262(trits):
+    """12 PT2262 tri-state digits -> the 24-bit code rc-switch reports."""
+    v = 0
+    for d in trits:
+        v = (v << 2) | {'0': 0, '1': 3, 'F': 1}[d]
+    return v
+
+
+R13, R31 = (1, 3), (3, 1)
+R12, R21 = (1, 2), (2, 1)
+
+
+def families(out):
+    rec = Recording(seed=40)
+    remotes = [
+        Remote('EV1527', 0xA1B2C4, 24, 1, 330, R13, R31, jit=8),
+        Remote('EV1527 slow osc', 0x5D3E81, 24, 1, 560, R13, R31, jit=12),
+        Remote('PT2262 fast osc', pt2262('0F10F1100FF0'), 24, 1, 180, R13, R31, jit=8),
+        Remote('PT2262', pt2262('F0011FF0101F'), 24, 1, 420, R13, R31, jit=10),
+        Remote('HT12E', 0xA5C, 12, 11, 290, R12, R21, inverted=True, jit=10),
+        Remote('HT12E slow osc', 0x3F1, 12, 11, 520, R12, R21, inverted=True, jit=6),
+        Remote('HT6P20B', (0x2ABCDE << 6) | (2 << 4) | 5, 28, 6, 460, R12, R21, inverted=True, jit=8),
+        Remote('generic protocol 2', 0x3C5A96, 24, 2, 650, R12, R21, jit=10),
+        Remote('generic protocol 7', 0x0F0F0F, 24, 7, 150, (1, 6), (6, 1), jit=6),
+    ]
+    for _ in range(6):
+        for r in remotes:
+            rec.press(r)
+            rec.hiss(rec.rng.randint(3, 12))
+    rec.save(out / 'families.rfr')
+
+
+def generic_only(out):
+    rec = Recording(seed=44)
+    remotes = [
+        Remote('1:3 fast osc, "10" pair', 0x9A5C36, 24, 1, 160, R13, R31, jit=6),
+        Remote('1:3 just under EV1527, "10" pairs', 0xAAAAAA, 24, 1, 185, R13, R31, jit=4),
+        Remote('HT12E fast osc', 0x6C3, 12, 11, 120, R12, R21, inverted=True, jit=6),
+    ]
+    for _ in range(6):
+        for r in remotes:
+            rec.press(r)
+            rec.hiss(rec.rng.randint(3, 12))
+    rec.save(out / 'generic_only.rfr')
+
+
+CORPORA = {'families': families, 'generic_only': generic_only}
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Generate synthetic RF recordings for rf_replay')
+    ap.add_argument('outdir', type=Path)
+    ap.add_argument('--only', choices=sorted(CORPORA), action='append',
+                    help='generate just this corpus (repeatable)')
+    args = ap.parse_args()
+    args.outdir.mkdir(parents=True, exist_ok=True)
+    for name in args.only or CORPORA:
+        CORPORA[name](args.outdir)
+
+
+if __name__ == '__main__':
+    main()
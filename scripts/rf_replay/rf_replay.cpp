@@ -0,0 +1,308 @@
+// Replays an RF recording (see src/rf/RfRecord.hpp) through the firmware's own decoder,
+// code table and burst voter on a PC, at simulated time, to regression-test decoder
+// and aggregation changes against captures of real remotes and shop noise.
+//
+// Build (from the repo root):
+//   g++ -std=c++17 -O2 -Isrc -o rf_replay scripts/rf_replay/rf_replay.cpp
+//       src/rf/OokDecoder.cpp src/rf/CodeTable.cpp src/rf/BurstVoter.cpp src/rf/NoiseMonitor.cpp
+//
+// Input: a binary recording (starts with "RFR1", e.g. the reassembled BLE
+// "rfrec" slices) or a serial log containing the "[RFREC] offset hex" lines.
+// make_corpus.py (next to this file) writes synthetic recordings whose frame
+// records are the known answers, so "--check" on them is a decoder regression test.
+//
+//   rf_replay capture.log                 each new code is bound to a slot as first seen
+//   rf_replay capture.log --codes rf.bin  use a dumped "rf_codes" NVS blob instead
+//   options: --tol N (decoder tolerance, default 80)  --loop-ms N (RF::service cadence, default 10)
+//            --families MASK (decoder registry, bit = OokFamily; 0x01 = generic table only; default:
+//            the decoders that learned the loaded codes, like RF does, or all when auto-binding)
+//            --fast N (fire on N consecutive exact frames, RF Response menu; default 0 = end of burst)
+//            --adaptive (let NoiseMonitor tune tolerance and gate from TOL_START, as RF does; --tol is ignored)
+//            --save-codes blob (write the code table after the run, e.g. to replay noise against it)
+//            --check (exit 1 when replayed frames differ from the ones recorded on the device)
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rf/BurstVoter.hpp"
+#include "rf/CodeTable.hpp"
+#include "rf/NoiseMonitor.hpp"
+#include "rf/OokDecoder.hpp"
+#include "rf/RF.hpp"
+#include "rf/RfRecord.hpp"
+
+namespace {
+
+struct Capture {
+  uint32_t tMs = 0;
+  std::vector<OokPulse> pulses;
+};
+
+struct RecordedFrame {
+  uint32_t tMs;
+  OokFrame f;
+  uint32_t pressMs = 0;    // first capture of the press this frame belongs to
+};
+
+bool loadStream(const char* path, std::vector<uint8_t>& out) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+  std::string all((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (all.size() >= 4 && memcmp(all.data(), RfRecord::MAGIC, 4) == 0) {
+    out.assign(all.begin(), all.end());
+    return true;
+  }
+  // Serial log: "[RFREC] <offset> <hex>"; anything else on the line is ignored
+  std::istringstream lines(all);
+  std::string line;
+  while (std::getline(lines, line)) {
+    const size_t at = line.find("[RFREC] ");
+    if (at == std::string::npos) continue;
+    std::istringstream ls(line.substr(at + 8));
+    std::string offTok, hex;
+    if (!(ls >> offTok >> hex) || offTok == "begin" || offTok == "end") continue;
+    const size_t off = strtoul(offTok.c_str(), nullptr, 10);
+    if (out.size() < off + hex.size() / 2) out.resize(off + hex.size() / 2);
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+      out[off + i / 2] = (uint8_t)strtoul(hex.substr(i, 2).c_str(), nullptr, 16);
+    }
+  }
+  return out.size() >= 4 && memcmp(out.data(), RfRecord::MAGIC, 4) == 0;
+}
+
+bool parse(const std::vector<uint8_t>& s, std::vector<Capture>& caps, std::vector<RecordedFrame>& frames) {
+  size_t p = sizeof(RfRecord::MAGIC);
+  while (p < s.size()) {
+    if (s.size() - p < RfRecord::CAPTURE_HEADER) return false;
+    const size_t sz = RfRecord::recordSize(&s[p]);
+    if (!sz || p + sz > s.size()) return false;
+    const uint32_t t = RfRecord::get32(&s[p + 1]);
+    if (s[p] == RfRecord::TYPE_CAPTURE) {
+      Capture c;
+      c.tMs = t;
+      const uint16_t n = RfRecord::get16(&s[p + 5]);
+      for (uint16_t k = 0; k < n; ++k) {
+        const uint16_t w = RfRecord::get16(&s[p + RfRecord::CAPTURE_HEADER + 2 * k]);
+        c.pulses.push_back(OokPulse{(uint16_t)(w & RfRecord::MAX_US), (uint8_t)(w >> 15)});
+      }
+      caps.push_back(std::move(c));
+    } else {
+      RecordedFrame r;
+      r.tMs = t;
+      r.f.value = RfRecord::get32(&s[p + 5]);
+      r.f.bits = s[p + 9];
+      r.f.protocol = s[p + 10];
+      frames.push_back(r);
+    }
+    p += sz;
+  }
+  return true;
+}
+
+bool loadCodes(const char* path, RfCodeTable& t) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+  std::vector<uint8_t> blob((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  return t.deserialize(blob.data(), blob.size());
+}
+
+bool saveCodes(const char* path, const RfCodeTable& t) {
+  std::vector<uint8_t> blob(RfCodeTable::MAX_BLOB);
+  const size_t n = t.serialize(blob.data(), blob.size());
+  std::ofstream out(path, std::ios::binary);
+  return n && out.write((const char*)blob.data(), (std::streamsize)n).good();
+}
+
+bool sameFrame(const OokFrame& a, const OokFrame& b) {
+  return a.value == b.value && a.bits == b.bits && a.protocol == b.protocol;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const char* input = nullptr;
+  const char* codesPath = nullptr;
+  const char* saveCodesPath = nullptr;
+  int tol = 80, loopMs = 10;
+  int families = -1, fast = 0;
+  bool check = false, adaptive = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--codes") && i + 1 < argc) codesPath = argv[++i];
+    else if (!strcmp(argv[i], "--tol") && i + 1 < argc) tol = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--loop-ms") && i + 1 < argc) loopMs = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--families") && i + 1 < argc) families = (int)strtoul(argv[++i], nullptr, 0);
+    else if (!strcmp(argv[i], "--fast") && i + 1 < argc) fast = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--save-codes") && i + 1 < argc) saveCodesPath = argv[++i];
+    else if (!strcmp(argv[i], "--adaptive")) adaptive = true;
+    else if (!strcmp(argv[i], "--check")) check = true;
+    else input = argv[i];
+  }
+  if (!input || loopMs <= 0) {
+    fprintf(stderr, "usage: rf_replay <recording> [--codes blob] [--tol N] [--loop-ms N] [--families MASK] [--fast N] [--adaptive] [--save-codes blob] [--check]\n");
+    return 2;
+  }
+
+  std::vector<uint8_t> stream;
+  std::vector<Capture> caps;
+  std::vector<RecordedFrame> recorded;
+  if (!loadStream(input, stream) || !parse(stream, caps, recorded)) {
+    fprintf(stderr, "rf_replay: %s is not a complete RF recording\n", input);
+    return 2;
+  }
+  RfCodeTable codes;
+  codes.clear();
+  const bool autoBind = codesPath == nullptr;
+  if (codesPath && !loadCodes(codesPath, codes)) {
+    fprintf(stderr, "rf_replay: bad code blob %s\n", codesPath);
+    return 2;
+  }
+  if (families < 0) {
+    uint8_t mask = 0;
+    codes.forEach([&](const RfCode& c) { mask |= OokDecoder::familiesFor(c.protocol, c.bits, c.families); });
+    families = mask ? mask : OokDecoder::ALL_FAMILIES;
+  }
+
+  OokDecoder dec;
+  dec.setTolerance((uint8_t)tol);
+  dec.setFamilies((uint8_t)families);
+  BurstVoter voter;
+  voter.reset();
+  voter.setFastConfirm((uint8_t)fast);
+  std::deque<RecordedFrame> queue;          // RmtCapture's frame queue
+  std::vector<RecordedFrame> replayed;
+  std::vector<uint32_t> latencies;
+  double decodeUs = 0;
+  uint32_t triggers = 0, unmatched = 0;
+  uint32_t perFamily[(size_t)OokFamily::Count] = {};
+  uint32_t burstFirstCapMs = 0, pressMs = 0, lastCapMs = 0;
+  bool inBurst = false;
+
+  NoiseMonitor noise;
+  uint32_t retunes = 0;
+  uint8_t gateLevel = 0;
+  auto noiseCounters = [&]() {
+    NoiseMonitor::Counters nc;
+    nc.rejected = dec.stats().gated + dec.stats().undecoded;
+    nc.stray = dec.stats().unconfirmed;
+    nc.unmatched = unmatched;
+    return nc;
+  };
+  noise.reset(caps.empty() ? 0 : caps.front().tMs, noiseCounters());
+  if (adaptive) {
+    tol = noise.tolerance();
+    dec.setTolerance((uint8_t)tol);
+  }
+
+  auto fire = [&](int slot, uint32_t now) {
+    triggers++;
+    latencies.push_back(now - burstFirstCapMs);
+    printf("%8u ms  trigger slot %d  (%u ms after the press's first capture)\n",
+           now, slot, now - burstFirstCapMs);
+  };
+
+  // One RF::service() pass: finalize a due burst, then take at most one frame
+  auto service = [&](uint32_t now) {
+    if (adaptive && noise.update(now, noiseCounters())) {
+      const NoiseMonitor::Quality& q = noise.quality();
+      if (q.tolPct != tol || q.gateLevel != gateLevel) {
+        retunes++;
+        printf("%8u ms  noise %u/s stray %u/min unmatched %u/min -> tol %u%% gate %u, quality %u%%\n",
+               now, q.noisePerSec, q.strayPerMin, q.unmatchedPerMin, q.tolPct, q.gateLevel, q.percent);
+      }
+      tol = q.tolPct;
+      gateLevel = q.gateLevel;
+      const NoiseMonitor::Gate& g = NoiseMonitor::gate(gateLevel);
+      dec.setTolerance((uint8_t)tol);
+      dec.setGate(g.minPulseUs, g.glitchDiv);
+    }
+    int winner;
+    if (voter.poll(now, winner) && winner >= 0) fire(winner, now);
+    if (!voter.active()) inBurst = false;
+    if (queue.empty()) return;
+    const RecordedFrame fr = queue.front();
+    queue.pop_front();
+    if (voter.blocked(now)) return;
+    uint32_t score = 0;
+    const RfCode* hit = codes.find(fr.f.value, fr.f.protocol, fr.f.bits, &score);
+    if (!hit) {
+      unmatched++;
+      return;
+    }
+    if (!inBurst) { inBurst = true; burstFirstCapMs = fr.pressMs; }
+    const bool ev = OokDecoder::structured(fr.f);
+    const int fastSlot = voter.vote(hit->slot, ev, score, now);
+    if (fastSlot >= 0) fire(fastSlot, now);
+  };
+
+  uint32_t now = caps.empty() ? 0 : caps.front().tMs;
+  for (const Capture& c : caps) {
+    while ((int32_t)(c.tMs - now) > 0) { service(now); now += (uint32_t)loopMs; }
+    OokFrame f;
+    const uint32_t rejectedBefore = dec.stats().gated + dec.stats().undecoded;
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool got = dec.decode(c.pulses.data(), c.pulses.size(), f);
+    decodeUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    // A decodable capture after a quiet gap starts a new press; hiss in
+    // between does not count (capture times are end-of-capture)
+    if (dec.stats().gated + dec.stats().undecoded == rejectedBefore) {
+      if (c.tMs - lastCapMs > BurstVoter::GAP_MS || lastCapMs == 0) pressMs = c.tMs;
+      lastCapMs = c.tMs;
+    }
+    if (!got) continue;
+    perFamily[(size_t)f.family]++;
+    replayed.push_back(RecordedFrame{c.tMs, f});
+    if (autoBind && !codes.find(f.value, f.protocol, f.bits)) {
+      RfCode rc;
+      rc.code = f.value; rc.protocol = f.protocol; rc.bits = f.bits;
+      rc.families = OokDecoder::familyBit(f.family);
+      rc.slot = (uint8_t)(codes.size() % RF::SLOT_SEQUENCE);
+      codes.put(rc);
+      printf("%8u ms  new code 0x%08x bits=%u proto=%u (%s) -> slot %u\n", c.tMs, f.value, f.bits, f.protocol,
+             OokDecoder::familyName(f.family), rc.slot);
+    }
+    queue.push_back(RecordedFrame{c.tMs, f, pressMs});
+  }
+  for (uint32_t end = now + 2000; (int32_t)(end - now) > 0; now += (uint32_t)loopMs) service(now);
+
+  if (saveCodesPath && !saveCodes(saveCodesPath, codes)) {
+    fprintf(stderr, "rf_replay: cannot write %s\n", saveCodesPath);
+    return 2;
+  }
+
+  // Replayed vs. recorded-on-device frames
+  size_t mismatches = 0;
+  for (size_t i = 0; i < replayed.size() || i < recorded.size(); ++i) {
+    if (i >= replayed.size() || i >= recorded.size() || !sameFrame(replayed[i].f, recorded[i].f)) mismatches++;
+  }
+
+  const OokDecoder::Stats& st = dec.stats();
+  printf("\ncaptures %u  gated %u  undecoded %u  unconfirmed %u  frames %u  (recorded %zu, differing %zu)\n",
+         st.bursts, st.gated, st.undecoded, st.unconfirmed, st.frames, recorded.size(), mismatches);
+  printf("decode %.2f us/capture on this host  unmatched frames %u  triggers %u\n",
+         st.bursts ? decodeUs / st.bursts : 0.0, unmatched, triggers);
+  if (adaptive) {
+    const NoiseMonitor::Quality& q = noise.quality();
+    printf("adaptive: %u retunes, final tol %u%% gate %u, quality %u%%\n", retunes, q.tolPct, q.gateLevel, q.percent);
+  }
+  printf("frames by decoder:");
+  for (size_t i = 0; i < (size_t)OokFamily::Count; ++i) {
+    if (perFamily[i]) printf("  %s %u", OokDecoder::familyName((OokFamily)i), perFamily[i]);
+  }
+  printf("\n");
+  if (!latencies.empty()) {
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0;
+    for (uint32_t l : latencies) sum += l;
+    auto pct = [&](unsigned p) { return latencies[(latencies.size() - 1) * p / 100]; };
+    printf("press (first capture) -> trigger: min %u  p50 %u  p90 %u  p99 %u  max %u  mean %.0f ms\n",
+           latencies.front(), pct(50), pct(90), pct(99), latencies.back(), sum / latencies.size());
+  }
+  return (check && mismatches) ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+// Multithreaded check of the SeqLock that carries the Protector's ProtectionState
+// (src/power/ProtectionState.hpp): one writer publishes snapshots whose fields are all
+// derived from one counter while reader threads copy them with read() and tryRead().
+// Any torn copy (fields from two publishes), a version that goes backwards, or a
+// version that disagrees with the payload fails the run.
+//
+// Build (from the repo root):
+//   g++ -std=c++17 -O2 -Wall -Wextra -pthread -Isrc -o seqlock_stress scripts/seqlock_stress/seqlock_stress.cpp
+//
+//   seqlock_stress [publishes] [readers]     defaults: 2000000 publishes, 3 readers
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "power/ProtectionState.hpp"
+
+namespace {
+
+ProtectionState stateFor(uint32_t n) {
+  ProtectionState s;
+  s.version = n;
+  s.tickMs = n * 7u;
+  s.lvpCutoffV = (float)(n % 100000u);
+  s.ocpLimitA = (float)(n % 100000u) + 0.5f;
+  s.outvCutoffV = (float)(n % 100000u) + 0.25f;
+  s.ocpTripRelay = (int8_t)(n % 7u) - 1;
+  s.lvpLatched = n & 1u;
+  s.ocpLatched = n & 2u;
+  s.outvLatched = n & 4u;
+  s.lvpBypass = n & 8u;
+  s.outvBypass = n & 16u;
+  s.revLatched = n & 32u;
+  s.revWarn = n & 64u;
+  s.revRelayMask = (uint8_t)(n >> 3);
+  return s;
+}
+
+bool consistent(const ProtectionState& s) {
+  const ProtectionState e = stateFor(s.version);
+  return s.tickMs == e.tickMs && s.lvpCutoffV == e.lvpCutoffV && s.ocpLimitA == e.ocpLimitA &&
+         s.outvCutoffV == e.outvCutoffV && s.ocpTripRelay == e.ocpTripRelay &&
+         s.lvpLatched == e.lvpLatched && s.ocpLatched == e.ocpLatched &&
+         s.outvLatched == e.outvLatched && s.lvpBypass == e.lvpBypass &&
+         s.outvBypass == e.outvBypass && s.revLatched == e.revLatched &&
+         s.revWarn == e.revWarn && s.revRelayMask == e.revRelayMask;
+}
+
+struct ReaderResult {
+  uint64_t reads = 0, tryFails = 0, torn = 0, backwards = 0, mismatched = 0;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t publishes = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 2000000u;
+  const int readers = argc > 2 ? atoi(argv[2]) : 3;
+
+  SeqLock<ProtectionState> lock;
+  std::atomic<bool> done{false};
+  std::vector<ReaderResult> results(readers);
+  std::vector<std::thread> threads;
+
+  for (int r = 0; r < readers; ++r) {
+    threads.emplace_back([&, r] {
+      ReaderResult& res = results[r];
+      uint32_t last = 0;
+      // Odd readers use the bounded ISR path, even ones the retrying task path
+      const bool isr = r & 1;
+      while (!done.load(std::memory_order_acquire)) {
+        ProtectionState s;
+        uint32_t v = 0;
+        if (isr) {
+          if (!lock.tryRead(s, &v)) { res.tryFails++; std::this_thread::yield(); continue; }
+        } else {
+          s = lock.read(&v);
+        }
+        res.reads++;
+        if (v == 0) continue;                      // nothing published yet
+        if (!consistent(s)) res.torn++;
+        if (s.version != v) res.mismatched++;
+        if (v < last) res.backwards++;
+        last = v;
+        if ((res.reads & 63u) == 0) std::this_thread::yield();   // share a single core
+      }
+    });
+  }
+
+  for (uint32_t n = 1; n <= publishes; ++n) {
+    lock.publish(stateFor(n));
+    if ((n & 255u) == 0) std::this_thread::yield();
+  }
+  done.store(true, std::memory_order_release);
+  for (auto& t : threads) t.join();
+
+  ReaderResult total;
+  for (const auto& r : results) {
+    total.reads += r.reads;
+    total.tryFails += r.tryFails;
+    total.torn += r.torn;
+    total.backwards += r.backwards;
+    total.mismatched += r.mismatched;
+  }
+  const ProtectionState last = lock.read();
+  const bool ok = total.torn == 0 && total.backwards == 0 && total.mismatched == 0 &&
+                  last.version == publishes && consistent(last);
+  printf("publishes %u  readers %d  reads %llu  tryRead give-ups %llu\n", publishes, readers,
+         (unsigned long long)total.reads, (unsigned long long)total.tryFails);
+  printf("torn %llu  version mismatch %llu  backwards %llu  final version %u  -> %s\n",
+         (unsigned long long)total.torn, (unsigned long long)total.mismatched,
+         (unsigned long long)total.backwards, last.version, ok ? "OK" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,16 @@
+// Host stand-in for the Arduino core pieces WiringDiag uses: a simulated millis()
+// clock the check advances, and Serial logging to stdout.
+#pragma once
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+extern uint32_t g_hostMillis;
+inline uint32_t millis() { return g_hostMillis; }
+
+struct HostSerial {
+  bool quiet = false;
+  void println(const char* s) { if (!quiet) puts(s); }
+  template <typename... A> void printf(const char* f, A... a) { if (!quiet) ::printf(f, a...); }
+};
+extern HostSerial Serial;
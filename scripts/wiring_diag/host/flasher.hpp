@@ -0,0 +1,5 @@
+// Host stand-in for src/flasher.hpp: nothing flashes in the simulation.
+#pragma once
+namespace Flasher {
+  inline void stop() {}
+}
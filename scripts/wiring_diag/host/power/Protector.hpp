@@ -0,0 +1,15 @@
+// Host stand-in for src/power/Protector.hpp: only the published snapshot, which
+// the check latches and clears the way the OCP path and the OFF detent do.
+#pragma once
+#include "power/ProtectionState.hpp"
+
+class Protector {
+public:
+  ProtectionState state() const { return _state; }
+  void setOcpLatched(bool on) { _state.ocpLatched = on; _state.version++; }
+
+private:
+  ProtectionState _state;
+};
+
+extern Protector protector;
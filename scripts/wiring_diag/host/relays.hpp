@@ -0,0 +1,21 @@
+// Host stand-in for src/relays.hpp: the relay indices and a shadow mask the
+// simulated trailer reads instead of GPIO.
+#pragma once
+#include <Arduino.h>
+
+enum RelayIndex : uint8_t { R_LEFT = 0, R_RIGHT, R_BRAKE, R_TAIL, R_MARKER, R_AUX, R_ENABLE, R_COUNT };
+
+extern uint8_t g_relay_mask;
+
+inline constexpr uint8_t relayBit(RelayIndex r) { return (uint8_t)(1u << (uint8_t)r); }
+static constexpr uint8_t RELAY_MASK_ALL     = (uint8_t)((1u << R_COUNT) - 1u);
+static constexpr uint8_t RELAY_MASK_OUTPUTS = (uint8_t)(RELAY_MASK_ALL & ~relayBit(R_ENABLE));
+
+inline void relaysUpdate(uint8_t clearMask, uint8_t setMask) {
+  g_relay_mask = (uint8_t)((g_relay_mask & ~clearMask) | setMask);
+}
+
+inline const char* relayName(RelayIndex r) {
+  static const char* const kNames[] = {"LEFT", "RIGHT", "BRAKE", "TAIL", "MARKER", "AUX", "12V"};
+  return r < R_COUNT ? kNames[r] : "R?";
+}
@@ -0,0 +1,52 @@
+// File Overview: Declares the lock-free single-producer/single-consumer queue that carries
+// validated relay and flash commands from the NimBLE host task to the loop, which applies
+// them at one fixed point per pass.
+#pragma once
+#include <stdint.h>
+
+struct BleCommand {
+  enum Kind : uint8_t { Relay, Flash };
+  Kind     kind = Relay;
+  uint8_t  a = 0;            // Relay: RelayIndex   Flash: mask (0 = stop)
+  uint8_t  b = 0;            // Relay: 1 = on       Flash: fpm (0 = keep)
+  uint8_t  c = 0;            //                     Flash: duty % (0 = keep)
+  uint32_t enqueuedUs = 0;   // micros() at push, for the enqueue-to-apply latency
+};
+
+// Producer: ControlCallbacks::onWrite (NimBLE host task). Consumer: the loop.
+// Each index is written by one side only, published with release/acquire like
+// the LoadSampler ring, so neither side ever blocks the other.
+class BleCommandQueue {
+public:
+  static constexpr uint32_t CAPACITY = 16;   // power of two; an app sends a few per second
+
+  // Producer only. False (and counted) when the loop has fallen CAPACITY behind.
+  bool push(const BleCommand& c) {
+    const uint32_t head = _head;
+    if (head - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE) >= CAPACITY) {
+      __atomic_add_fetch(&_dropped, 1, __ATOMIC_RELAXED);
+      return false;
+    }
+    _slots[head & (CAPACITY - 1)] = c;
+    __atomic_store_n(&_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  // Consumer only
+  bool pop(BleCommand& c) {
+    const uint32_t tail = _tail;
+    if (tail == __atomic_load_n(&_head, __ATOMIC_ACQUIRE)) return false;
+    c = _slots[tail & (CAPACITY - 1)];
+    __atomic_store_n(&_tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  uint32_t dropped() const { return __atomic_load_n(&_dropped, __ATOMIC_RELAXED); }
+
+private:
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+  BleCommand _slots[CAPACITY];
+  uint32_t _head = 0;      // next slot to write (producer)
+  uint32_t _tail = 0;      // next slot to read (consumer)
+  uint32_t _dropped = 0;
+};
@@ -0,0 +1,121 @@
+// File Overview: Defines the fixed-layout binary status packet sent on the binary status
+// characteristic next to the JSON one, with its encoder/decoder and an airtime estimate;
+// shared by the firmware and host tools.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Plain C++ (no Arduino/NimBLE) so apps' test tools and scripts/ble_status
+// decode exactly what the firmware encodes. Little-endian, VERSION 1:
+//   0  u8   version          12 u16  source mV (0xFFFF = no reading)
+//   1  u8   seq (per notify) 14 u16  output mV (0xFFFF = no reading)
+//   2  u16  statusFlags      16 u8   relayMask (bit = RelayIndex, LEFT..AUX)
+//   4  u16  faultMask        17 u8   bleed pair as relayMask bits (0 = none)
+//   6  u16  cooldown s       18 u8   battery SOH % (0xFF = unknown)
+//   8  i32  load mA          19 u8   channel profile id
+//           (INT32_MIN =     20 u8   rotary position (0 = P1)
+//            no reading)     21..23  reserved, 0
+// Decoders accept longer packets: later versions only append fields.
+namespace BleStatusPacket {
+  static constexpr uint8_t VERSION = 1;
+  static constexpr size_t  SIZE = 24;
+  static constexpr int32_t  LOAD_NONE = INT32_MIN;
+  static constexpr uint16_t MV_NONE = 0xFFFF;
+  static constexpr uint8_t  SOH_UNKNOWN = 0xFF;
+
+  // statusFlags bits, same meaning as the JSON "statusFlags"
+  enum Flag : uint16_t {
+    kFlagTwelveVoltEnabled = 1 << 0,
+    kFlagLvpLatched        = 1 << 1,
+    kFlagLvpBypass         = 1 << 2,
+    kFlagOutvLatched       = 1 << 3,
+    kFlagOutvBypass        = 1 << 4,
+    kFlagCooldownActive    = 1 << 5,
+    kFlagStartupGuard      = 1 << 6,
+    kFlagLvpWarn           = 1 << 7,
+    kFlagReverseWarn       = 1 << 8,
+    kFlagReverseLatched    = 1 << 9,
+    kFlagSequenceRunning   = 1 << 10,
+    kFlagDiagRunning       = 1 << 11,
+    kFlagChannelBleed      = 1 << 12,
+    kFlagWiggleActive      = 1 << 13,
+  };
+
+  struct Status {
+    uint8_t  seq = 0;
+    uint16_t flags = 0;
+    uint16_t faultMask = 0;
+    uint16_t cooldownSecs = 0;
+    int32_t  loadMilliAmps = LOAD_NONE;
+    uint16_t srcMilliVolts = MV_NONE;
+    uint16_t outMilliVolts = MV_NONE;
+    uint8_t  relayMask = 0;
+    uint8_t  bleedMask = 0;
+    uint8_t  sohPct = SOH_UNKNOWN;
+    uint8_t  profileId = 0;
+    uint8_t  rotaryPos = 0;
+  };
+
+  inline void put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+  inline void put32(uint8_t* p, uint32_t v) { put16(p, (uint16_t)v); put16(p + 2, (uint16_t)(v >> 16)); }
+  inline uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+  inline uint32_t get32(const uint8_t* p) { return (uint32_t)get16(p) | ((uint32_t)get16(p + 2) << 16); }
+
+  inline void encode(const Status& s, uint8_t out[SIZE]) {
+    out[0] = VERSION;
+    out[1] = s.seq;
+    put16(out + 2, s.flags);
+    put16(out + 4, s.faultMask);
+    put16(out + 6, s.cooldownSecs);
+    put32(out + 8, (uint32_t)s.loadMilliAmps);
+    put16(out + 12, s.srcMilliVolts);
+    put16(out + 14, s.outMilliVolts);
+    out[16] = s.relayMask;
+    out[17] = s.bleedMask;
+    out[18] = s.sohPct;
+    out[19] = s.profileId;
+    out[20] = s.rotaryPos;
+    out[21] = out[22] = out[23] = 0;
+  }
+
+  // False for a short packet or an unknown major layout (version 0)
+  inline bool decode(const uint8_t* in, size_t len, Status& s) {
+    if (!in || len < SIZE || in[0] == 0) return false;
+    s.seq = in[1];
+    s.flags = get16(in + 2);
+    s.faultMask = get16(in + 4);
+    s.cooldownSecs = get16(in + 6);
+    s.loadMilliAmps = (int32_t)get32(in + 8);
+    s.srcMilliVolts = get16(in + 12);
+    s.outMilliVolts = get16(in + 14);
+    s.relayMask = in[16];
+    s.bleedMask = in[17];
+    s.sohPct = in[18];
+    s.profileId = in[19];
+    s.rotaryPos = in[20];
+    return true;
+  }
+
+  // Volts/amps to the packet's integer units; NaN (no reading) -> sentinel
+  inline uint16_t toMilliVolts(float v) {
+    if (!(v == v)) return MV_NONE;
+    if (v <= 0.0f) return 0;
+    return v >= 65.534f ? (uint16_t)65534 : (uint16_t)(v * 1000.0f + 0.5f);
+  }
+  inline int32_t toMilliAmps(float a) {
+    if (!(a == a)) return LOAD_NONE;
+    if (a >= 2000000.0f) return 2000000000;
+    if (a <= -2000000.0f) return -2000000000;
+    return (int32_t)(a * 1000.0f + (a < 0.0f ? -0.5f : 0.5f));
+  }
+
+  // LE 1M PHY radio time for one notification carrying 'valueLen' bytes: ATT
+  // (3) + L2CAP (4) headers split into link-layer PDUs of at most 'llPayload'
+  // bytes (27 without data length extension), each costing 10 framing bytes
+  // plus an empty ack PDU and two 150us inter-frame spaces.
+  inline uint32_t airtimeUs(size_t valueLen, size_t llPayload = 27) {
+    const size_t bytes = valueLen + 7;
+    const size_t pdus = (bytes + llPayload - 1) / llPayload;
+    return (uint32_t)(bytes * 8 + pdus * (80 + 80 + 300));
+  }
+}
@@ -0,0 +1,139 @@
+// File Overview: Implements the live load stream: bucket averaging of the load sampler ring,
+// MTU-sized packing, and the back-off/recovery of rate and flush interval.
+#include "ble/LoadStream.hpp"
+#include <stdarg.h>
+#include <stdio.h>
+
+namespace {
+  inline void put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+
+  inline int16_t toMilliAmps(float a) {
+    const float ma = a * 1000.0f;
+    if (ma >= 32767.0f) return 32767;
+    if (ma <= -32767.0f) return -32767;
+    return (int16_t)(ma + (ma < 0.0f ? -0.5f : 0.5f));
+  }
+}
+
+void LoadStream::log(const char* fmt, ...) {
+  if (!_log) return;
+  char line[96];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(line, sizeof(line), fmt, ap);
+  va_end(ap);
+  _log(line);
+}
+
+void LoadStream::start(uint8_t hz, uint32_t nowMs, const Sender& send) {
+  // Samples already packed were taken at the old rate: send them first
+  flush(nowMs, send);
+  _requestedHz = hz;
+  _flushMs = FLUSH_MS;
+  _lastStepMs = nowMs;
+  _reader = LoadSampler::Reader{};    // start from the newest sample
+  _lost = 0;
+  if (hz) setRate(hz);
+  log("[BLE] Load stream %s (%u Hz)", hz ? "on" : "off", (unsigned)hz);
+}
+
+// Callers flush first: a packet carries one rate and one unbroken grid
+void LoadStream::setRate(uint8_t hz) {
+  _rateHz = hz;
+  _periodUs = 1000000u / hz;
+  _gridStarted = false;
+}
+
+void LoadStream::service(uint32_t nowMs, uint16_t outMilliVolts, size_t payloadMax, const Sender& send) {
+  const int16_t pending = _pendingHz;
+  if (pending >= 0) {
+    _pendingHz = -1;
+    start((uint8_t)pending, nowMs, send);
+  }
+  if (!_requestedHz) return;
+
+  _outMv = outMilliVolts;
+  const size_t room = (payloadMax < MAX_PAYLOAD ? payloadMax : MAX_PAYLOAD);
+  _capacity = (uint8_t)(room > HEADER + 2 ? (room - HEADER) / 2 : 1);
+  if (_count >= _capacity) flush(nowMs, send);   // MTU shrank
+
+  LoadSampler::Sample buf[32];
+  size_t got;
+  while ((got = LoadSampler::take(_reader, buf, 32)) > 0) {
+    if (_reader.lost != _lost) {
+      // The loop fell behind the ring: close the packet before the gap
+      _lost = _reader.lost;
+      flush(nowMs, send);
+      _gridStarted = false;
+    }
+    for (size_t i = 0; i < got; ++i) addSample(nowMs, buf[i], send);
+  }
+  if (_count && nowMs - _packetStartMs >= _flushMs) flush(nowMs, send);
+
+  // Failure-free for a while: undo one back-off step
+  if ((_rateHz < _requestedHz || _flushMs > FLUSH_MS) && nowMs - _lastStepMs >= RECOVER_MS) {
+    flush(nowMs, send);
+    _lastStepMs = nowMs;
+    _flushMs = _flushMs / 2 > FLUSH_MS ? _flushMs / 2 : FLUSH_MS;
+    if (_rateHz < _requestedHz) setRate(_rateHz * 2 < _requestedHz ? _rateHz * 2 : _requestedHz);
+    log("[BLE] Load stream recovering: %u Hz, flush %lu ms", (unsigned)_rateHz, (unsigned long)_flushMs);
+  }
+}
+
+// Each output sample is the mean of the ring samples in one period
+void LoadStream::addSample(uint32_t nowMs, const LoadSampler::Sample& s, const Sender& send) {
+  if (!_gridStarted) {
+    _gridStarted = true;
+    _bucketUs = s.tUs;
+    _sum = 0.0f;
+    _n = 0;
+  }
+  if (s.tUs - _bucketUs >= _periodUs) {
+    if (_n) emit(nowMs, _bucketUs, _sum / _n, send);
+    _bucketUs += _periodUs;
+    _sum = 0.0f;
+    _n = 0;
+    if (s.tUs - _bucketUs >= _periodUs) {
+      // A whole period without a conversion (sensor stalled): restart the grid here
+      flush(nowMs, send);
+      _bucketUs = s.tUs;
+    }
+  }
+  _sum += s.amps;
+  _n++;
+}
+
+void LoadStream::emit(uint32_t nowMs, uint32_t tUs, float amps, const Sender& send) {
+  if (_count == 0) {
+    _packetStartMs = nowMs;
+    put16(_packet + 4, (uint16_t)tUs);
+    put16(_packet + 6, (uint16_t)(tUs >> 16));
+  }
+  put16(_packet + HEADER + 2 * _count, (uint16_t)toMilliAmps(amps));
+  if (++_count >= _capacity) flush(nowMs, send);
+}
+
+void LoadStream::flush(uint32_t nowMs, const Sender& send) {
+  if (!_count) return;
+  _packet[0] = VERSION;
+  _packet[1] = _seq++;
+  _packet[2] = _rateHz;
+  _packet[3] = _count;
+  put16(_packet + 8, _outMv);
+  const bool ok = send(_packet, HEADER + 2 * (size_t)_count);
+  _count = 0;
+  _packets++;
+  if (ok) return;
+
+  // Notify failed (host out of buffers, link congested): fewer, fuller packets
+  // first, then a lower rate. Each failure is one step; recovery is one step
+  // per RECOVER_MS without failures.
+  _failures++;
+  _lastStepMs = nowMs;
+  if (_flushMs < FLUSH_MAX_MS) {
+    _flushMs *= 2;
+  } else if (_rateHz > MIN_HZ) {
+    setRate(_rateHz / 2 > MIN_HZ ? _rateHz / 2 : MIN_HZ);
+  }
+  log("[BLE] Load stream backing off: %u Hz, flush %lu ms", (unsigned)_rateHz, (unsigned long)_flushMs);
+}
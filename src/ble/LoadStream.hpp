@@ -0,0 +1,81 @@
+// File Overview: Declares the opt-in live load stream: the full-rate load-current ring is
+// averaged down to 20-100 Hz and packed into MTU-sized notifications for the app's live
+// graph, backing off when notifications start failing.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include "sensors/LoadSampler.hpp"
+
+// Packet (little-endian), one per notify on the stream characteristic:
+//   0  u8   version (1)         4  u32  time of sample 0 (esp_timer us, low 32 bits)
+//   1  u8   seq (+1 per packet) 8  u16  output mV at send (loop reading; 0xFFFF = none)
+//   2  u8   rate Hz             10 i16  load mA, sample i at time0 + i * 1e6/rate us
+//   3  u8   sample count               (count of them)
+// A packet never spans a gap (lost ring samples, rate change): the grid restarts
+// with the next packet. Voltage comes from the loop's own reading, so the stream
+// adds no I2C traffic.
+class LoadStream {
+public:
+  static constexpr uint8_t  VERSION      = 1;
+  static constexpr uint8_t  MIN_HZ       = 20;
+  static constexpr uint8_t  MAX_HZ       = 100;
+  static constexpr size_t   HEADER       = 10;
+  static constexpr size_t   MAX_PAYLOAD  = 244;     // MTU 247 (data length extension)
+  static constexpr uint32_t FLUSH_MS     = 100;     // oldest sample's max wait: graph latency
+  static constexpr uint32_t FLUSH_MAX_MS = 800;     // backed-off: fewer, fuller packets
+  static constexpr uint32_t RECOVER_MS   = 5000;    // failure-free time before stepping back up
+
+  using Sender = std::function<bool(const uint8_t*, size_t)>;   // false = notify failed
+  using Logger = std::function<void(const char*)>;               // one line, no newline
+
+  // On/off and back-off/recovery lines go here (none until set), so the class
+  // has no Arduino dependency and scripts/load_stream can run it on a PC
+  void setLogger(Logger log) { _log = log; }
+
+  // Any task; 0 = off, else clamped to MIN_HZ..MAX_HZ. Applied by service().
+  void request(int hz) { _pendingHz = (int16_t)(hz <= 0 ? 0 : hz < MIN_HZ ? MIN_HZ : hz > MAX_HZ ? MAX_HZ : hz); }
+  bool active() const { return _requestedHz != 0; }
+  uint8_t rateHz() const { return _rateHz; }          // after back-off
+  uint32_t packets() const { return _packets; }
+  uint32_t failures() const { return _failures; }
+
+  // Loop task: drain the ring, emit finished packets. 'payloadMax' = negotiated MTU - 3.
+  void service(uint32_t nowMs, uint16_t outMilliVolts, size_t payloadMax, const Sender& send);
+
+private:
+  void start(uint8_t hz, uint32_t nowMs, const Sender& send);
+  void setRate(uint8_t hz);
+  void addSample(uint32_t nowMs, const LoadSampler::Sample& s, const Sender& send);
+  void emit(uint32_t nowMs, uint32_t tUs, float amps, const Sender& send);
+  void flush(uint32_t nowMs, const Sender& send);
+  void log(const char* fmt, ...);
+
+  Logger _log;
+
+  LoadSampler::Reader _reader;
+  volatile int16_t _pendingHz = -1;
+  uint8_t  _requestedHz = 0;
+  uint8_t  _rateHz = 0;
+  uint32_t _flushMs = FLUSH_MS;
+  uint32_t _periodUs = 0;
+  uint32_t _lastStepMs = 0;
+  uint32_t _lost = 0;
+
+  // Current bucket (one output sample)
+  bool     _gridStarted = false;
+  uint32_t _bucketUs = 0;
+  float    _sum = 0.0f;
+  uint16_t _n = 0;
+
+  // Packet being filled
+  uint8_t  _packet[MAX_PAYLOAD];
+  uint8_t  _count = 0;
+  uint8_t  _capacity = 0;
+  uint8_t  _seq = 0;
+  uint16_t _outMv = 0xFFFF;
+  uint32_t _packetStartMs = 0;
+
+  uint32_t _packets = 0;
+  uint32_t _failures = 0;
+};
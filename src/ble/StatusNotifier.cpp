@@ -0,0 +1,64 @@
+// File Overview: Implements the status notify scheduler's change detection, coalescing,
+// rate limit and heartbeat.
+#include "ble/StatusNotifier.hpp"
+
+namespace {
+  inline bool apart(int64_t a, int64_t b, uint32_t band) {
+    return (a > b ? a - b : b - a) > (int64_t)band;
+  }
+
+  // A reading that appears or disappears always counts
+  inline bool analogDiffers(int64_t a, int64_t b, int64_t none, uint32_t band) {
+    if ((a == none) != (b == none)) return true;
+    return a != none && apart(a, b, band);
+  }
+}
+
+bool StatusNotifier::differs(const BleStatusPacket::Status& a, const BleStatusPacket::Status& b) {
+  using namespace BleStatusPacket;
+  if (a.flags != b.flags || a.faultMask != b.faultMask || a.cooldownSecs != b.cooldownSecs ||
+      a.relayMask != b.relayMask || a.bleedMask != b.bleedMask || a.sohPct != b.sohPct ||
+      a.profileId != b.profileId || a.rotaryPos != b.rotaryPos) {
+    return true;
+  }
+  return analogDiffers(a.loadMilliAmps, b.loadMilliAmps, LOAD_NONE, LOAD_DEADBAND_MA) ||
+         analogDiffers(a.srcMilliVolts, b.srcMilliVolts, MV_NONE, VOLT_DEADBAND_MV) ||
+         analogDiffers(a.outMilliVolts, b.outMilliVolts, MV_NONE, VOLT_DEADBAND_MV);
+}
+
+StatusNotifier::Reason StatusNotifier::decide(uint32_t nowMs, const BleStatusPacket::Status& s) {
+  Reason r = None;
+  if (_force || !_primed) {
+    r = Forced;
+  } else {
+    if (!_pending && differs(s, _sent)) {
+      _pending = true;
+      _changedAt = nowMs;
+    }
+    // A change is sent once it has settled for COALESCE_MS (later changes in
+    // the window ride along), and no sooner than MIN_INTERVAL_MS after the last
+    if (_pending) {
+      if (nowMs - _changedAt >= COALESCE_MS && nowMs - _lastSendMs >= MIN_INTERVAL_MS) r = Change;
+    } else if (nowMs - _lastSendMs >= HEARTBEAT_MS) {
+      r = Heartbeat;
+    }
+  }
+  if (r == None) return None;
+
+  if (r == Change) {
+    const uint32_t latency = nowMs - _changedAt;
+    _stats.change++;
+    _stats.latencySumMs += latency;
+    if (latency > _stats.latencyMaxMs) _stats.latencyMaxMs = latency;
+  } else if (r == Heartbeat) {
+    _stats.heartbeat++;
+  } else {
+    _stats.forced++;
+  }
+  _force = false;
+  _primed = true;
+  _pending = false;
+  _sent = s;
+  _lastSendMs = nowMs;
+  return r;
+}
@@ -0,0 +1,50 @@
+// File Overview: Declares the status notify scheduler: a status notify goes out when the
+// state changes (after a short coalescing window, no more often than a minimum interval)
+// or as a slow heartbeat when nothing changes, instead of on a fixed 1 s timer.
+#pragma once
+#include <stdint.h>
+
+#include "ble/BleStatusPacket.hpp"
+
+// Plain C++ (time is passed in) like BurstVoter, so scripts/ble_status can
+// simulate sessions against the old fixed-rate timer.
+class StatusNotifier {
+public:
+  static constexpr uint32_t COALESCE_MS     = 30;    // let one knob detent / command settle
+  static constexpr uint32_t MIN_INTERVAL_MS = 100;   // at most 10 notifies/s while things move
+  static constexpr uint32_t HEARTBEAT_MS    = 2000;  // app drops the link after 5 s of silence
+  // Analog changes smaller than these wait for the heartbeat
+  static constexpr uint32_t LOAD_DEADBAND_MA = 100;
+  static constexpr uint32_t VOLT_DEADBAND_MV = 50;
+
+  enum Reason : uint8_t { None = 0, Change, Heartbeat, Forced };
+
+  struct Stats {
+    uint32_t change = 0, heartbeat = 0, forced = 0;
+    uint32_t latencySumMs = 0;    // change seen -> notify, over 'change' sends
+    uint32_t latencyMaxMs = 0;
+  };
+
+  // Next decide() sends at once: new connection, refresh, command handled.
+  // Safe to call from the NimBLE task.
+  void force() { _force = true; }
+  bool forced() const { return _force; }
+
+  // Call with the current state on every status pass; a non-None result means
+  // notify now (the state is then the new reference). 'seq' is ignored.
+  Reason decide(uint32_t nowMs, const BleStatusPacket::Status& s);
+
+  const Stats& stats() const { return _stats; }
+  void clearStats() { _stats = Stats(); }
+
+  static bool differs(const BleStatusPacket::Status& a, const BleStatusPacket::Status& b);
+
+private:
+  BleStatusPacket::Status _sent;
+  bool _primed = false;
+  volatile bool _force = false;
+  bool _pending = false;
+  uint32_t _changedAt = 0;
+  uint32_t _lastSendMs = 0;
+  Stats _stats;
+};
@@ -5,30 +5,35 @@
 #include <NimBLEDevice.h>
 #include <esp_gap_ble_api.h>
 #include <esp_log.h>
+#include <mbedtls/base64.h>
 
 #include <cmath>
 #include <cstring>
 
+#include "ble/BleStatusPacket.hpp"
+#include "relay_wear.hpp"
+#include "sensors/LoadSpectrum.hpp"
+
 namespace {
 constexpr char kServiceUuid[] = "0000a11c-0000-1000-8000-00805f9b34fb";
 constexpr char kStatusCharUuid[] = "0000a11d-0000-1000-8000-00805f9b34fb";
 constexpr char kControlCharUuid[] = "0000a11e-0000-1000-8000-00805f9b34fb";
-constexpr uint32_t kStatusIntervalMs = 1000;
+constexpr char kResultCharUuid[] = "0000a11f-0000-1000-8000-00805f9b34fb";
+constexpr char kStatusBinCharUuid[] = "0000a120-0000-1000-8000-00805f9b34fb";
+constexpr char kStreamCharUuid[] = "0000a121-0000-1000-8000-00805f9b34fb";
+constexpr uint32_t kStatusReportMs = 60000;          // notify-rate / encode-cost log period
 constexpr size_t kStatusJsonCap = 512;               // ArduinoJson document capacity
 constexpr size_t kStatusPayloadLimit = 200;          // Max JSON bytes for notifications
-constexpr size_t kControlDecodeCap = 256;
+constexpr size_t kControlDecodeCap = 2048;            // heap; a sequence upload carries up to 16 steps
+constexpr size_t kResultJsonCap = 1024;
+// rfrec JSON around the base64 data, offsets and totals up to 5 digits:
+// {"type":"rfrec","off":16388,"total":16388,"d":""}
+constexpr size_t kRfRecJsonOverhead = 49;
+// A command the loop reaches this late (parked in a modal) is dropped: a
+// relay switching seconds after the tap is worse than the app's resend
+constexpr uint32_t kCmdStaleUs = 500000;
 const char* kBleLogTag = "TLTB-BLE";
 
-enum StatusFlag : uint16_t {
-  kFlagTwelveVoltEnabled = 1 << 0,
-  kFlagLvpLatched        = 1 << 1,
-  kFlagLvpBypass         = 1 << 2,
-  kFlagOutvLatched       = 1 << 3,
-  kFlagOutvBypass        = 1 << 4,
-  kFlagCooldownActive    = 1 << 5,
-  kFlagStartupGuard      = 1 << 6,
-};
-
 const char* relayIdForIndex(RelayIndex idx) {
   switch (idx) {
     case R_LEFT:   return "relay-left";
@@ -52,6 +57,47 @@ bool relayIndexFromId(const char* id, RelayIndex& out) {
   return false;
 }
 
+uint16_t statusFlagsFor(const BleStatusContext& ctx) {
+  using namespace BleStatusPacket;
+  const Telemetry& t = ctx.telemetry;
+  uint16_t f = 0;
+  if (ctx.enableRelay)    f |= kFlagTwelveVoltEnabled;
+  if (t.lvpLatched)       f |= kFlagLvpLatched;
+  if (ctx.lvpBypass)      f |= kFlagLvpBypass;
+  if (t.outvLatched)      f |= kFlagOutvLatched;
+  if (ctx.outvBypass)     f |= kFlagOutvBypass;
+  if (t.cooldownActive)   f |= kFlagCooldownActive;
+  if (ctx.startupGuard)   f |= kFlagStartupGuard;
+  if (t.lvpWarn)          f |= kFlagLvpWarn;
+  if (t.revWarn)          f |= kFlagReverseWarn;
+  if (t.revLatched)       f |= kFlagReverseLatched;
+  if (t.seqRunning)       f |= kFlagSequenceRunning;
+  if (t.diagRunning)      f |= kFlagDiagRunning;
+  if (t.bleedOn >= 0 && t.bleedInto >= 0) f |= kFlagChannelBleed;
+  if (t.wiggleActive)     f |= kFlagWiggleActive;
+  return f;
+}
+
+uint8_t relayMaskFor(const BleStatusContext& ctx) {
+  uint8_t mask = 0;
+  for (int i = 0; i < (int)R_ENABLE; ++i) {
+    if (ctx.relayStates[i]) {
+      mask |= (uint8_t)(1u << i);
+    }
+  }
+  return mask;
+}
+
+uint8_t bleedMaskFor(const Telemetry& t) {
+  if (t.bleedOn < 0 || t.bleedInto < 0) return 0;
+  return (uint8_t)((1u << t.bleedOn) | (1u << t.bleedInto));
+}
+
+// Same value as the TFT Load readout: block RMS (signed like the snapshot) when recent
+float shownLoadAmps(const Telemetry& t) {
+  return std::isnan(t.loadRmsA) || std::isnan(t.loadA) ? t.loadA : std::copysign(t.loadRmsA, t.loadA);
+}
+
 void setNullableFloat(JsonObject obj, const char* key, float value) {
   if (isnan(value)) {
     obj[key] = nullptr;
@@ -99,6 +145,24 @@ private:
   TltbBleService& _service;
 };
 
+// Notify outcome on the stream and result characteristics; NimBLE reports it
+// from inside notify(), so the caller clears the flag and checks it afterwards
+class TltbBleService::NotifyCallbacks : public NimBLECharacteristicCallbacks {
+public:
+  explicit NotifyCallbacks(bool& failed) : _failed(failed) {}
+
+  void onStatus(NimBLECharacteristic* characteristic, Status s, int code) override {
+    (void)characteristic;
+    (void)code;
+    if (s != Status::SUCCESS_NOTIFY) {
+      _failed = true;
+    }
+  }
+
+private:
+  bool& _failed;
+};
+
 void TltbBleService::begin(const char* deviceName, const BleCallbacks& callbacks) {
   if (_initialized) {
     return;
@@ -106,6 +170,7 @@ void TltbBleService::begin(const char* deviceName, const BleCallbacks& callbacks
 
   _deviceName = deviceName && deviceName[0] ? deviceName : "TLTB Controller";
   _callbacks = callbacks;
+  _stream.setLogger([](const char* line) { Serial.println(line); });
   NimBLEDevice::init(_deviceName.c_str());
   Serial.println("[BLE] NimBLE initialized");
   
@@ -137,12 +202,19 @@ void TltbBleService::begin(const char* deviceName, const BleCallbacks& callbacks
                                               NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::NOTIFY);
   NimBLECharacteristic* control = service->createCharacteristic(kControlCharUuid,
                                                                 NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR);
-  if (!control || !_statusChar) {
+  _resultChar = service->createCharacteristic(kResultCharUuid,
+                                              NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::NOTIFY);
+  _statusBinChar = service->createCharacteristic(kStatusBinCharUuid,
+                                                 NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::NOTIFY);
+  _streamChar = service->createCharacteristic(kStreamCharUuid, NIMBLE_PROPERTY::NOTIFY);
+  if (!control || !_statusChar || !_resultChar || !_statusBinChar || !_streamChar) {
     ESP_LOGE(kBleLogTag, "Failed to create BLE characteristics");
     return;
   }
 
   control->setCallbacks(new ControlCallbacks(*this));
+  _streamChar->setCallbacks(new NotifyCallbacks(_streamNotifyFailed));
+  _resultChar->setCallbacks(new NotifyCallbacks(_resultNotifyFailed));
   service->start();
 
   NimBLEAdvertising* advertising = NimBLEDevice::getAdvertising();
@@ -168,89 +240,227 @@ void TltbBleService::publishStatus(const BleStatusContext& ctx) {
   // The BLE stack will handle fragmentation automatically if needed
 
   const uint32_t now = millis();
-  bool due = _forceNextStatus || (_lastNotifyMs == 0) || (now - _lastNotifyMs >= kStatusIntervalMs);
-  if (!due) {
+  const uint16_t statusFlags = statusFlagsFor(ctx);
+
+  // The binary form doubles as the change detector's snapshot (StatusNotifier.hpp)
+  const uint32_t binStart = micros();
+  BleStatusPacket::Status bin;
+  bin.flags = statusFlags;
+  bin.faultMask = (uint16_t)ctx.faultMask;
+  bin.cooldownSecs = ctx.telemetry.cooldownSecsRemaining;
+  bin.loadMilliAmps = BleStatusPacket::toMilliAmps(shownLoadAmps(ctx.telemetry));
+  bin.srcMilliVolts = BleStatusPacket::toMilliVolts(ctx.telemetry.srcV);
+  bin.outMilliVolts = BleStatusPacket::toMilliVolts(ctx.telemetry.outV);
+  bin.relayMask = relayMaskFor(ctx);
+  bin.bleedMask = bleedMaskFor(ctx.telemetry);
+  bin.sohPct = ctx.telemetry.battSohPct <= 100 ? ctx.telemetry.battSohPct : BleStatusPacket::SOH_UNKNOWN;
+  bin.profileId = ctx.profileId;
+  bin.rotaryPos = ctx.rotaryPos;
+  const uint32_t fillUs = micros() - binStart;
+
+  if (_notifier.decide(now, bin) == StatusNotifier::None) {
+    reportStatusStats(now);
     return;
   }
 
-  _forceNextStatus = false;
-  _lastNotifyMs = now;
+  // JSON characteristic (every app build reads this one)
+  const uint32_t jsonStart = micros();
+  char jsonBuffer[kStatusJsonCap];
+  const size_t jsonLen = buildStatusJson(ctx, statusFlags, jsonBuffer, sizeof(jsonBuffer));
+  const uint32_t jsonUs = micros() - jsonStart;
+  if (jsonLen) {
+    // Send raw JSON bytes - react-native-ble-plx will base64-encode for the app
+    _statusChar->setValue(reinterpret_cast<const uint8_t*>(jsonBuffer), jsonLen);
+    _statusChar->notify();
+  }
+
+  // Binary characteristic: same state, fixed 24-byte layout (BleStatusPacket.hpp)
+  const uint32_t encStart = micros();
+  bin.seq = _statusSeq++;
+  uint8_t packet[BleStatusPacket::SIZE];
+  BleStatusPacket::encode(bin, packet);
+  const uint32_t binUs = fillUs + (micros() - encStart);
+  if (_statusBinChar) {
+    _statusBinChar->setValue(packet, sizeof(packet));
+    _statusBinChar->notify();
+  }
+
+  noteEncodeCost(jsonUs, jsonLen, binUs);
+  reportStatusStats(now);
+}
 
+size_t TltbBleService::buildStatusJson(const BleStatusContext& ctx, uint16_t statusFlags, char* out, size_t cap) {
   StaticJsonDocument<kStatusJsonCap> doc;
   JsonObject root = doc.to<JsonObject>();
-  root["mode"] = (ctx.uiMode == 1) ? "RV" : "HD";
+  root["mode"] = ctx.modeTag ? ctx.modeTag : "HD";
   root["activeLabel"] = ctx.activeLabel ? ctx.activeLabel : "OFF";
   root["cooldownSecsRemaining"] = ctx.telemetry.cooldownSecsRemaining;
   root["faultMask"] = ctx.faultMask;
   // Timestamp removed - app uses notification receipt time
-
-  uint16_t statusFlags = 0;
-  if (ctx.enableRelay) {
-    statusFlags |= kFlagTwelveVoltEnabled;
-  }
-  if (ctx.telemetry.lvpLatched) {
-    statusFlags |= kFlagLvpLatched;
-  }
-  if (ctx.lvpBypass) {
-    statusFlags |= kFlagLvpBypass;
-  }
-  if (ctx.telemetry.outvLatched) {
-    statusFlags |= kFlagOutvLatched;
-  }
-  if (ctx.outvBypass) {
-    statusFlags |= kFlagOutvBypass;
-  }
-  if (ctx.telemetry.cooldownActive) {
-    statusFlags |= kFlagCooldownActive;
-  }
-  if (ctx.startupGuard) {
-    statusFlags |= kFlagStartupGuard;
-  }
   root["statusFlags"] = statusFlags;
 
-  setNullableFloat(root, "loadAmps", ctx.telemetry.loadA);
+  setNullableFloat(root, "loadAmps", shownLoadAmps(ctx.telemetry));
   setNullableFloat(root, "srcVoltage", ctx.telemetry.srcV);
   setNullableFloat(root, "outVoltage", ctx.telemetry.outV);
 
-  uint32_t relayMask = 0;
-  for (int i = 0; i < (int)R_ENABLE; ++i) {
-    if (ctx.relayStates[i]) {
-      relayMask |= (1u << i);
-    }
+  // Battery health (null until the estimator has a resistance fit)
+  if (ctx.telemetry.battSohPct <= 100) {
+    root["soh"] = ctx.telemetry.battSohPct;
+  } else {
+    root["soh"] = nullptr;
+  }
+
+  root["relayMask"] = relayMaskFor(ctx);
+  // Suspected bleed pair as relayMask bits, only while flagged (keeps the payload small)
+  if (const uint8_t bleed = bleedMaskFor(ctx.telemetry)) {
+    root["bleed"] = bleed;
   }
-  root["relayMask"] = relayMask;
 
   size_t needed = measureJson(doc);
   if (needed >= kStatusJsonCap) {
     ESP_LOGW(kBleLogTag, "Status JSON truncated (%u bytes needed)", static_cast<unsigned>(needed));
-    return;
+    return 0;
   }
 
-  char jsonBuffer[kStatusJsonCap];
-  size_t jsonLen = serializeJson(doc, jsonBuffer, sizeof(jsonBuffer));
-  if (jsonLen == 0 || jsonLen >= sizeof(jsonBuffer)) {
+  size_t jsonLen = serializeJson(doc, out, cap);
+  if (jsonLen == 0 || jsonLen >= cap) {
     ESP_LOGW(kBleLogTag, "Failed to serialize status JSON");
-    return;
+    return 0;
   }
 
   if (jsonLen > kStatusPayloadLimit) {
     ESP_LOGW(kBleLogTag, "Status payload too large (%u bytes)", static_cast<unsigned>(jsonLen));
+    return 0;
+  }
+  return jsonLen;
+}
+
+void TltbBleService::noteEncodeCost(uint32_t jsonUs, size_t jsonLen, uint32_t binUs) {
+  _encJsonUs += jsonUs;
+  _encJsonBytes += jsonLen;
+  _encBinUs += binUs;
+  _encSamples++;
+}
+
+// Notify rate, change latency, and encode cost/airtime of both status formats, once a minute
+void TltbBleService::reportStatusStats(uint32_t nowMs) {
+  const uint32_t span = nowMs - _statusReportMs;
+  if (_statusReportMs != 0 && span < kStatusReportMs) {
     return;
   }
+  // A new connection only opens a window (its connect-sync notify is not counted)
+  if (_statusReportMs != 0) {
+    const StatusNotifier::Stats& st = _notifier.stats();
+    const uint32_t total = st.change + st.heartbeat + st.forced;
+    Serial.printf("[BLE] Status: %lu notifies/min (change %lu, heartbeat %lu, forced %lu), change latency avg %lu ms max %lu ms\n",
+                  (unsigned long)(total * 60000ull / span), (unsigned long)st.change,
+                  (unsigned long)st.heartbeat, (unsigned long)st.forced,
+                  (unsigned long)(st.change ? st.latencySumMs / st.change : 0), (unsigned long)st.latencyMaxMs);
+    if (_encSamples) {
+      const uint32_t n = _encSamples;
+      const size_t avgJson = _encJsonBytes / n;
+      const uint16_t llPayload = 27;  // no data length extension: the worst (common) case
+      Serial.printf("[BLE] Status encode avg: JSON %lu us / %u B (%lu us air), binary %lu us / %u B (%lu us air)\n",
+                    (unsigned long)(_encJsonUs / n), (unsigned)avgJson,
+                    (unsigned long)BleStatusPacket::airtimeUs(avgJson, llPayload),
+                    (unsigned long)(_encBinUs / n), (unsigned)BleStatusPacket::SIZE,
+                    (unsigned long)BleStatusPacket::airtimeUs(BleStatusPacket::SIZE, llPayload));
+    }
+    if (_cmdWinApplied) {
+      Serial.printf("[BLE] Commands: %lu applied, enqueue->apply avg %lu us max %lu us, "
+                    "%lu dropped (queue full) and %lu stale since boot\n",
+                    (unsigned long)_cmdWinApplied, (unsigned long)(_cmdWinSumUs / _cmdWinApplied),
+                    (unsigned long)_cmdWinMaxUs, (unsigned long)_commands.dropped(), (unsigned long)_cmdStale);
+    }
+  }
+  _cmdWinApplied = _cmdWinSumUs = _cmdWinMaxUs = 0;
+  _notifier.clearStats();
+  _statusReportMs = nowMs;
+  _encSamples = 0;
+  _encJsonUs = _encBinUs = 0;
+  _encJsonBytes = 0;
+}
+
+// NimBLE host task: hand a parsed command to the loop
+void TltbBleService::enqueueCommand(BleCommand& cmd) {
+  cmd.enqueuedUs = micros();
+  if (!_commands.push(cmd)) {
+    ESP_LOGW(kBleLogTag, "Command queue full, command dropped");
+    requestImmediateStatus();  // let the app see nothing changed
+  }
+}
+
+// Loop task, once per pass: relay/flash commands never race the rotary
+// enforcement or the protector, which run on this task too
+void TltbBleService::serviceCommands() {
+  BleCommand cmd;
+  bool applied = false;
+  bool stale = false;
+  while (_commands.pop(cmd)) {
+    const uint32_t latencyUs = micros() - cmd.enqueuedUs;
+    if (latencyUs > kCmdStaleUs) {
+      _cmdStale++;
+      stale = true;
+      Serial.printf("[BLE] Dropped a %s command queued %lu ms ago\n",
+                    cmd.kind == BleCommand::Relay ? "relay" : "flash", (unsigned long)(latencyUs / 1000));
+      continue;
+    }
+    if (cmd.kind == BleCommand::Relay) {
+      if (_callbacks.onRelayCommand) {
+        _callbacks.onRelayCommand(static_cast<RelayIndex>(cmd.a), cmd.b != 0);
+      }
+    } else if (_callbacks.onFlashCommand) {
+      _callbacks.onFlashCommand(cmd.a, cmd.b, cmd.c);
+    }
+    _cmdApplied++;
+    _cmdLatencySumUs += latencyUs;
+    if (latencyUs > _cmdLatencyMaxUs) _cmdLatencyMaxUs = latencyUs;
+    _cmdWinApplied++;
+    _cmdWinSumUs += latencyUs;
+    if (latencyUs > _cmdWinMaxUs) _cmdWinMaxUs = latencyUs;
+    applied = true;
+  }
+  // A dropped command also gets a status: the app's optimistic toggle reverts
+  if (applied || stale) {
+    requestImmediateStatus();
+  }
+}
+
+TltbBleService::CommandStats TltbBleService::commandStats() const {
+  CommandStats st;
+  st.applied = _cmdApplied;
+  st.dropped = _commands.dropped() + _cmdStale;
+  st.stale = _cmdStale;
+  st.avgUs = _cmdApplied ? (uint32_t)(_cmdLatencySumUs / _cmdApplied) : 0;
+  st.maxUs = _cmdLatencyMaxUs;
+  return st;
+}
 
-  // Send raw JSON bytes - react-native-ble-plx will base64-encode for the app
-  _statusChar->setValue(reinterpret_cast<const uint8_t*>(jsonBuffer), jsonLen);
-  _statusChar->notify();
+// Live load graph (LoadStream.hpp): packets sized to the negotiated MTU
+void TltbBleService::publishLoadStream(float outV) {
+  if (!_streamChar) {
+    return;
+  }
+  const size_t payloadMax = _negotiatedMtu > 3 ? _negotiatedMtu - 3 : 20;
+  _stream.service(millis(), BleStatusPacket::toMilliVolts(outV), payloadMax,
+                  [this](const uint8_t* data, size_t len) {
+                    if (!_connected) {
+                      return false;
+                    }
+                    _streamNotifyFailed = false;
+                    _streamChar->setValue(data, len);
+                    _streamChar->notify();
+                    return !_streamNotifyFailed;
+                  });
 }
 
 void TltbBleService::requestImmediateStatus() {
-  _forceNextStatus = true;
+  _notifier.force();
 }
 
 void TltbBleService::syncStateOnConnection() {
-  // Force immediate status update and reset timing to ensure fresh sync
-  _forceNextStatus = true;
-  _lastNotifyMs = 0;
+  // Force immediate status update to ensure fresh sync
+  _notifier.force();
   ESP_LOGI(kBleLogTag, "State sync requested");
 }
 
@@ -302,6 +512,10 @@ void TltbBleService::shutdownForOta() {
   _initialized = false;
   _server = nullptr;
   _statusChar = nullptr;
+  _resultChar = nullptr;
+  _statusBinChar = nullptr;
+  _streamChar = nullptr;
+  _stream.request(0);
   
   // CRITICAL: Allow full BLE shutdown before WiFi heavy operations
   // ESP32 radio needs time to completely release BLE resources
@@ -334,7 +548,7 @@ void TltbBleService::handleControlWrite(const std::string& value) {
 
   // The React Native BLE PLX library decodes base64 before sending,
   // so we receive the raw JSON bytes directly - no base64 decoding needed!
-  StaticJsonDocument<kControlDecodeCap> doc;
+  DynamicJsonDocument doc(kControlDecodeCap);
   DeserializationError err = deserializeJson(doc, value);
   if (err) {
     ESP_LOGW(kBleLogTag, "Control JSON parse error: %s", err.c_str());
@@ -348,19 +562,387 @@ void TltbBleService::handleControlWrite(const std::string& value) {
     bool desiredState = doc["state"].as<bool>();
     RelayIndex idx;
     if (relayId && relayIndexFromId(relayId, idx)) {
-      if (_callbacks.onRelayCommand) {
-        _callbacks.onRelayCommand(idx, desiredState);
-      }
+      BleCommand cmd;
+      cmd.kind = BleCommand::Relay;
+      cmd.a = (uint8_t)idx;
+      cmd.b = desiredState ? 1 : 0;
+      enqueueCommand(cmd);   // status goes out once the loop has applied it
     } else {
       ESP_LOGW(kBleLogTag, "Invalid relay ID: %s", relayId ? relayId : "null");
+      requestImmediateStatus();
     }
-    requestImmediateStatus();
   } else if (type && strcmp(type, "refresh") == 0) {
     if (_callbacks.onRefreshRequest) {
       _callbacks.onRefreshRequest();
     }
     requestImmediateStatus();
+  } else if (type && strcmp(type, "flash") == 0) {
+    const char* mode = doc["mode"].as<const char*>();
+    uint8_t mask = 0;
+    if (mode && strcmp(mode, "left") == 0)        mask = relayBit(R_LEFT);
+    else if (mode && strcmp(mode, "right") == 0)  mask = relayBit(R_RIGHT);
+    else if (mode && strcmp(mode, "hazard") == 0) mask = relayBit(R_LEFT) | relayBit(R_RIGHT);
+    BleCommand cmd;
+    cmd.kind = BleCommand::Flash;
+    cmd.a = mask;
+    cmd.b = doc["fpm"].as<uint8_t>();
+    cmd.c = doc["duty"].as<uint8_t>();
+    enqueueCommand(cmd);
+  } else if (type && strcmp(type, "seqPut") == 0) {
+    handleSequenceUpload(doc);
+  } else if (type && strcmp(type, "seqRun") == 0) {
+    uint8_t slot = doc["slot"].as<uint8_t>();
+    if (_callbacks.onSequenceRun) {
+      _callbacks.onSequenceRun(slot);
+    }
+    requestImmediateStatus();
+  } else if (type && strcmp(type, "seqStop") == 0) {
+    if (_callbacks.onSequenceStop) {
+      _callbacks.onSequenceStop();
+    }
+    requestImmediateStatus();
+  } else if (type && strcmp(type, "profile") == 0) {
+    handleProfileCommand(doc);
+    requestImmediateStatus();
+  } else if (type && strcmp(type, "trailer") == 0) {
+    handleTrailerCommand(doc);
+  } else if (type && strcmp(type, "wear") == 0) {
+    publishRelayWear();
+  } else if (type && strcmp(type, "spectrum") == 0) {
+    publishLoadSpectrum();
+  } else if (type && strcmp(type, "wiggle") == 0) {
+    if (_callbacks.onWiggle) {
+      _callbacks.onWiggle(doc["on"] | true);
+    }
+    requestImmediateStatus();
+  } else if (type && strcmp(type, "stream") == 0) {
+    _stream.request(doc["hz"] | 0);
+  } else if (type && strcmp(type, "rfrec") == 0) {
+    if (doc["dump"] | false) {
+      if (_callbacks.onRfDump) {
+        _callbacks.onRfDump();
+      }
+    } else if (_callbacks.onRfRecord) {
+      _callbacks.onRfRecord(doc["on"] | true);
+    }
+  } else if (type && strcmp(type, "diag") == 0) {
+    if (_callbacks.onDiagStart) {
+      _callbacks.onDiagStart();
+    }
+    requestImmediateStatus();
+  } else if (type && strcmp(type, "diagStop") == 0) {
+    if (_callbacks.onDiagStop) {
+      _callbacks.onDiagStop();
+    }
+    requestImmediateStatus();
+  }
+}
+
+// {"type":"seqPut","slot":1,"name":"7-way","steps":[[mask,ms,minDeciA,maxDeciA,flags],...]}
+void TltbBleService::handleSequenceUpload(JsonDocument& doc) {
+  SeqProgram program;
+  uint8_t slot = doc["slot"].as<uint8_t>();
+  const char* name = doc["name"].as<const char*>();
+  if (name) {
+    strncpy(program.name, name, sizeof(program.name) - 1);
+  }
+
+  JsonArray steps = doc["steps"].as<JsonArray>();
+  if (steps.isNull() || steps.size() == 0 || steps.size() > SeqProgram::MAX_STEPS) {
+    ESP_LOGW(kBleLogTag, "Sequence upload rejected: bad step list");
+    return;
+  }
+  for (JsonArray step : steps) {
+    SeqStep& s = program.steps[program.stepCount++];
+    s.mask = step[0].as<uint8_t>() & RELAY_MASK_OUTPUTS;
+    s.durationMs = step[1].as<uint16_t>();
+    s.minDeciA = step[2].as<uint8_t>();
+    s.maxDeciA = step[3].as<uint8_t>();
+    s.flags = step[4].as<uint8_t>();
+    if (s.durationMs < 100) {
+      ESP_LOGW(kBleLogTag, "Sequence upload rejected: step %u too short", program.stepCount);
+      return;
+    }
+  }
+
+  bool ok = _callbacks.onSequenceStore && _callbacks.onSequenceStore(slot, program);
+  ESP_LOGI(kBleLogTag, "Sequence upload slot %u (%u steps): %s", slot, program.stepCount, ok ? "stored" : "rejected");
+}
+
+// {"type":"profile","select":1}
+// {"type":"profile","name":"5-way","tag":"5W","slots":[[mask,flags,"LABEL"],...6]}
+//   slots in LEFT,RIGHT,BRAKE,TAIL,MARKER,AUX order (rotary P3..P8 / RF buttons);
+//   flags bit0 = flashes as a turn signal; mask 0 = slot unused. Upload selects it.
+void TltbBleService::handleProfileCommand(JsonDocument& doc) {
+  if (!doc["select"].isNull()) {
+    uint8_t id = doc["select"].as<uint8_t>();
+    bool ok = _callbacks.onProfileSelect && _callbacks.onProfileSelect(id);
+    ESP_LOGI(kBleLogTag, "Profile select %u: %s", id, ok ? "ok" : "rejected");
+    return;
+  }
+
+  JsonArray slots = doc["slots"].as<JsonArray>();
+  if (slots.isNull() || slots.size() != ChannelProfile::SLOTS) {
+    ESP_LOGW(kBleLogTag, "Profile upload rejected: need %u slots", ChannelProfile::SLOTS);
+    return;
+  }
+  ChannelProfile profile;
+  const char* name = doc["name"].as<const char*>();
+  const char* tag = doc["tag"].as<const char*>();
+  strncpy(profile.name, name ? name : "Custom", sizeof(profile.name) - 1);
+  strncpy(profile.tag, tag ? tag : "CU", sizeof(profile.tag) - 1);
+  uint8_t i = 0;
+  for (JsonArray slot : slots) {
+    ChannelSlot& s = profile.slot[i++];
+    s.mask = slot[0].as<uint8_t>() & RELAY_MASK_OUTPUTS;
+    s.flags = slot[1].as<uint8_t>();
+    const char* label = slot[2].as<const char*>();
+    strncpy(s.label, label ? label : "--", sizeof(s.label) - 1);
+  }
+  bool ok = _callbacks.onProfileStore && _callbacks.onProfileStore(profile);
+  ESP_LOGI(kBleLogTag, "Profile upload \"%s\": %s", profile.name, ok ? "queued" : "rejected");
+}
+
+// {"type":"trailer","save":"NAME"} stores the last wiring diagnostic as NAME,
+// "select" makes NAME the comparison baseline ("" clears), "delete" removes it;
+// no key just reports the store. The reply comes from the loop once applied.
+void TltbBleService::handleTrailerCommand(JsonDocument& doc) {
+  TrailerStore::Op op = TrailerStore::Op::Query;
+  const char* name = nullptr;
+  if (!doc["save"].isNull()) {
+    op = TrailerStore::Op::Save;
+    name = doc["save"].as<const char*>();
+  } else if (!doc["select"].isNull()) {
+    op = TrailerStore::Op::Select;
+    name = doc["select"].as<const char*>();
+  } else if (!doc["delete"].isNull()) {
+    op = TrailerStore::Op::Remove;
+    name = doc["delete"].as<const char*>();
+  }
+  bool ok = _callbacks.onTrailerCommand && _callbacks.onTrailerCommand(op, name ? name : "");
+  ESP_LOGI(kBleLogTag, "Trailer command %u \"%s\": %s", static_cast<unsigned>(op), name ? name : "",
+           ok ? "queued" : "rejected");
+}
+
+// {"type":"seq","slot":0,"name":"Basic","verdict":"pass","done":4,"steps":[[avgDeciA,peakDeciA,ok],...]}
+void TltbBleService::publishSequenceResult(const SeqResult& result) {
+  StaticJsonDocument<kResultJsonCap> doc;
+  doc["type"] = "seq";
+  doc["slot"] = result.slot;
+  doc["name"] = result.name;
+  doc["verdict"] = Sequencer::verdictName(result.verdict);
+  doc["done"] = result.stepsDone;
+  JsonArray steps = doc.createNestedArray("steps");
+  for (uint8_t i = 0; i < result.stepsDone && i < SeqProgram::MAX_STEPS; ++i) {
+    JsonArray s = steps.createNestedArray();
+    s.add(result.steps[i].avgDeciA);
+    s.add(result.steps[i].peakDeciA);
+    s.add(result.steps[i].pass ? 1 : 0);
+  }
+
+  char jsonBuffer[kResultJsonCap];
+  size_t jsonLen = serializeJson(doc, jsonBuffer, sizeof(jsonBuffer));
+  if (jsonLen == 0 || jsonLen >= sizeof(jsonBuffer)) {
+    ESP_LOGW(kBleLogTag, "Failed to serialize result JSON");
+    return;
+  }
+  sendResult(jsonBuffer, jsonLen);
+}
+
+// {"type":"diag","verdict":"done","ch":[["led",settledDeciA,peakDeciA,bulbs,partner,dropCentiV],...]}
+// Channels are in relay order LEFT..AUX; partner is -1 unless cross-wired.
+void TltbBleService::publishWiringReport(const WiringReport& report) {
+  StaticJsonDocument<kResultJsonCap> doc;
+  doc["type"] = "diag";
+  doc["verdict"] = report.aborted ? "abort" : "done";
+  JsonArray chans = doc.createNestedArray("ch");
+  for (uint8_t i = 0; i < WiringReport::CHANNELS; ++i) {
+    const WireChannelResult& r = report.ch[i];
+    JsonArray c = chans.createNestedArray();
+    c.add(WiringDiag::className(r.cls));
+    c.add(r.settledDeciA);
+    c.add(r.peakDeciA);
+    c.add(r.bulbs);
+    c.add(r.partner);
+    c.add(r.dropCentiV);
+  }
+
+  char jsonBuffer[kResultJsonCap];
+  size_t jsonLen = serializeJson(doc, jsonBuffer, sizeof(jsonBuffer));
+  if (jsonLen == 0 || jsonLen >= sizeof(jsonBuffer)) {
+    ESP_LOGW(kBleLogTag, "Failed to serialize diag JSON");
+    return;
+  }
+  sendResult(jsonBuffer, jsonLen);
+}
+
+// {"type":"wear","r":[[cycles,switchedA,usedPermille,remainingCycles],...]}
+// Relays in index order LEFT..AUX, then ENABLE.
+void TltbBleService::publishRelayWear() {
+  StaticJsonDocument<kResultJsonCap> doc;
+  doc["type"] = "wear";
+  JsonArray relays = doc.createNestedArray("r");
+  for (int i = 0; i < (int)R_COUNT; ++i) {
+    RelayWear::Channel c = RelayWear::channel(static_cast<RelayIndex>(i));
+    JsonArray r = relays.createNestedArray();
+    r.add(c.cycles);
+    r.add(static_cast<uint32_t>(c.switchedA + 0.5f));
+    r.add(static_cast<uint32_t>(c.usedPct * 10.0f + 0.5f));
+    r.add(c.remainingCycles);
+  }
+
+  char jsonBuffer[kResultJsonCap];
+  size_t jsonLen = serializeJson(doc, jsonBuffer, sizeof(jsonBuffer));
+  if (jsonLen == 0 || jsonLen >= sizeof(jsonBuffer)) {
+    ESP_LOGW(kBleLogTag, "Failed to serialize wear JSON");
+    return;
+  }
+  sendResult(jsonBuffer, jsonLen);
+}
+
+// {"type":"wiggle","events":n,"perMin":m} - on each detected dropout (throttled)
+// and every 10 s while the wiggle test is on
+void TltbBleService::publishWiggle(uint32_t events, uint16_t perMinute) {
+  StaticJsonDocument<96> doc;
+  doc["type"] = "wiggle";
+  doc["events"] = events;
+  doc["perMin"] = perMinute;
+
+  char jsonBuffer[64];
+  size_t jsonLen = serializeJson(doc, jsonBuffer, sizeof(jsonBuffer));
+  if (jsonLen == 0 || jsonLen >= sizeof(jsonBuffer)) {
+    ESP_LOGW(kBleLogTag, "Failed to serialize wiggle JSON");
+    return;
+  }
+  sendResult(jsonBuffer, jsonLen);
+}
+
+// {"type":"trailer","ok":true,"count":12,"active":"FLEET 07"} - after a trailer command
+void TltbBleService::publishTrailerState(bool ok) {
+  StaticJsonDocument<160> doc;
+  doc["type"] = "trailer";
+  doc["ok"] = ok;
+  doc["count"] = trailerStore.count();
+  if (trailerStore.hasActive()) {
+    doc["active"] = trailerStore.active().name;
+  } else {
+    doc["active"] = nullptr;
+  }
+
+  char jsonBuffer[128];
+  size_t jsonLen = serializeJson(doc, jsonBuffer, sizeof(jsonBuffer));
+  if (jsonLen == 0 || jsonLen >= sizeof(jsonBuffer)) {
+    ESP_LOGW(kBleLogTag, "Failed to serialize trailer JSON");
+    return;
+  }
+  sendResult(jsonBuffer, jsonLen);
+}
+
+// {"type":"trlcmp","name":"FLEET 07","drift":[flags,...]} - after a wiring diagnostic
+// with an active trailer; flags per channel LEFT..AUX (see TRL_DRIFT_*)
+void TltbBleService::publishTrailerDrift(const TrailerDrift& drift) {
+  StaticJsonDocument<192> doc;
+  doc["type"] = "trlcmp";
+  doc["name"] = drift.name;
+  JsonArray flags = doc.createNestedArray("drift");
+  for (uint8_t i = 0; i < WiringReport::CHANNELS; ++i) {
+    flags.add(drift.flags[i]);
+  }
+
+  char jsonBuffer[128];
+  size_t jsonLen = serializeJson(doc, jsonBuffer, sizeof(jsonBuffer));
+  if (jsonLen == 0 || jsonLen >= sizeof(jsonBuffer)) {
+    ESP_LOGW(kBleLogTag, "Failed to serialize trailer drift JSON");
+    return;
+  }
+  sendResult(jsonBuffer, jsonLen);
+}
+
+// {"type":"spectrum","fs":370.2,"mean":4.12,"rms":4.31,"ripple":29.5,"dsp":true,
+//  "tones":[[hz,ampA],...]} - latest load-current block; tones strongest first,
+//  frequencies as seen at the sensor rate (aliased above fs/2)
+void TltbBleService::publishLoadSpectrum() {
+  const LoadSpectrum::Result r = LoadSpectrum::last();
+  StaticJsonDocument<384> doc;
+  doc["type"] = "spectrum";
+  if (!r.valid) {
+    doc["fs"] = nullptr;
+  } else {
+    doc["fs"] = roundf(r.sampleHz * 10.0f) / 10.0f;
+    doc["mean"] = roundf(r.meanA * 100.0f) / 100.0f;
+    doc["rms"] = roundf(r.rmsA * 100.0f) / 100.0f;
+    doc["ripple"] = roundf(r.ripplePct * 10.0f) / 10.0f;
+    JsonArray tones = doc.createNestedArray("tones");
+    for (uint8_t i = 0; i < r.peakCount; ++i) {
+      JsonArray t = tones.createNestedArray();
+      t.add(roundf(r.freqHz[i] * 10.0f) / 10.0f);
+      t.add(roundf(r.ampA[i] * 100.0f) / 100.0f);
+    }
+  }
+  doc["dsp"] = LoadSpectrum::accelerated();
+
+  char jsonBuffer[256];
+  size_t jsonLen = serializeJson(doc, jsonBuffer, sizeof(jsonBuffer));
+  if (jsonLen == 0 || jsonLen >= sizeof(jsonBuffer)) {
+    ESP_LOGW(kBleLogTag, "Failed to serialize spectrum JSON");
+    return;
+  }
+  sendResult(jsonBuffer, jsonLen);
+}
+
+size_t TltbBleService::rfRecordChunkMax() const {
+  if (!_connected || !_resultChar || _negotiatedMtu <= 3 + kRfRecJsonOverhead) {
+    return 0;
+  }
+  const size_t b64Chars = _negotiatedMtu - 3 - kRfRecJsonOverhead;
+  return (b64Chars / 4) * 3;
+}
+
+// {"type":"rfrec","off":0,"total":5120,"d":"UkZSMUM..."} - one base64 slice of an
+// RF recording (see rf/RfRecord.hpp); the client appends slices in offset order.
+// Unlike sendResult(), the whole notify must fit one ATT payload, and the caller
+// only moves on once NimBLE accepted it.
+bool TltbBleService::publishRfRecordChunk(uint32_t offset, uint32_t total, const uint8_t* data, size_t len) {
+  if (len > rfRecordChunkMax()) {
+    return false;
+  }
+  char b64[kResultJsonCap - 96];
+  size_t b64Len = 0;
+  if (mbedtls_base64_encode(reinterpret_cast<unsigned char*>(b64), sizeof(b64), &b64Len, data, len) != 0) {
+    ESP_LOGW(kBleLogTag, "RF record chunk too large (%u bytes)", static_cast<unsigned>(len));
+    return false;
+  }
+  StaticJsonDocument<128> doc;
+  doc["type"] = "rfrec";
+  doc["off"] = offset;
+  doc["total"] = total;
+  doc["d"] = static_cast<const char*>(b64);
+
+  char jsonBuffer[kResultJsonCap];
+  size_t jsonLen = serializeJson(doc, jsonBuffer, sizeof(jsonBuffer));
+  if (jsonLen == 0 || jsonLen > (size_t)(_negotiatedMtu - 3)) {
+    ESP_LOGW(kBleLogTag, "RF record chunk JSON (%u bytes) does not fit the MTU", static_cast<unsigned>(jsonLen));
+    return false;
+  }
+  _resultNotifyFailed = false;
+  _resultChar->setValue(reinterpret_cast<const uint8_t*>(jsonBuffer), jsonLen);
+  _resultChar->notify();
+  return !_resultNotifyFailed;
+}
+
+void TltbBleService::sendResult(const char* json, size_t len) {
+  if (!_resultChar) {
+    return;
+  }
+  // Always readable; notified when a client is listening
+  _resultChar->setValue(reinterpret_cast<const uint8_t*>(json), len);
+  if (!_connected) {
+    return;
+  }
+  if (len > (size_t)(_negotiatedMtu - 3)) {
+    ESP_LOGW(kBleLogTag, "Result (%u bytes) exceeds MTU payload; client should read it", static_cast<unsigned>(len));
   }
+  _resultChar->notify();
 }
 
 void TltbBleService::handleClientConnect(NimBLEServer* server) {
@@ -372,13 +954,14 @@ void TltbBleService::handleClientConnect(NimBLEServer* server) {
   
   // Force immediate status update on connection to sync relay states
   // This ensures the app always has current state, even after reconnect
-  _forceNextStatus = true;
-  _lastNotifyMs = 0;  // Allow immediate send
+  _notifier.force();
+  _statusReportMs = 0;  // fresh stats window per connection
   ESP_LOGI(kBleLogTag, "Immediate status sync queued for new connection");
 }
 
 void TltbBleService::handleClientDisconnect() {
   _connected = false;
+  _stream.request(0);  // opt-in per connection
   _mtuNegotiated = false;
   _negotiatedMtu = 23;
 }
@@ -390,7 +973,7 @@ void TltbBleService::handleMtuChanged(uint16_t mtu) {
            mtu, mtu - 3);
   
   // If we have a pending status notification, trigger it now
-  if (_forceNextStatus) {
+  if (_notifier.forced()) {
     ESP_LOGI(kBleLogTag, "MTU ready, will send deferred status notification");
   }
 }
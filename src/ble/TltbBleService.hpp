@@ -4,11 +4,19 @@
 #pragma once
 
 #include <Arduino.h>
+#include <ArduinoJson.h>
 #include <functional>
 #include <string>
 
 #include "telemetry.hpp"
 #include "relays.hpp"
+#include "seq/Sequencer.hpp"
+#include "diag/WiringDiag.hpp"
+#include "channel_map.hpp"
+#include "storage/TrailerStore.hpp"
+#include "ble/StatusNotifier.hpp"
+#include "ble/LoadStream.hpp"
+#include "ble/BleCommandQueue.hpp"
 
 class NimBLEServer;
 class NimBLECharacteristic;
@@ -23,18 +31,56 @@ struct BleStatusContext {
   bool relayStates[R_COUNT] = {false};
   const char* activeLabel = "OFF";
   uint32_t timestampMs = 0;
-  uint8_t uiMode = 0;
+  const char* modeTag = "HD";     // active channel profile tag
+  uint8_t profileId = 0;          // ChannelMap::activeId() (binary status)
+  uint8_t rotaryPos = 0;          // stable RotaryMode (binary status; JSON sends activeLabel)
 };
 
+// onRelayCommand and onFlashCommand run on the loop task (serviceCommands);
+// the others are called from the NimBLE host task and must only post requests.
 struct BleCallbacks {
   std::function<void(RelayIndex, bool)> onRelayCommand;
   std::function<void()> onRefreshRequest;
+  std::function<bool(uint8_t, const SeqProgram&)> onSequenceStore;
+  std::function<void(uint8_t)> onSequenceRun;
+  std::function<void()> onSequenceStop;
+  std::function<void(uint8_t, uint8_t, uint8_t)> onFlashCommand;  // mask (0 = stop), fpm, duty (0 = keep)
+  std::function<void()> onDiagStart;
+  std::function<void()> onDiagStop;
+  std::function<bool(const ChannelProfile&)> onProfileStore;
+  std::function<bool(uint8_t)> onProfileSelect;
+  std::function<void(bool)> onWiggle;
+  std::function<bool(TrailerStore::Op, const char*)> onTrailerCommand;
+  std::function<void(bool)> onRfRecord;        // start (fresh) / stop the RF recorder
+  std::function<void()> onRfDump;              // stop and stream the recording
 };
 
 class TltbBleService {
 public:
+  struct CommandStats {
+    uint32_t applied = 0;
+    uint32_t dropped = 0;    // queue full or stale
+    uint32_t stale = 0;      // of those, older than 500 ms when the loop got to them
+    uint32_t avgUs = 0;      // enqueue (NimBLE task) -> applied (loop), since boot
+    uint32_t maxUs = 0;
+  };
+
   void begin(const char* deviceName, const BleCallbacks& callbacks);
   void publishStatus(const BleStatusContext& ctx);
+  void publishSequenceResult(const SeqResult& result);
+  void publishWiringReport(const WiringReport& report);
+  void publishRelayWear();
+  void publishLoadSpectrum();
+  void publishWiggle(uint32_t events, uint16_t perMinute);
+  void publishTrailerState(bool ok);
+  void publishTrailerDrift(const TrailerDrift& drift);
+  // RF recorder slices: raw bytes that fit one notify at the current MTU (0 =
+  // no client or MTU too small), and the send itself (false = retry the slice)
+  size_t rfRecordChunkMax() const;
+  bool publishRfRecordChunk(uint32_t offset, uint32_t total, const uint8_t* data, size_t len);
+  void publishLoadStream(float outV);   // every loop pass; idle until the app asks for it
+  void serviceCommands();               // loop task: apply queued relay/flash commands
+  CommandStats commandStats() const;
   void requestImmediateStatus();
   void syncStateOnConnection();  // Force state sync for newly connected clients
   void stopAdvertising();
@@ -46,21 +92,42 @@ public:
 private:
   class ServerCallbacks;
   class ControlCallbacks;
+  class NotifyCallbacks;
 
   void handleControlWrite(const std::string& value);
   void handleClientConnect(NimBLEServer* server);
   void handleClientDisconnect();
   void handleMtuChanged(uint16_t mtu);
+  void handleSequenceUpload(JsonDocument& doc);
+  void handleProfileCommand(JsonDocument& doc);
+  void handleTrailerCommand(JsonDocument& doc);
+  void sendResult(const char* json, size_t len);
+  void enqueueCommand(BleCommand& cmd);
+  size_t buildStatusJson(const BleStatusContext& ctx, uint16_t statusFlags, char* out, size_t cap);
+  void noteEncodeCost(uint32_t jsonUs, size_t jsonLen, uint32_t binUs);
+  void reportStatusStats(uint32_t nowMs);
 
   bool _initialized = false;
   bool _connected = false;
   bool _mtuNegotiated = false;
   uint16_t _negotiatedMtu = 23;  // Default BLE MTU
-  bool _forceNextStatus = false;
-  uint32_t _lastNotifyMs = 0;
+  StatusNotifier _notifier;       // change-driven status notifies + heartbeat
+  uint32_t _statusReportMs = 0;
   BleCallbacks _callbacks{};
   NimBLEServer* _server = nullptr;
   NimBLECharacteristic* _statusChar = nullptr;
+  NimBLECharacteristic* _resultChar = nullptr;
+  NimBLECharacteristic* _statusBinChar = nullptr;   // fixed-layout status (BleStatusPacket.hpp)
+  uint8_t _statusSeq = 0;
+  NimBLECharacteristic* _streamChar = nullptr;      // live load graph (LoadStream.hpp)
+  LoadStream _stream;
+  bool _streamNotifyFailed = false;
+  bool _resultNotifyFailed = false;   // rfrec slices check their notify
+  BleCommandQueue _commands;        // NimBLE task -> loop
+  uint32_t _cmdApplied = 0, _cmdLatencyMaxUs = 0, _cmdStale = 0;
+  uint64_t _cmdLatencySumUs = 0;
+  uint32_t _cmdWinApplied = 0, _cmdWinSumUs = 0, _cmdWinMaxUs = 0;   // per stats report
+  uint32_t _encSamples = 0, _encJsonUs = 0, _encBinUs = 0, _encJsonBytes = 0;
   
   // Saved state for OTA restart
   String _deviceName;
@@ -0,0 +1,132 @@
+// File Overview: Implements the channel mapping profiles: built-in connector tables,
+// the NVS-backed custom profile, and the resolved active-profile pointer.
+#include "channel_map.hpp"
+#include "prefs.hpp"
+
+namespace {
+  constexpr uint8_t L = relayBit(R_LEFT), R = relayBit(R_RIGHT), B = relayBit(R_BRAKE),
+                    T = relayBit(R_TAIL), M = relayBit(R_MARKER), A = relayBit(R_AUX);
+
+  const ChannelProfile kBuiltin[ChannelMap::BUILTIN_COUNT] = {
+    // SAE J560 style: every function has its own pin
+    {"7-way HD", "HD", {{L, CH_SLOT_TURN, "LEFT"}, {R, CH_SLOT_TURN, "RIGHT"}, {B, 0, "BRAKE"},
+                        {T, 0, "TAIL"}, {M, 0, "MARK"}, {A, 0, "AUX"}}},
+    // RV blade: stop is combined into the turn pins, marker pin feeds reverse
+    {"7-way RV", "RV", {{L, CH_SLOT_TURN, "LEFT"}, {R, CH_SLOT_TURN, "RIGHT"}, {(uint8_t)(L | R), 0, "BRAKE"},
+                        {T, 0, "TAIL"}, {M, 0, "REV"}, {A, 0, "Ele Brakes"}}},
+    // Flat 4: combined stop/turn, tail, ground
+    {"4-way", "4W", {{L, CH_SLOT_TURN, "LEFT"}, {R, CH_SLOT_TURN, "RIGHT"}, {(uint8_t)(L | R), 0, "BRAKE"},
+                     {T, 0, "TAIL"}, {0, 0, "--"}, {0, 0, "--"}}},
+    // Round 6: flat 4 plus electric brakes and a 12V aux/reverse pin
+    {"6-way", "6W", {{L, CH_SLOT_TURN, "LEFT"}, {R, CH_SLOT_TURN, "RIGHT"}, {(uint8_t)(L | R), 0, "BRAKE"},
+                     {T, 0, "TAIL"}, {M, 0, "AUX"}, {A, 0, "Ele Brakes"}}},
+  };
+
+  Preferences*   g_prefs = nullptr;
+  ChannelProfile g_custom;
+  bool           g_haveCustom = false;
+
+  // Resolved once per change; every accessor reads through this
+  const ChannelProfile* volatile g_active = &kBuiltin[0];
+  volatile uint8_t g_activeId = 0;
+
+  portMUX_TYPE   g_mux = portMUX_INITIALIZER_UNLOCKED;
+  ChannelProfile g_pending;
+  volatile bool  g_pendingStore = false;
+  volatile int8_t g_pendingSelect = -1;
+
+  void sanitize(ChannelProfile& p) {
+    p.name[ChannelProfile::NAME_LEN - 1] = '\0';
+    p.tag[ChannelProfile::TAG_LEN - 1] = '\0';
+    for (uint8_t i = 0; i < ChannelProfile::SLOTS; ++i) {
+      p.slot[i].mask &= RELAY_MASK_OUTPUTS;
+      p.slot[i].label[ChannelSlot::LABEL_LEN - 1] = '\0';
+    }
+  }
+
+  void resolve(uint8_t id) {
+    if (id == ChannelMap::CUSTOM_ID && g_haveCustom) g_active = &g_custom;
+    else                                             g_active = &kBuiltin[id < ChannelMap::BUILTIN_COUNT ? id : 0];
+    g_activeId = (g_active == &g_custom) ? ChannelMap::CUSTOM_ID : (id < ChannelMap::BUILTIN_COUNT ? id : 0);
+  }
+}
+
+namespace ChannelMap {
+
+void begin(Preferences* prefs){
+  g_prefs = prefs;
+  if (g_prefs && g_prefs->getBytesLength(KEY_CH_PROFILE) == sizeof(ChannelProfile)) {
+    g_prefs->getBytes(KEY_CH_PROFILE, &g_custom, sizeof(g_custom));
+    sanitize(g_custom);
+    g_haveCustom = true;
+  }
+  resolve(g_prefs ? g_prefs->getUChar(KEY_UI_MODE, 0) : 0);
+}
+
+void service(){
+  if (g_pendingSelect >= 0) {
+    select((uint8_t)g_pendingSelect);
+    g_pendingSelect = -1;
+  }
+  if (!g_pendingStore) return;
+  portENTER_CRITICAL(&g_mux);
+  ChannelProfile p = g_pending;
+  g_pendingStore = false;
+  portEXIT_CRITICAL(&g_mux);
+  sanitize(p);
+  // Park on a built-in while the custom table is rewritten
+  const uint8_t prevId = g_activeId;
+  if (prevId == CUSTOM_ID) resolve(0);
+  g_custom = p;
+  g_haveCustom = true;
+  if (g_prefs) g_prefs->putBytes(KEY_CH_PROFILE, &g_custom, sizeof(g_custom));
+  select(CUSTOM_ID);
+  Serial.printf("[MAP] Custom profile \"%s\" stored\n", g_custom.name);
+}
+
+bool select(uint8_t id){
+  if (id > CUSTOM_ID || (id == CUSTOM_ID && !g_haveCustom)) return false;
+  resolve(id);
+  if (g_prefs && g_prefs->getUChar(KEY_UI_MODE, 0xFF) != id) g_prefs->putUChar(KEY_UI_MODE, id);
+  return true;
+}
+
+void selectNext(){
+  uint8_t n = g_activeId + 1;
+  if (n > CUSTOM_ID || (n == CUSTOM_ID && !g_haveCustom)) n = 0;
+  select(n);
+}
+
+bool requestSelect(uint8_t id){
+  if (id > CUSTOM_ID || (id == CUSTOM_ID && !g_haveCustom)) return false;
+  g_pendingSelect = (int8_t)id;
+  return true;
+}
+
+bool requestStoreCustom(const ChannelProfile& p){
+  portENTER_CRITICAL(&g_mux);
+  g_pending = p;
+  g_pendingStore = true;
+  portEXIT_CRITICAL(&g_mux);
+  return true;
+}
+
+uint8_t activeId(){ return g_activeId; }
+bool    hasCustom(){ return g_haveCustom; }
+const ChannelProfile& active(){ return *g_active; }
+
+uint8_t slotMask(uint8_t slot){
+  return slot < ChannelProfile::SLOTS ? g_active->slot[slot].mask : 0;
+}
+
+uint8_t slotFlags(uint8_t slot){
+  return slot < ChannelProfile::SLOTS ? g_active->slot[slot].flags : 0;
+}
+
+const char* slotLabel(uint8_t slot){
+  return slot < ChannelProfile::SLOTS ? g_active->slot[slot].label : "?";
+}
+
+const char* tag(){ return g_active->tag; }
+
+} // namespace ChannelMap
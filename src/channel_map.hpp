@@ -0,0 +1,61 @@
+// File Overview: Declares the table-driven channel mapping profiles (trailer connector
+// types) that decide which relays each rotary position / remote button drives and how
+// it is labelled, resolved once whenever the profile changes.
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+#include "relays.hpp"
+
+// A profile has one slot per function position. Slot i is rotary position P3+i
+// and remote (RF/BLE learn) button i, named after the relay it drives in the
+// 7-way HD wiring: LEFT, RIGHT, BRAKE, TAIL, MARKER, AUX. A slot can drive
+// any set of output relays (RV brake = LEFT+RIGHT) or none (pin not present
+// on that connector).
+struct ChannelSlot {
+  static constexpr uint8_t LABEL_LEN = 11;
+  uint8_t mask = 0;                 // output relays driven (0 = unused)
+  uint8_t flags = 0;                // CH_SLOT_*
+  char    label[LABEL_LEN] = {0};   // shown on the TFT and in BLE activeLabel
+};
+
+static constexpr uint8_t CH_SLOT_TURN = 0x01;   // flashes when the turn-signal flash option is on
+
+struct ChannelProfile {
+  static constexpr uint8_t SLOTS = R_ENABLE;     // one per output relay position
+  static constexpr uint8_t NAME_LEN = 12;
+  static constexpr uint8_t TAG_LEN = 4;
+  char        name[NAME_LEN] = {0};   // "7-way HD"
+  char        tag[TAG_LEN] = {0};     // home screen / BLE "mode" ("HD")
+  ChannelSlot slot[SLOTS];
+};
+
+namespace ChannelMap {
+  // Built-ins: 0 = 7-way HD, 1 = 7-way RV (ids 0/1 match the old HD/RV ui_mode),
+  // 2 = 4-way flat, 3 = 6-way round; CUSTOM_ID = uploaded over BLE.
+  static constexpr uint8_t BUILTIN_COUNT = 4;
+  static constexpr uint8_t CUSTOM_ID = BUILTIN_COUNT;
+
+  void begin(Preferences* prefs);     // loads the stored selection and custom profile
+
+  // Loop task: apply a deferred selection / persist a deferred custom upload
+  void service();
+
+  // Switch profile (persisted); false if the id doesn't exist
+  bool select(uint8_t id);
+  // Next available profile (wraps), for the home-screen mode button
+  void selectNext();
+
+  // Any task: staged for service(); an uploaded custom profile is also selected
+  bool requestSelect(uint8_t id);
+  bool requestStoreCustom(const ChannelProfile& p);
+
+  uint8_t activeId();
+  bool    hasCustom();
+  const ChannelProfile& active();
+
+  // Resolved-table accessors (no NVS access)
+  uint8_t     slotMask(uint8_t slot);
+  uint8_t     slotFlags(uint8_t slot);
+  const char* slotLabel(uint8_t slot);
+  const char* tag();
+}
@@ -0,0 +1,211 @@
+// File Overview: Implements the cross-channel bleed detector: baseline storage, expected
+// current per output mask, excess matching against the switched-off channels, and
+// hold/clear timing.
+#include "BleedDetector.hpp"
+#include <math.h>
+#include "prefs.hpp"
+
+// Global instance
+BleedDetector bleedDetector;
+
+namespace {
+  // NVS layout (size-checked like the inrush envelopes)
+  struct StoredBaselines {
+    uint8_t  singleValid;
+    uint8_t  comboCount;
+    uint8_t  okMask;
+    uint16_t idleMilliA;
+    uint16_t singleMilliA[R_ENABLE];
+    uint8_t  comboMask[8];
+    uint16_t comboMilliA[8];
+  };
+
+  inline uint16_t toMilli(float a) {
+    float m = a * 1000.0f + 0.5f;
+    if (m < 0.0f) m = 0.0f;
+    return (uint16_t)(m > 65535.0f ? 65535.0f : m);
+  }
+
+  inline bool singleBit(uint8_t m) { return m && !(m & (m - 1)); }
+
+  inline int lowestBit(uint8_t m) {
+    for (int i = 0; i < 8; ++i) if (m & (1u << i)) return i;
+    return -1;
+  }
+}
+
+void BleedDetector::begin(Preferences* prefs) {
+  _prefs = prefs;
+  if (!_prefs || _prefs->getBytesLength(KEY_CH_BASELINE) != sizeof(StoredBaselines)) return;
+  StoredBaselines s;
+  _prefs->getBytes(KEY_CH_BASELINE, &s, sizeof(s));
+  _okMask = s.okMask & RELAY_MASK_OUTPUTS;
+  _singleValid = s.singleValid & _okMask;
+  _idleA = s.idleMilliA / 1000.0f;
+  for (uint8_t i = 0; i < CHANNELS; ++i) _single[i] = s.singleMilliA[i] / 1000.0f;
+  _comboCount = s.comboCount > COMBOS ? COMBOS : s.comboCount;
+  for (uint8_t i = 0; i < _comboCount; ++i) {
+    _combo[i].mask = s.comboMask[i];
+    _combo[i].amps = s.comboMilliA[i] / 1000.0f;
+  }
+}
+
+void BleedDetector::save() {
+  if (!_prefs) return;
+  StoredBaselines s = {};
+  s.singleValid = _singleValid;
+  s.comboCount = _comboCount;
+  s.okMask = _okMask;
+  s.idleMilliA = toMilli(_idleA);
+  for (uint8_t i = 0; i < CHANNELS; ++i) s.singleMilliA[i] = toMilli(_single[i]);
+  for (uint8_t i = 0; i < _comboCount; ++i) {
+    s.comboMask[i] = _combo[i].mask;
+    s.comboMilliA[i] = toMilli(_combo[i].amps);
+  }
+  _prefs->putBytes(KEY_CH_BASELINE, &s, sizeof(s));
+}
+
+void BleedDetector::learnFromReport(const WiringReport& r) {
+  if (r.aborted) return;
+  // A channel flagged as bleeding since the last run may have drawn its
+  // partner's current in this one too; the next clean run learns it
+  const uint8_t bleeding = _bleedMask;
+  _bleedMask = 0;
+  for (uint8_t i = 0; i < CHANNELS; ++i) {
+    const WireChannelResult& c = r.ch[i];
+    const uint8_t bit = relayBit((RelayIndex)i);
+    const bool ok = !(bleeding & bit) &&
+                    (c.cls == WireClass::Open || c.cls == WireClass::Led ||
+                     c.cls == WireClass::Incandescent);
+    if (ok) {
+      _single[i] = c.settledDeciA / 10.0f;
+      _singleValid |= bit;
+      _okMask |= bit;
+    } else {
+      // Short, cross-wired, bleeding or not measured: unknown until a clean run
+      _singleValid &= (uint8_t)~bit;
+      _okMask &= (uint8_t)~bit;
+    }
+  }
+  // Combinations were learned against the old singles
+  _comboCount = 0;
+  save();
+  Serial.printf("[BLEED] Baselines from wiring diagnostic (valid 0x%02X)\n", _singleValid);
+}
+
+// Expected current for a mask above idle: a learned combination if there is one,
+// otherwise the sum of single-channel baselines (false if any is missing)
+bool BleedDetector::expectedFor(uint8_t mask, float& out, int& comboIdx) const {
+  comboIdx = -1;
+  for (uint8_t i = 0; i < _comboCount; ++i) {
+    if (_combo[i].mask == mask) { comboIdx = i; out = _combo[i].amps; return true; }
+  }
+  if ((mask & _singleValid) != mask) return false;
+  out = 0.0f;
+  for (uint8_t i = 0; i < CHANNELS; ++i) {
+    if (mask & relayBit((RelayIndex)i)) out += _single[i];
+  }
+  return true;
+}
+
+// The switched-off channel whose baseline best explains the excess, or -1
+int BleedDetector::matchBleed(uint8_t onMask, float excessA) const {
+  int best = -1;
+  float bestErr = MATCH_FRAC;
+  for (uint8_t i = 0; i < CHANNELS; ++i) {
+    const uint8_t bit = relayBit((RelayIndex)i);
+    if ((onMask & bit) || !(_singleValid & bit) || _single[i] < MIN_LOAD_A) continue;
+    float err = fabsf(excessA - _single[i]) / _single[i];
+    if (err <= bestErr) { bestErr = err; best = i; }
+  }
+  return best;
+}
+
+void BleedDetector::refine(uint8_t mask, float aboveIdleA, int comboIdx) {
+  if (singleBit(mask)) {
+    const int ch = lowestBit(mask);
+    if (!(_singleValid & mask)) {
+      // First sight of this channel alone: seed it (persisted once), but only
+      // when the diagnostic found it wired correctly; a faulted channel's
+      // current would become the baseline that hides the fault
+      if (!(_okMask & mask)) return;
+      _single[ch] = aboveIdleA;
+      _singleValid |= mask;
+      save();
+      return;
+    }
+    _single[ch] += REFINE_ALPHA * (aboveIdleA - _single[ch]);
+    return;
+  }
+  if (comboIdx >= 0) {
+    _combo[comboIdx].amps += REFINE_ALPHA * (aboveIdleA - _combo[comboIdx].amps);
+  } else if (_comboCount < COMBOS) {
+    _combo[_comboCount++] = Combo{mask, aboveIdleA};
+    save();
+  }
+}
+
+void BleedDetector::service(float loadA, bool enabled, uint32_t nowMs) {
+  const uint8_t mask = relaysMask() & RELAY_MASK_OUTPUTS;
+  if (mask != _mask) {
+    _mask = mask;
+    _maskSinceMs = nowMs;
+    _suspectB = -1;
+    // A flag names a channel that is on; it can't outlive that channel
+    if (_flagA >= 0 && !(mask & relayBit((RelayIndex)_flagA))) {
+      _flagA = _flagB = -1;
+    }
+  }
+  if (!enabled || isnan(loadA) || (nowMs - _maskSinceMs) < SETTLE_MS) {
+    _suspectB = -1;
+    return;
+  }
+  const float a = fabsf(loadA);
+
+  const bool refineDue = (nowMs - _lastRefineMs) >= REFINE_EVERY_MS;
+  if (refineDue) _lastRefineMs = nowMs;
+
+  if (!mask) {
+    if (refineDue) _idleA += REFINE_ALPHA * (a - _idleA);
+    _flagA = _flagB = -1;
+    return;
+  }
+
+  float expected = 0.0f;
+  int comboIdx = -1;
+  const float aboveIdle = a - _idleA;
+  if (!expectedFor(mask, expected, comboIdx)) {
+    if (singleBit(mask)) refine(mask, aboveIdle, -1);
+    return;
+  }
+
+  const float excess = aboveIdle - expected;
+  const float limit = fmaxf(MIN_EXCESS_A, expected * EXCESS_FRAC);
+  const int suspect = (excess > limit) ? matchBleed(mask, excess) : -1;
+
+  if (suspect >= 0) {
+    _clearSinceMs = nowMs;
+    if (suspect != _suspectB) {
+      _suspectB = (int8_t)suspect;
+      _suspectSinceMs = nowMs;
+    } else if (_flagA < 0 && (nowMs - _suspectSinceMs) >= HOLD_MS) {
+      _flagA = (int8_t)lowestBit(mask);
+      _flagB = (int8_t)suspect;
+      _bleedMask |= relayBit((RelayIndex)_flagA);
+      Serial.printf("[BLEED] %s -> %s: %.2fA over %.2fA expected\n",
+                    relayName((RelayIndex)_flagA), relayName((RelayIndex)_flagB), excess, expected);
+    }
+    return;
+  }
+
+  _suspectB = -1;
+  if (_flagA >= 0) {
+    if ((nowMs - _clearSinceMs) >= HOLD_MS) _flagA = _flagB = -1;
+    return;
+  }
+  // Healthy and steady: follow slow drift (lamp ageing, supply voltage)
+  if (!refineDue) return;
+  if (fabsf(excess) <= expected * REFINE_FRAC || (comboIdx < 0 && !singleBit(mask) && excess <= limit)) {
+    refine(mask, aboveIdle, comboIdx);
+  }
+}
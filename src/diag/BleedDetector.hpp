@@ -0,0 +1,72 @@
+// File Overview: Declares the cross-channel bleed detector that compares the live load
+// current against per-channel and per-combination baselines and names the channel pair
+// when one output's current shows up while another is switched on.
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+#include "relays.hpp"
+#include "diag/WiringDiag.hpp"
+
+// A pinched harness (e.g. brake touching left turn) makes LEFT light the brake
+// lamps too: the current with LEFT on is LEFT's baseline plus roughly BRAKE's.
+// Baselines come from the wiring diagnostic (each channel alone) and are seeded
+// or refined while driving; multi-channel masks get their own learned entry so
+// loads that don't add linearly aren't mistaken for bleed. Only channels the
+// last diagnostic classified as correctly wired are ever learned.
+class BleedDetector {
+public:
+  void begin(Preferences* prefs);
+
+  // Loop task, once per pass after the outputs are settled for this pass.
+  // 'enabled' is false while outputs are flashing/being tested or a latch is active.
+  void service(float loadA, bool enabled, uint32_t nowMs);
+
+  // Adopt the single-channel currents of a finished wiring diagnostic; shorted,
+  // cross-wired and bleeding channels become unknown instead
+  void learnFromReport(const WiringReport& r);
+
+  bool   active() const { return _flagA >= 0; }
+  int8_t pairA() const { return _flagA; }        // channel that is on
+  int8_t pairB() const { return _flagB; }        // channel its current bleeds into
+
+private:
+  struct Combo { uint8_t mask; float amps; };
+
+  bool  expectedFor(uint8_t mask, float& out, int& comboIdx) const;
+  int   matchBleed(uint8_t onMask, float excessA) const;
+  void  refine(uint8_t mask, float loadA, int comboIdx);
+  void  save();
+
+  Preferences* _prefs = nullptr;
+
+  static constexpr uint8_t CHANNELS = R_ENABLE;
+  static constexpr uint8_t COMBOS   = 8;
+
+  float   _single[CHANNELS] = {};
+  uint8_t _singleValid = 0;        // relayBit() set when _single[] holds a baseline
+  uint8_t _okMask = 0;             // relayBit() set when the last diagnostic found it OK
+  uint8_t _bleedMask = 0;          // channels flagged as bleeding since the last diagnostic
+  Combo   _combo[COMBOS] = {};
+  uint8_t _comboCount = 0;
+  float   _idleA = 0.0f;
+
+  uint8_t  _mask = 0;
+  uint32_t _maskSinceMs = 0;
+  uint32_t _suspectSinceMs = 0;
+  int8_t   _suspectB = -1;
+  uint32_t _clearSinceMs = 0;
+  uint32_t _lastRefineMs = 0;
+  int8_t   _flagA = -1, _flagB = -1;
+
+  static constexpr uint32_t SETTLE_MS    = 600;    // lamps hot, LED drivers regulated
+  static constexpr uint32_t HOLD_MS      = 1500;   // sustained before flagging / clearing
+  static constexpr float    MIN_EXCESS_A = 0.3f;
+  static constexpr float    EXCESS_FRAC  = 0.25f;  // of the expected current
+  static constexpr float    MATCH_FRAC   = 0.35f;  // excess vs the suspected channel's baseline
+  static constexpr float    MIN_LOAD_A   = 0.2f;   // smaller channels can't be told from noise
+  static constexpr float    REFINE_FRAC  = 0.15f;  // only track drift this close to expected
+  static constexpr float    REFINE_ALPHA = 0.05f;
+  static constexpr uint32_t REFINE_EVERY_MS = 1000;
+};
+
+extern BleedDetector bleedDetector;
@@ -0,0 +1,113 @@
+// File Overview: Implements the wiggle-test detector: block statistics over the load
+// sampler ring, clean-block baseline tracking, and event counting/chirping.
+#include "FlickerDetector.hpp"
+#include <math.h>
+#include "buzzer.hpp"
+
+FlickerDetector flickerDetector;
+
+void FlickerDetector::setEnabled(bool on){
+  if (on == _enabled) return;
+  _enabled = on;
+  _events = 0;
+  _histHead = 0;
+  memset(_history, 0, sizeof(_history));
+  _reader = LoadSampler::Reader{};    // start from the newest sample
+  reset(millis());
+  Serial.printf("[WIGGLE] %s\n", on ? "Enabled" : "Disabled");
+}
+
+void FlickerDetector::reset(uint32_t nowMs){
+  _settleFromMs = nowMs;
+  _n = 0;
+  _baseA = 0.0f;
+  _blocksClean = 0;
+  _disturbed = false;
+}
+
+void FlickerDetector::service(uint8_t outMask, bool steady, uint32_t nowMs){
+  if (_pendingEnable >= 0) {
+    setEnabled(_pendingEnable == 1);
+    _pendingEnable = -1;
+  }
+  if (!_enabled) return;
+
+  LoadSampler::Sample buf[32];
+  if (!steady || !outMask || outMask != _mask || _reader.lost != _lost) {
+    // Output changed (or the loop stalled past the ring): drain and settle again
+    _mask = steady ? outMask : 0;
+    _lost = _reader.lost;
+    while (LoadSampler::take(_reader, buf, 32) == 32) {}
+    _lost = _reader.lost;
+    reset(nowMs);
+    return;
+  }
+  if (nowMs - _settleFromMs < SETTLE_MS) {
+    while (LoadSampler::take(_reader, buf, 32) == 32) {}
+    return;
+  }
+
+  size_t got;
+  while ((got = LoadSampler::take(_reader, buf, 32)) > 0) {
+    for (size_t i = 0; i < got; ++i) {
+      const float a = fabsf(buf[i].amps);
+      if (_n == 0) { _sum = 0.0f; _sumSq = 0.0f; _min = a; }
+      _sum += a;
+      _sumSq += a * a;
+      if (a < _min) _min = a;
+      if (++_n == BLOCK) {
+        evaluateBlock(nowMs);
+        _n = 0;
+      }
+    }
+  }
+}
+
+void FlickerDetector::evaluateBlock(uint32_t nowMs){
+  const float mean = _sum / BLOCK;
+  const float var  = fmaxf(0.0f, _sumSq / BLOCK - mean * mean);
+
+  if (_blocksClean < PRIME_BLOCKS) {
+    // Learn the lamp's level and ripple first; a harness that is already
+    // intermittent just takes longer to prime
+    _baseA = _blocksClean ? _baseA + (mean - _baseA) * 0.3f : mean;
+    if (sqrtf(var) <= NOISE_CV * fmaxf(mean, MIN_LOAD_A)) _blocksClean++;
+    return;
+  }
+  if (_baseA < MIN_LOAD_A) {
+    _baseA += (mean - _baseA) * BASE_ALPHA;
+    return;
+  }
+
+  const bool dropout = _min < DROP_FRAC * _baseA;
+  const bool noisy   = sqrtf(var) > NOISE_CV * _baseA;
+  const bool disturbed = dropout || noisy;
+
+  if (disturbed && !_disturbed && nowMs - _lastEventMs >= REARM_MS) {
+    _events++;
+    _lastEventMs = nowMs;
+    _history[_histHead] = nowMs;
+    _histHead = (_histHead + 1) % HISTORY;
+    _newEvent = true;
+    Buzzer::beep(30);
+    Serial.printf("[WIGGLE] Event %lu: min %.2fA mean %.2fA base %.2fA\n",
+                  (unsigned long)_events, _min, mean, _baseA);
+  }
+  _disturbed = disturbed;
+  if (!disturbed) _baseA += (mean - _baseA) * BASE_ALPHA;
+}
+
+uint16_t FlickerDetector::eventsPerMinute(uint32_t nowMs) const {
+  uint16_t n = 0;
+  const uint8_t stored = _events < HISTORY ? (uint8_t)_events : HISTORY;
+  for (uint8_t i = 0; i < stored; ++i) {
+    if (nowMs - _history[i] < 60000u) n++;
+  }
+  return n;
+}
+
+bool FlickerDetector::takeEvent(){
+  if (!_newEvent) return false;
+  _newEvent = false;
+  return true;
+}
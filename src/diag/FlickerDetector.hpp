@@ -0,0 +1,66 @@
+// File Overview: Declares the harness wiggle-test (intermittent connection) detector that
+// scans the full-rate load-current ring for micro-dropouts on a steady output.
+#pragma once
+#include <Arduino.h>
+#include "sensors/LoadSampler.hpp"
+
+// While enabled and a steady output is on, every INA226 conversion is grouped
+// into blocks; each block's mean/variance/minimum is compared against a
+// baseline learned from clean blocks. A block whose minimum drops well below
+// the baseline (contact opened for a conversion or two) or whose spread is far
+// above the lamp's normal ripple (contact chattering) is "disturbed"; each
+// clean -> disturbed transition is one event and chirps the buzzer.
+class FlickerDetector {
+public:
+  void setEnabled(bool on);                      // loop task
+  void requestEnabled(bool on) { _pendingEnable = on ? 1 : 0; }   // any task; applied by service()
+  bool enabled() const { return _enabled; }
+
+  // Loop task. 'outMask' = output relays currently on; 'steady' is false while
+  // flashing, a test/diagnostic drives the outputs, or a protection latch is set.
+  void service(uint8_t outMask, bool steady, uint32_t nowMs);
+
+  uint32_t events() const { return _events; }
+  uint16_t eventsPerMinute(uint32_t nowMs) const;
+  bool     armed() const { return _blocksClean >= PRIME_BLOCKS; }   // baseline learned
+
+  // True once per new event (for throttled BLE/log reporting)
+  bool takeEvent();
+
+private:
+  void reset(uint32_t nowMs);
+  void evaluateBlock(uint32_t nowMs);
+
+  static constexpr uint8_t  BLOCK        = 16;     // ~43 ms at 370 S/s
+  static constexpr uint8_t  PRIME_BLOCKS = 6;      // clean blocks before detection starts
+  static constexpr uint32_t SETTLE_MS    = 300;    // after an output change
+  static constexpr float    MIN_LOAD_A   = 0.1f;   // below this there is nothing to lose
+  static constexpr float    DROP_FRAC    = 0.6f;   // block minimum below 60% of baseline
+  static constexpr float    NOISE_CV     = 0.15f;  // block std-dev above 15% of baseline
+  static constexpr float    BASE_ALPHA   = 0.1f;   // baseline EMA on clean blocks
+  static constexpr uint32_t REARM_MS     = 100;    // min spacing between counted events
+  static constexpr uint8_t  HISTORY      = 64;     // event timestamps kept for the per-minute rate
+
+  LoadSampler::Reader _reader;
+  bool     _enabled = false;
+  uint8_t  _mask = 0;
+  uint32_t _settleFromMs = 0;
+  uint32_t _lost = 0;
+
+  // Current block accumulators
+  uint8_t  _n = 0;
+  float    _sum = 0.0f, _sumSq = 0.0f, _min = 0.0f;
+
+  float    _baseA = 0.0f;
+  uint16_t _blocksClean = 0;
+  bool     _disturbed = false;
+
+  uint32_t _events = 0;
+  uint32_t _lastEventMs = 0;
+  uint32_t _history[HISTORY] = {};
+  uint8_t  _histHead = 0;
+  volatile bool _newEvent = false;
+  volatile int8_t _pendingEnable = -1;
+};
+
+extern FlickerDetector flickerDetector;
@@ -0,0 +1,244 @@
+// File Overview: Implements the wiring diagnostic state machine: idle baseline, per-channel
+// inrush burst + settled current capture, load classification, and the cross-wire pair check.
+#include "WiringDiag.hpp"
+#include <math.h>
+#include "flasher.hpp"
+#include "power/Protector.hpp"
+
+// Global instance
+WiringDiag wiringDiag;
+
+namespace {
+  // Nominal hot current of one typical bulb per channel (1157/1156 stop/turn,
+  // 194 marker, small reverse/aux lamps); used only for the bulb estimate.
+  constexpr float kBulbA[WiringReport::CHANNELS] = {2.1f, 2.1f, 2.1f, 0.6f, 0.3f, 2.1f};
+
+  inline uint8_t toDeci(float a) {
+    float d = a * 10.0f + 0.5f;
+    if (d < 0.0f) d = 0.0f;
+    return (uint8_t)(d > 255.0f ? 255.0f : d);
+  }
+
+  inline uint8_t toCenti(float v) {
+    float c = v * 100.0f + 0.5f;
+    if (c < 0.0f) c = 0.0f;
+    return (uint8_t)(c > 255.0f ? 255.0f : c);
+  }
+
+  inline bool isLoad(WireClass c) { return c == WireClass::Led || c == WireClass::Incandescent; }
+}
+
+void WiringDiag::begin(float (*sampleProtected)()) {
+  _sample = sampleProtected;
+}
+
+bool WiringDiag::takeReport(WiringReport& out) {
+  if (!_reportReady) return false;
+  out = _report;
+  _reportReady = false;
+  return true;
+}
+
+const char* WiringDiag::className(WireClass c) {
+  switch (c) {
+    case WireClass::Open:         return "open";
+    case WireClass::Short:        return "short";
+    case WireClass::Led:          return "led";
+    case WireClass::Incandescent: return "incand";
+    case WireClass::CrossWired:   return "cross";
+    default:                      return "none";
+  }
+}
+
+void WiringDiag::service(float loadA, float outV, bool modeOk, uint32_t nowMs) {
+  if (_reqStop) {
+    _reqStop = false;
+    _reqStart = false;
+    if (running()) finish(true);
+  }
+  if (_reqStart) {
+    _reqStart = false;
+    if (!running() && modeOk) start(nowMs);
+  }
+  if (!running()) return;
+  if (!modeOk) { finish(true); return; }
+
+  // OCP while a channel is driven is a finding, not just an abort
+  ProtectionState ps = protector.state();
+  if (ps.anyLatched()) {
+    if (ps.ocpLatched) recordTrip(loadA);
+    else finish(true);
+    return;
+  }
+
+  const uint32_t elapsed = nowMs - _phaseMs;
+  const bool have = !isnan(loadA);
+  const float a = have ? fabsf(loadA) : 0.0f;
+  const bool haveV = !isnan(outV);
+
+  switch (_phase) {
+    case Phase::Baseline:
+      if (elapsed >= BASELINE_MS / 2 && have) { _sumA += a; _n++; }
+      if (elapsed >= BASELINE_MS / 2 && haveV) { _sumV += outV; _nV++; }
+      if (elapsed >= BASELINE_MS) {
+        _idleA = _n ? (_sumA / (float)_n) : 0.0f;
+        _idleV = _nV ? (_sumV / (float)_nV) : 0.0f;
+        _ch = 0;
+        energize(relayBit((RelayIndex)_ch), nowMs);
+      }
+      break;
+
+    case Phase::Settle:
+    case Phase::PairSettle:
+      if (elapsed >= SETTLE_START_MS && have) { _sumA += a; _n++; }
+      if (elapsed >= SETTLE_START_MS && haveV) { _sumV += outV; _nV++; }
+      if (elapsed >= SETTLE_END_MS) {
+        float settled = _n ? (_sumA / (float)_n) - _idleA : 0.0f;
+        if (settled < 0.0f) settled = 0.0f;
+        if (_phase == Phase::Settle) {
+          _settledA[_ch] = settled;
+          classify(_ch);
+          if (_nV && _idleV > 0.0f) _report.ch[_ch].dropCentiV = toCenti(_idleV - _sumV / (float)_nV);
+        } else {
+          // Two channels feeding the same lamp draw about what one does
+          float single = fmaxf(_settledA[_pairA], _settledA[_pairB]);
+          if (settled < single * PAIR_SHARED) {
+            _report.ch[_pairA].cls = WireClass::CrossWired;
+            _report.ch[_pairA].partner = (int8_t)_pairB;
+            _report.ch[_pairB].cls = WireClass::CrossWired;
+            _report.ch[_pairB].partner = (int8_t)_pairA;
+          }
+        }
+        relaysUpdate(RELAY_MASK_OUTPUTS, 0);
+        _phase = (_phase == Phase::Settle) ? Phase::OffGap : Phase::PairGap;
+        _phaseMs = nowMs;
+      }
+      break;
+
+    case Phase::OffGap:
+      if (elapsed < OFF_GAP_MS) break;
+      if (++_ch < WiringReport::CHANNELS) {
+        energize(relayBit((RelayIndex)_ch), nowMs);
+        break;
+      }
+      _pairA = 0;
+      _pairB = 0;
+      // fallthrough
+    case Phase::PairGap:
+      if (_phase == Phase::PairGap && elapsed < OFF_GAP_MS) break;
+      if (nextPair()) {
+        energize((uint8_t)(relayBit((RelayIndex)_pairA) | relayBit((RelayIndex)_pairB)), nowMs);
+        _phase = Phase::PairSettle;
+      } else {
+        finish(false);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+void WiringDiag::noteOcpTrip(float loadA) {
+  if (running()) recordTrip(loadA);
+}
+
+// Only a single driven channel can be blamed; a trip anywhere else (baseline,
+// gaps, a pair that was fine alone) ends the run as aborted
+void WiringDiag::recordTrip(float loadA) {
+  if (_phase != Phase::Settle) { finish(true); return; }
+  WireChannelResult& r = _report.ch[_ch];
+  float peak = _peakA;
+  if (!isnan(loadA) && fabsf(loadA) > peak) peak = fabsf(loadA);
+  r.cls = WireClass::Short;
+  r.peakDeciA = toDeci(peak - _idleA);
+  finish(false);
+}
+
+void WiringDiag::start(uint32_t nowMs) {
+  Flasher::stop();
+  relaysUpdate(RELAY_MASK_OUTPUTS, 0);   // R_ENABLE stays with the RF-mode enforcement
+  _report = WiringReport{};
+  _reportReady = false;
+  for (uint8_t i = 0; i < WiringReport::CHANNELS; ++i) _settledA[i] = 0.0f;
+  _idleA = 0.0f;
+  _sumA = 0.0f;
+  _n = 0;
+  _idleV = 0.0f;
+  _sumV = 0.0f;
+  _nV = 0;
+  _ch = 0;
+  _phase = Phase::Baseline;
+  _phaseMs = nowMs;
+  Serial.println("[DIAG] Wiring diagnostic started");
+}
+
+void WiringDiag::finish(bool aborted) {
+  relaysUpdate(RELAY_MASK_OUTPUTS, 0);
+  _report.aborted = aborted;
+  _reportReady = true;
+  _phase = Phase::Idle;
+  Serial.printf("[DIAG] Wiring diagnostic %s\n", aborted ? "aborted" : "complete");
+  for (uint8_t i = 0; i < WiringReport::CHANNELS; ++i) {
+    const WireChannelResult& r = _report.ch[i];
+    Serial.printf("[DIAG]  %-6s %-6s %.1fA pk %.1fA drop %.2fV bulbs %u partner %d\n",
+                  relayName((RelayIndex)i), className(r.cls), r.settledDeciA / 10.0f,
+                  r.peakDeciA / 10.0f, r.dropCentiV / 100.0f, (unsigned)r.bulbs, (int)r.partner);
+  }
+}
+
+// Switch the outputs, then sample at sensor rate for INRUSH_MS to catch the
+// peak. The sampler ticks the protector, so a dead short still trips OCP here.
+void WiringDiag::energize(uint8_t mask, uint32_t nowMs) {
+  relaysUpdate(RELAY_MASK_OUTPUTS, mask);
+  _peakA = 0.0f;
+  const uint32_t t0 = millis();
+  while (_sample && (millis() - t0) < INRUSH_MS) {
+    float a = _sample();
+    if (!isnan(a) && fabsf(a) > _peakA) _peakA = fabsf(a);
+    if (protector.state().ocpLatched) break;
+  }
+  _sumA = 0.0f;
+  _n = 0;
+  _sumV = 0.0f;
+  _nV = 0;
+  _phase = Phase::Settle;
+  _phaseMs = nowMs;
+}
+
+void WiringDiag::classify(uint8_t ch) {
+  WireChannelResult& r = _report.ch[ch];
+  const float settled = _settledA[ch];
+  float peak = _peakA - _idleA;
+  if (peak < settled) peak = settled;
+  r.settledDeciA = toDeci(settled);
+  r.peakDeciA = toDeci(peak);
+  if (settled < OPEN_A) {
+    r.cls = WireClass::Open;
+  } else if (settled >= SHORT_A) {
+    r.cls = WireClass::Short;
+  } else if (peak >= settled * INCAND_RATIO) {
+    r.cls = WireClass::Incandescent;
+    long n = lroundf(settled / kBulbA[ch]);
+    r.bulbs = (uint8_t)(n < 1 ? 1 : (n > 9 ? 9 : n));
+  } else {
+    r.cls = WireClass::Led;
+  }
+}
+
+// Advance to the next pair of lit channels whose currents match closely enough
+// to be one shared load; false when every pair has been checked.
+bool WiringDiag::nextPair() {
+  for (;;) {
+    if (++_pairB >= WiringReport::CHANNELS) {
+      if (++_pairA >= WiringReport::CHANNELS - 1) return false;
+      _pairB = _pairA + 1;
+    }
+    const WireChannelResult& a = _report.ch[_pairA];
+    const WireChannelResult& b = _report.ch[_pairB];
+    if (!isLoad(a.cls) || !isLoad(b.cls)) continue;
+    const float hi = fmaxf(_settledA[_pairA], _settledA[_pairB]);
+    const float lo = fminf(_settledA[_pairA], _settledA[_pairB]);
+    if (hi - lo <= hi * PAIR_MATCH) return true;
+  }
+}
@@ -0,0 +1,98 @@
+// File Overview: Declares the automated trailer wiring diagnostic that energizes each
+// output channel in turn, captures inrush and settled current, and classifies the
+// load (open, short, LED, incandescent with bulb estimate, cross-wired).
+#pragma once
+#include <Arduino.h>
+#include "relays.hpp"
+
+enum class WireClass : uint8_t { NotRun = 0, Open, Short, Led, Incandescent, CrossWired };
+
+struct WireChannelResult {
+  WireClass cls = WireClass::NotRun;
+  uint8_t   settledDeciA = 0;   // steady current, idle draw removed
+  uint8_t   peakDeciA = 0;      // inrush peak in the first INRUSH_MS
+  uint8_t   bulbs = 0;          // incandescent bulb estimate (0 = n/a)
+  int8_t    partner = -1;       // cross-wired partner channel (-1 = none)
+  uint8_t   dropCentiV = 0;     // output voltage sag vs idle while settled
+};
+
+struct WiringReport {
+  static constexpr uint8_t CHANNELS = R_ENABLE;   // R_LEFT..R_AUX
+  WireChannelResult ch[CHANNELS];
+  bool aborted = false;
+};
+
+// Loop-driven state machine. Channel ON edges are followed by a short blocking
+// capture through a caller-supplied sampler that also ticks the protector, so
+// the inrush peak is seen at sensor rate and OCP stays live during the burst.
+class WiringDiag {
+public:
+  void begin(float (*sampleProtected)());
+
+  // Loop task. 'modeOk' is false outside RF mode / while the startup guard holds.
+  void service(float loadA, float outV, bool modeOk, uint32_t nowMs);
+
+  // Loop task, from the OCP fault path before its modal blocks: a trip while a
+  // single channel is driven is that channel's short (the latch is cleared by
+  // the time service() runs again). 'loadA' = reading that tripped, if known.
+  void noteOcpTrip(float loadA);
+
+  // Any task
+  void requestStart() { _reqStart = true; }
+  void requestStop()  { _reqStop = true; }   // also drops a pending start
+
+  // Loop task: a start is waiting for the next service()
+  bool startPending() const { return _reqStart; }
+
+  bool    running() const { return _phase != Phase::Idle; }
+  uint8_t currentChannel() const { return _ch; }
+
+  // Loop task: true once per finished run
+  bool takeReport(WiringReport& out);
+
+  static const char* className(WireClass c);
+
+private:
+  enum class Phase : uint8_t { Idle, Baseline, Settle, OffGap, PairSettle, PairGap };
+
+  void start(uint32_t nowMs);
+  void finish(bool aborted);
+  void recordTrip(float loadA);
+  void energize(uint8_t mask, uint32_t nowMs);
+  void classify(uint8_t ch);
+  bool nextPair();
+
+  float (*_sample)() = nullptr;
+
+  Phase    _phase = Phase::Idle;
+  uint32_t _phaseMs = 0;
+  uint8_t  _ch = 0;
+  uint8_t  _pairA = 0, _pairB = 0;
+  float    _idleA = 0.0f;
+  float    _peakA = 0.0f;
+  float    _sumA = 0.0f;
+  uint16_t _n = 0;
+  float    _idleV = 0.0f;
+  float    _sumV = 0.0f;
+  uint16_t _nV = 0;
+  float    _settledA[WiringReport::CHANNELS] = {};
+
+  WiringReport _report;
+  bool         _reportReady = false;
+
+  volatile bool _reqStart = false;
+  volatile bool _reqStop = false;
+
+  static constexpr uint32_t BASELINE_MS      = 400;   // outputs off, measure idle draw
+  static constexpr uint32_t INRUSH_MS        = 120;   // blocking capture after each ON edge
+  static constexpr uint32_t SETTLE_START_MS  = 400;   // filament/driver settled by now
+  static constexpr uint32_t SETTLE_END_MS    = 700;
+  static constexpr uint32_t OFF_GAP_MS       = 300;   // let filaments cool between channels
+  static constexpr float    OPEN_A           = 0.08f;
+  static constexpr float    SHORT_A          = 12.0f; // no trailer lamp set draws this on one pin
+  static constexpr float    INCAND_RATIO     = 2.5f;  // cold filament inrush / hot current
+  static constexpr float    PAIR_MATCH       = 0.15f; // similar enough to suspect one shared load
+  static constexpr float    PAIR_SHARED      = 1.3f;  // both-on current below this x single = same load
+};
+
+extern WiringDiag wiringDiag;
@@ -11,6 +11,9 @@
 #include "prefs.hpp"
 #include "relays.hpp"
 #include "rf/RF.hpp"
+#include "flasher.hpp"
+#include "relay_wear.hpp"
+#include "channel_map.hpp"
 
 #include <WiFi.h>
 #include <HTTPClient.h>
@@ -43,6 +46,11 @@ static const char* const kMenuItems[] = {
   "Wi-Fi Connect",
   "Wi-Fi Forget",
   "OTA Update",
+  "Turn Signal Flash",
+  "Wiring Diagnostics",
+  "Wiggle Test",
+  "Trailer Profiles",
+  "RF Response",
   "System Info"
 };
 static constexpr int MENU_COUNT = sizeof(kMenuItems) / sizeof(kMenuItems[0]);
@@ -55,6 +63,12 @@ static const char* const OTA_URL_KEY = "ota_url";
 // Local color for selection background (no ST77XX_DARKGREY in lib)
 static const uint16_t COLOR_DARKGREY = 0x4208; // 16-bit RGB565 approx dark gray
 
+// Load readout: block RMS when the sampler has a recent one (pulsed loads make
+// snapshots jump), else the per-pass reading
+static float shownLoadA(const Telemetry& t){
+  return !isnan(t.loadRmsA) ? t.loadRmsA : t.loadA;
+}
+
 // Relay labels (legacy helper)
 // (legacy helper removed; relay labels are handled contextually where needed)
 
@@ -115,12 +129,8 @@ static const char* rotaryLabel() {
     case -2: return "N/A";   // undefined or invalid
     case 0:  return "OFF";   // P1
     case 1:  return "RF";    // P2
-    case 2:  return "LEFT";  // P3
-    case 3:  return "RIGHT"; // P4
-    case 4:  return "BRAKE"; // P5 - BRAKE in both modes
-    case 5:  return "TAIL";  // P6
-    case 6:  return (getUiMode()==1? "REV" : "MARK");  // P7 - REV in RV mode
-    case 7:  return (getUiMode()==1? "Ele Brakes" : "AUX"); // P8 - Ele Brakes in RV mode
+    case 2: case 3: case 4: case 5: case 6: case 7:
+      return ChannelMap::slotLabel((uint8_t)(stableIdx - 2));  // P3..P8 per channel profile
     default: return "N/A";
   }
 }
@@ -145,16 +155,10 @@ static void getActiveRelayStatus(String& out){
     if (rfActive == -1) {
       out = "RF"; return;
     }
-    // RF has an active relay - display it with mode-aware naming
-    switch (rfActive) {
-      case R_LEFT:   out = "LEFT";  return;
-      case R_RIGHT:  out = "RIGHT"; return;
-      case R_BRAKE:  out = "BRAKE"; return;
-      case R_TAIL:   out = "TAIL";  return;
-      case R_MARKER: out = (getUiMode()==1? "REV" : "MARK");  return;
-      case R_AUX:    out = (getUiMode()==1? "Ele Brakes" : "AUX"); return;
-      default:       out = "RF"; return;
-    }
+    // RF has an active button - display it with the profile's naming
+    if (rfActive == RF::SLOT_HAZARD) out = "HAZARD";
+    else out = (rfActive < (int8_t)ChannelProfile::SLOTS) ? ChannelMap::slotLabel((uint8_t)rfActive) : "RF";
+    return;
   }
 
   out = rot;
@@ -183,7 +187,11 @@ DisplayUI::DisplayUI(const DisplayCtor& c)
   _setLvpBypass(c.setLvpBypass),
   _getStartupGuard(c.getStartupGuard),
   _bleStop(c.onBleStop),
-  _bleRestart(c.onBleRestart) {}
+  _bleRestart(c.onBleRestart),
+  _refineLvCut(c.refineLvCut),
+  _wiringDiag(c.onWiringDiag),
+  _wiggleToggle(c.onWiggleToggle),
+  _bleCmdLatency(c.getBleCmdLatency) {}
 
 void DisplayUI::attachTFT(Adafruit_ST7735* tft, int blPin){ _tft=tft; _blPin=blPin; }
 void DisplayUI::attachBrightnessSetter(std::function<void(uint8_t)> fn){ _setBrightness=fn; }
@@ -215,9 +223,6 @@ void DisplayUI::begin(Preferences& p){
   // Apply brightness at max (menu removed; keep at full by default)
   if (_setBrightness) _setBrightness(255);
 
-  // Load persisted UI mode (default HD)
-  _mode = _prefs->getUChar(KEY_UI_MODE, 0);
-
   // Splash (leave visible during boot - will be cleared by first screen draw)
   _tft->fillScreen(ST77XX_BLACK);
   _tft->setTextColor(ST77XX_CYAN, ST77XX_BLACK);
@@ -245,6 +250,15 @@ void DisplayUI::setFaultMask(uint32_t m){
   }
 }
 
+void DisplayUI::setBleedPair(int8_t onCh, int8_t intoCh){
+  if (onCh != _bleedA || intoCh != _bleedB){
+    _bleedA = onCh;
+    _bleedB = intoCh;
+    rebuildFaultText();
+    _needRedraw = true;
+  }
+}
+
 void DisplayUI::setActiveLabel(const char* label) {
   if (label && label[0] != '\0') {
     g_activeLabelOverride = label;
@@ -262,6 +276,13 @@ void DisplayUI::rebuildFaultText(){
   if (_faultMask & FLT_INA_LOAD_MISSING)  add("Load INA missing");
   if (_faultMask & FLT_INA_SRC_MISSING)   add("Src INA missing");
   if (_faultMask & FLT_RF_MISSING)        add("RF missing");
+  if ((_faultMask & FLT_CHANNEL_BLEED) && _bleedA >= 0 && _bleedB >= 0) {
+    String s = "Bleed ";
+    s += relayName((RelayIndex)_bleedA);
+    s += " > ";
+    s += relayName((RelayIndex)_bleedB);
+    add(s.c_str());
+  }
   if (_faultText.length()==0) _faultText = "Fault";
 }
 
@@ -367,13 +388,13 @@ void DisplayUI::showStatus(const Telemetry& t){
         _tft->setTextColor(ST77XX_WHITE, ST77XX_BLACK);
         _tft->setCursor(4, yMode);
         _tft->print("MODE: ");
-        _tft->print(_mode ? "RV" : "HD");
+        _tft->print(ChannelMap::tag());
       }
 
       // Line 2: Load (color-coded by amperage)
       _tft->setTextSize(2);
       _tft->setCursor(4, yLoad);
-      if (isnan(t.loadA)) {
+      if (isnan(shownLoadA(t))) {
         _tft->setTextColor(ST77XX_WHITE, ST77XX_BLACK);
         _tft->print("Load:  N/A");
       } else {
@@ -381,15 +402,16 @@ void DisplayUI::showStatus(const Telemetry& t){
         _tft->setTextColor(ST77XX_WHITE, ST77XX_BLACK);
         _tft->print("Load: ");
           // Choose value color: <15A green, 15–<20A yellow, >=20A red
-        float shownA = fabsf(t.loadA);
+        float shownA = fabsf(shownLoadA(t));
         if (shownA > 25.5f) shownA = 25.5f; // cap display at OCP max
         // Round to nearest tenth for stable display
         shownA = roundf(shownA * 10.0f) / 10.0f;
           uint16_t valColor = ST77XX_GREEN;            // <15A
           if (shownA >= 20.0f)      valColor = ST77XX_RED;     // >=20A up to 25.5A
           else if (shownA >= 15.0f) valColor = ST77XX_YELLOW;  // 15–<20A
+          if (t.revWarn)            valColor = ST77XX_ORANGE;  // back-feed: show sign
         _tft->setTextColor(valColor, ST77XX_BLACK);
-        _tft->printf("%4.1f A", shownA);
+        _tft->printf("%4.1f A", t.revWarn ? -shownA : shownA);
       }
 
       // Line 2: Active (auto size)
@@ -417,6 +439,7 @@ void DisplayUI::showStatus(const Telemetry& t){
       uint16_t lvpColor;
       if (bypass) { lvpColor = ST77XX_YELLOW; _tft->setTextColor(lvpColor, ST77XX_BLACK); _tft->print("Batt Volt: BYPASS"); }
       else if (t.lvpLatched) { lvpColor = ST77XX_RED; _tft->setTextColor(lvpColor, ST77XX_BLACK); _tft->print("Batt Volt: ACTIVE"); }
+      else if (t.lvpWarn) { lvpColor = ST77XX_ORANGE; _tft->setTextColor(lvpColor, ST77XX_BLACK); _tft->print("Batt Volt: LOW"); }
       else { lvpColor = ST77XX_GREEN; _tft->setTextColor(lvpColor, ST77XX_BLACK); _tft->print("Batt Volt: ok"); }
       // Append source voltage in same color
       _tft->print("  ");
@@ -488,36 +511,38 @@ void DisplayUI::showStatus(const Telemetry& t){
   // Load A changed?
   // MODE line diff (mode or focus changed)
   static uint8_t s_prevMode = 255;
-  if (s_prevMode != _mode) {
+  if (s_prevMode != ChannelMap::activeId()) {
     _tft->fillRect(0, yMode-2, W, hMode, ST77XX_BLACK);
     _tft->setTextSize(2);
     _tft->setTextColor(ST77XX_WHITE, ST77XX_BLACK);
     _tft->setCursor(4, yMode);
-    _tft->print("MODE: "); _tft->print(_mode?"RV":"HD");
-    s_prevMode = _mode;
+    _tft->print("MODE: "); _tft->print(ChannelMap::tag());
+    s_prevMode = ChannelMap::activeId();
   }
 
-  if ((isnan(t.loadA) != isnan(_last.loadA)) ||
-      (!isnan(t.loadA) && fabsf(t.loadA - _last.loadA) > 0.1f)) {
+  const float loadNow = shownLoadA(t), loadPrev = shownLoadA(_last);
+  if ((isnan(loadNow) != isnan(loadPrev)) || (t.revWarn != _last.revWarn) ||
+      (!isnan(loadNow) && fabsf(loadNow - loadPrev) > 0.1f)) {
     _tft->fillRect(0, yLoad-2, W, hLoad, ST77XX_BLACK);
     _tft->setTextSize(2);
     _tft->setCursor(4, yLoad);
-    if (isnan(t.loadA)) {
+    if (isnan(loadNow)) {
       _tft->setTextColor(ST77XX_WHITE, ST77XX_BLACK);
       _tft->print("Load:  N/A");
     } else {
       // Draw label in white then value in color
       _tft->setTextColor(ST77XX_WHITE, ST77XX_BLACK);
         _tft->print("Load: ");
-      float shownA = fabsf(t.loadA);
+      float shownA = fabsf(loadNow);
       if (shownA > 25.5f) shownA = 25.5f; // cap display at OCP max
       // Round to nearest tenth for stable display
       shownA = roundf(shownA * 10.0f) / 10.0f;
         uint16_t valColor = ST77XX_GREEN;            // <15A
         if (shownA >= 20.0f)      valColor = ST77XX_RED;     // >=20A up to 25.5A
         else if (shownA >= 15.0f) valColor = ST77XX_YELLOW;  // 15–<20A
+        if (t.revWarn)            valColor = ST77XX_ORANGE;  // back-feed: show sign
       _tft->setTextColor(valColor, ST77XX_BLACK);
-      _tft->printf("%4.1f A", shownA);
+      _tft->printf("%4.1f A", t.revWarn ? -shownA : shownA);
     }
   }
 
@@ -557,13 +582,15 @@ void DisplayUI::showStatus(const Telemetry& t){
   {
     static bool prevBypass = false;
     bool bypass = _getLvpBypass ? _getLvpBypass() : false;
-    if ((t.lvpLatched != _last.lvpLatched) || (bypass != prevBypass) || (t.srcV != _last.srcV)) {
+    if ((t.lvpLatched != _last.lvpLatched) || (t.lvpWarn != _last.lvpWarn) ||
+        (bypass != prevBypass) || (t.srcV != _last.srcV)) {
       _tft->fillRect(0, yLvp-2, W, hLvp, ST77XX_BLACK);
       _tft->setTextSize(1);
       _tft->setCursor(4, yLvp);
       uint16_t lvpColor;
       if (bypass) { lvpColor = ST77XX_YELLOW; _tft->setTextColor(lvpColor, ST77XX_BLACK); _tft->print("Batt Volt: BYPASS"); }
       else if (t.lvpLatched) { lvpColor = ST77XX_RED; _tft->setTextColor(lvpColor, ST77XX_BLACK); _tft->print("Batt Volt: ACTIVE"); }
+      else if (t.lvpWarn) { lvpColor = ST77XX_ORANGE; _tft->setTextColor(lvpColor, ST77XX_BLACK); _tft->print("Batt Volt: LOW"); }
       else { lvpColor = ST77XX_GREEN; _tft->setTextColor(lvpColor, ST77XX_BLACK); _tft->print("Batt Volt: ok"); }
       _tft->print("  ");
       if (!isnan(t.srcV)) { _tft->printf("%4.1fV", t.srcV); } else { _tft->print("N/A"); }
@@ -637,6 +664,7 @@ void DisplayUI::detectAndSetBatteryType(){
   
   // Determine battery type and appropriate LVP setting
   float lvpSetting = 0.0f;
+  float nominalV = 0.0f;
   String batteryType = "";
   String message = "";
   bool detected = false;
@@ -650,21 +678,25 @@ void DisplayUI::detectAndSetBatteryType(){
     // 12V battery detected (nominal range)
     batteryType = "12V";
     lvpSetting = 10.5f;
+    nominalV = 12.0f;
     detected = true;
   } else if (srcV >= 17.0f && srcV <= 22.0f) {
     // 18V battery detected (nominal range)
     batteryType = "18V";
     lvpSetting = 16.5f;
+    nominalV = 18.0f;
     detected = true;
   } else if (srcV > 22.0f) {
     // Higher voltage - assume 18V system with high charge
     batteryType = "18V";
     lvpSetting = 16.5f;
+    nominalV = 18.0f;
     detected = true;
   } else if (srcV >= 9.0f && srcV < 11.0f) {
     // Low voltage, likely 12V battery that's discharged
     batteryType = "12V (Low)";
     lvpSetting = 10.5f;
+    nominalV = 12.0f;
     detected = true;
   } else if (srcV >= 14.0f && srcV < 17.0f) {
     // Voltage in undefined range
@@ -679,6 +711,8 @@ void DisplayUI::detectAndSetBatteryType(){
   _tft->setTextSize(1);
   
   if (detected) {
+    // Compensate the table cutoff for the fitted battery resistance (if known)
+    if (_refineLvCut) lvpSetting = _refineLvCut(nominalV, lvpSetting);
     // Successfully detected - apply setting and show confirmation
     _lvChanged(lvpSetting);
     if (_prefs) {
@@ -887,6 +921,12 @@ void DisplayUI::tick(const Telemetry& t){
   bool ok   = _inMenu ? okPressed() : false;
   OkPressEvent okEvent = _inMenu ? OkPressEvent::None : pollHomeOkPress();
 
+  if (_rfLearnPage) {
+    tickRfLearn(d, ok, back);
+    wasInMenu = _inMenu;
+    return;
+  }
+
   if (_inMenu) {
     int total = _devMenuOnly ? DEV_MENU_COUNT : MENU_COUNT;
     if (d)   { _menuIdx = (( _menuIdx + d ) % total + total) % total; _needRedraw = true; }
@@ -927,13 +967,15 @@ void DisplayUI::tick(const Telemetry& t){
 
   bool changedHome =
       (!_inMenu) && (
-        (isnan(t.loadA) != isnan(_last.loadA)) ||
-        (!isnan(t.loadA) && fabsf(t.loadA - _last.loadA) > 0.02f) ||
+        (isnan(shownLoadA(t)) != isnan(shownLoadA(_last))) ||
+        (!isnan(shownLoadA(t)) && fabsf(shownLoadA(t) - shownLoadA(_last)) > 0.02f) ||
         (isnan(t.srcV) != isnan(_last.srcV)) ||
         (!isnan(t.srcV) && !isnan(_last.srcV) && fabsf(t.srcV - _last.srcV) > 0.05f) ||
         (isnan(t.outV) != isnan(_last.outV)) ||
         (!isnan(t.outV) && !isnan(_last.outV) && fabsf(t.outV - _last.outV) > 0.05f) ||
         (t.lvpLatched != _last.lvpLatched) ||
+        (t.lvpWarn != _last.lvpWarn) ||
+        (t.revWarn != _last.revWarn) ||
         (t.ocpLatched != _last.ocpLatched) ||
         (t.cooldownActive != _last.cooldownActive) ||
         (t.cooldownSecsRemaining != _last.cooldownSecsRemaining) ||
@@ -964,9 +1006,89 @@ void DisplayUI::tick(const Telemetry& t){
   }
 }
 
+// RF learn page: selection, start/cancel, and progress polled from RF each tick
+void DisplayUI::tickRfLearn(int8_t d, bool ok, bool back){
+  const RF::LearnStatus st = RF::learnStatus();
+
+  auto statusLine = [&](const char* l1, const char* l2){
+    _tft->fillRect(0,60,160,28,ST77XX_BLACK);
+    _tft->setCursor(6,60); _tft->print(l1);
+    if (l2) { _tft->setCursor(6,76); _tft->print(l2); }
+  };
+
+  // Entry, or repaint after a protection modal drew over the page
+  if (_needRedraw) {
+    _tft->fillScreen(ST77XX_BLACK);
+    _tft->setTextSize(1);
+    _tft->setTextColor(ST77XX_WHITE, ST77XX_BLACK);
+    _tft->setCursor(6,8);  _tft->print("Learn RF for:");
+    _tft->setCursor(6,44); _tft->print("OK=Start  BACK=Exit");
+    if (st.active) statusLine("Listening...", "BACK=Cancel");
+    _rfLastSel = -1;
+    _rfShownSecs = -1;
+    _needRedraw = false;
+  }
+
+  if (back) {
+    // First BACK stops listening, the next one leaves the page
+    if (st.active) { RF::learnCancel(); }
+    else {
+      _rfLearnPage = false;
+      _ignoreMenuBack = true;
+      _needRedraw = true;
+      _tft->fillScreen(ST77XX_BLACK);
+      return;
+    }
+  }
+
+  if (!st.active) {
+    if (d) _rfSel = ((_rfSel + d) % RF::SLOT_COUNT + RF::SLOT_COUNT) % RF::SLOT_COUNT;
+    if (ok && _rfLearn && _rfLearn(_rfSel)) {
+      _rfShownSecs = -1;
+      statusLine("Listening...", "BACK=Cancel");
+    }
+  }
+  if (_rfSel != _rfLastSel) {
+    _tft->fillRect(0,20,160,16,ST77XX_BLACK);
+    _tft->setCursor(6,24);
+    if (_rfSel == RF::SLOT_SEQUENCE) _tft->print("TEST SEQUENCE");
+    else if (_rfSel == RF::SLOT_HAZARD) _tft->print("HAZARD");
+    else _tft->print(ChannelMap::slotLabel((uint8_t)_rfSel));
+    _rfLastSel = _rfSel;
+  }
+
+  for (RF::LearnEvent e; (e = RF::pollLearnEvent()) != RF::LearnEvent::None; ) {
+    switch (e) {
+      case RF::LearnEvent::Heard:     statusLine("Heard - press again", "BACK=Cancel"); break;
+      case RF::LearnEvent::Mismatch:  statusLine("Different code -", "press again"); break;
+      case RF::LearnEvent::Saved: {
+        char l1[24];
+        snprintf(l1, sizeof(l1), "Saved (%u on button)", RF::remoteCount(_rfSel));
+        statusLine(l1, "OK=Learn  BACK=Exit");
+      } break;
+      case RF::LearnEvent::TableFull: statusLine("Memory full -", "clear RF remotes"); break;
+      case RF::LearnEvent::TimedOut:  statusLine("Failed (timeout)", "OK=Learn  BACK=Exit"); break;
+      case RF::LearnEvent::Cancelled: statusLine("Cancelled", "OK=Learn  BACK=Exit"); break;
+      default: break;
+    }
+  }
+
+  // Countdown while listening (redrawn once per second)
+  if (st.active) {
+    int secs = (int)((st.msLeft + 999) / 1000);
+    if (secs != _rfShownSecs) {
+      _tft->fillRect(120,8,40,10,ST77XX_BLACK);
+      _tft->setCursor(130,8); _tft->printf("%ds", secs);
+      _rfShownSecs = secs;
+    }
+  } else if (_rfShownSecs >= 0) {
+    _tft->fillRect(120,8,40,10,ST77XX_BLACK);
+    _rfShownSecs = -1;
+  }
+}
+
 // Persist and toggle mode helpers
-void DisplayUI::saveMode(uint8_t m){ if (_prefs) _prefs->putUChar(KEY_UI_MODE, m); }
-void DisplayUI::toggleMode(){ _mode = (_mode==0)?1:0; saveMode(_mode); }
+void DisplayUI::toggleMode(){ ChannelMap::selectNext(); }
 void DisplayUI::saveOutvCut(float v){ if (_prefs) _prefs->putFloat(KEY_OUTV_CUTOFF, v); }
 
 void DisplayUI::setDevMenuOnly(bool on){
@@ -1035,69 +1157,11 @@ bool DisplayUI::handleMenuSelect(int idx){
       }
       g_forceHomeFull = true;
     } break;
-  case 6: {                                               // Learn RF Button
-      // RF Learn (simple modal)
-      int sel = 0, lastSel = -1;
-      _tft->fillScreen(ST77XX_BLACK);
-      _tft->setTextSize(1);
-      _tft->setCursor(6,8);  _tft->print("Learn RF for:");
-      _tft->setCursor(6,44); _tft->print("OK=Start  BACK=Exit");
-
-      auto drawSel = [&](int s){
-        _tft->fillRect(0,20,160,16,ST77XX_BLACK);
-        _tft->setCursor(6,24);
-        if (s==3) {
-          _tft->print("TAIL");
-        } else if (s==4) {
-          _tft->print(getUiMode()==1?"REV":"MARKER");
-        } else if (s==5) {
-          _tft->print(getUiMode()==1?"Ele Brakes":"AUX");
-        } else {
-          _tft->print(s==0?"LEFT":s==1?"RIGHT":s==2?"BRAKE":"?");
-        }
-      };
-
-      drawSel(sel);
-
-      // Loop until user presses BACK; allow multiple learns without exiting the menu.
-      bool exitRF = false;
-      while(!exitRF){
-        int8_t dd = readStep();
-        if (dd) {
-          sel = ((sel + dd) % 6 + 6) % 6;
-        }
-        if (sel != lastSel) { drawSel(sel); lastSel = sel; }
-
-        if (okPressed()) {
-          // Start listening / learning
-          _tft->fillRect(0,60,160,14,ST77XX_BLACK);
-          _tft->setCursor(6,60); _tft->print("Listening...");
-          bool ok = _rfLearn ? _rfLearn(sel) : false;
-
-          // Show brief result and allow encoder changes while visible.
-          _tft->fillRect(0,60,160,28,ST77XX_BLACK);
-          _tft->setCursor(6,60); _tft->print(ok ? "Saved" : "Failed");
-          _tft->setCursor(6,76); _tft->print("OK=Learn  BACK=Exit");
-
-          uint32_t shownAt = millis();
-          // brief window where encoder/back/ok are polled so user can change selection or immediately re-learn
-          while (millis() - shownAt < 800) {
-            int8_t dd2 = readStep();
-            if (dd2) {
-              sel = ((sel + dd2) % 6 + 6) % 6;
-            }
-            if (sel != lastSel) { drawSel(sel); lastSel = sel; }
-            if (backPressed()) { exitRF = true; break; }
-            if (okPressed()) { break; } // immediate re-learn of current selection
-            delay(12);
-          }
-          // continue outer loop (either to re-learn, change selection, or exit if BACK pressed)
-        }
-
-        if (backPressed()) break;
-        delay(12);
-      }
-    } break;
+  case 6:                                                 // Learn RF Button
+      // Non-modal: tick() drives the page so the loop keeps running while pairing
+      _rfLearnPage = true;
+      _rfSel = 0;
+      break;
   case 7: {                                               // Clear RF Remotes
       // Clear RF Remotes (confirmation)
       _tft->fillScreen(ST77XX_BLACK);
@@ -1115,7 +1179,37 @@ bool DisplayUI::handleMenuSelect(int idx){
   case 8: wifiScanAndConnectUI(); break;                  // Wi-Fi Connect
   case 9: wifiForget(); break;                            // Wi-Fi Forget
   case 10: runOta(); break;                               // OTA Update
-  case 11: showSystemInfo(); break;                       // System Info
+  case 11: adjustFlasher(); break;                        // Turn Signal Flash
+  case 12: {                                              // Wiring Diagnostics
+      // Runs from the loop; go Home so the "DIAG n/6" label shows progress
+      if (_wiringDiag && _wiringDiag()) { stayInMenu = false; g_forceHomeFull = true; break; }
+      _tft->fillScreen(ST77XX_BLACK);
+      _tft->setTextSize(1);
+      _tft->setCursor(6,10); _tft->println("Wiring Diagnostics");
+      _tft->setCursor(6,28); _tft->println("Set rotary to RF (P2)");
+      _tft->setCursor(6,40); _tft->println("and clear any faults.");
+      delay(1200);
+      g_forceHomeFull = true;
+    } break;
+  case 13: {                                              // Wiggle Test
+      if (!_wiggleToggle) break;
+      bool on = _wiggleToggle();
+      _tft->fillScreen(ST77XX_BLACK);
+      _tft->setTextSize(1);
+      _tft->setCursor(6,10); _tft->println("Wiggle Test");
+      _tft->setCursor(6,28); _tft->println(on ? "ON: turn a channel on," : "OFF");
+      if (on) {
+        _tft->setCursor(6,40); _tft->println("then flex the harness.");
+        _tft->setCursor(6,52); _tft->println("Each dropout beeps.");
+      }
+      delay(1200);
+      // Home shows the running count in the mode label
+      if (on) stayInMenu = false;
+      g_forceHomeFull = true;
+    } break;
+  case 14: showTrailerProfiles(); break;                  // Trailer Profiles
+  case 15: adjustRfResponse(); break;                     // RF Response
+  case 16: showSystemInfo(); break;                       // System Info
   }
   return stayInMenu;
 }
@@ -1167,6 +1261,76 @@ void DisplayUI::adjustOutputVCutoff(){
   }
 }
 
+// --- Turn signal flasher: LEFT/RIGHT flash option, rate (FPM), ON duty (%) ---
+// Encoder edits the highlighted field, OK moves to the next (saves after the last).
+void DisplayUI::adjustFlasher(){
+  _tft->setTextSize(1);
+  bool on = Flasher::turnSignalsFlash();
+  int fpm = Flasher::fpm();
+  int duty = Flasher::dutyPct();
+  int field = 0;
+  _tft->fillScreen(ST77XX_BLACK); _tft->setCursor(6,10); _tft->println("Turn Signal Flash");
+  _tft->setCursor(6,76); _tft->print("OK=Next  BACK=Cancel");
+  auto draw = [&](){
+    const int y[3] = {28, 40, 52};
+    for (int i = 0; i < 3; ++i) {
+      uint16_t bg = (i == field) ? ST77XX_BLUE : ST77XX_BLACK;
+      _tft->fillRect(0, y[i]-2, 160, 12, bg);
+      _tft->setTextColor(ST77XX_WHITE, bg);
+      _tft->setCursor(6, y[i]);
+      if (i == 0)      _tft->printf("L/R flash: %s", on ? "ON" : "OFF");
+      else if (i == 1) _tft->printf("Rate: %3d FPM", fpm);
+      else             _tft->printf("Duty: %2d %%", duty);
+    }
+    _tft->setTextColor(ST77XX_WHITE, ST77XX_BLACK);
+  };
+  draw();
+  while(true){
+    int8_t d=readStep();
+    if(d){
+      if (field == 0) on = !on;
+      else if (field == 1) { fpm += d*5; if(fpm<Flasher::FPM_MIN)fpm=Flasher::FPM_MIN; if(fpm>Flasher::FPM_MAX)fpm=Flasher::FPM_MAX; }
+      else { duty += d*5; if(duty<Flasher::DUTY_MIN)duty=Flasher::DUTY_MIN; if(duty>Flasher::DUTY_MAX)duty=Flasher::DUTY_MAX; }
+      draw();
+    }
+    if(okPressed()){
+      if (++field < 3) { draw(); continue; }
+      Flasher::setTurnSignalsFlash(on);
+      Flasher::setRate((uint8_t)fpm, (uint8_t)duty);
+      break;
+    }
+    if(backPressed()) break;
+    delay(8);
+  }
+  g_forceHomeFull = true;
+}
+
+// --- RF response: end of burst (default) or fire on the first N exact frames ---
+void DisplayUI::adjustRfResponse(){
+  _tft->setTextSize(1);
+  int n = RF::fastConfirm();
+  _tft->fillScreen(ST77XX_BLACK); _tft->setCursor(6,10); _tft->println("RF Response");
+  _tft->setCursor(6,64); _tft->print("Fast reacts on press,");
+  _tft->setCursor(6,76); _tft->print("Normal on release");
+  auto draw = [&](){
+    _tft->fillRect(6,28,148,24,ST77XX_BLACK);
+    _tft->setCursor(6,28);
+    if (n == 0) _tft->print("Normal (~0.5 s)");
+    else        _tft->printf("Fast: %d exact frame%s", n, n > 1 ? "s" : "");
+    _tft->setCursor(6,40);
+    _tft->print(n == 1 ? "fastest" : (n > 1 ? "noisy sites" : "most robust"));
+  };
+  draw();
+  while(true){
+    int8_t d=readStep();
+    if(d){ n += d; if(n<0)n=0; if(n>RF::FAST_CONFIRM_MAX)n=RF::FAST_CONFIRM_MAX; draw(); }
+    if(okPressed()){ RF::setFastConfirm((uint8_t)n); break; }
+    if(backPressed()) break;
+    delay(8);
+  }
+  g_forceHomeFull = true;
+}
+
 // ---------- Instant, non-blocking LVP bypass toggle ----------
 void DisplayUI::toggleLvpBypass(){
   bool on = _getLvpBypass ? _getLvpBypass() : false;
@@ -1229,6 +1393,113 @@ bool DisplayUI::protectionAlarm(const char* title, const char* line1, const char
   }
 }
 
+// ================================================================
+// Wiring diagnostic report
+// ================================================================
+void DisplayUI::showWiringReport(const WiringReport& r, const TrailerDrift* drift){
+  _tft->fillScreen(ST77XX_BLACK);
+  _tft->setTextSize(1);
+  _tft->setTextColor(ST77XX_CYAN, ST77XX_BLACK);
+  _tft->setCursor(6, 4); _tft->print(r.aborted ? "Wiring Report (ABORTED)" : "Wiring Report");
+
+  for (uint8_t i = 0; i < WiringReport::CHANNELS; ++i) {
+    const WireChannelResult& c = r.ch[i];
+    const int y = 20 + i * 14;
+    uint16_t col = ST77XX_WHITE;
+    char what[16];
+    switch (c.cls) {
+      case WireClass::Open:         col = ST77XX_YELLOW; snprintf(what, sizeof(what), "OPEN"); break;
+      case WireClass::Short:        col = ST77XX_RED;    snprintf(what, sizeof(what), "SHORT"); break;
+      case WireClass::Led:          col = ST77XX_GREEN;  snprintf(what, sizeof(what), "LED"); break;
+      case WireClass::Incandescent: col = ST77XX_GREEN;  snprintf(what, sizeof(what), "BULB x%u", (unsigned)c.bulbs); break;
+      case WireClass::CrossWired:
+        col = ST77XX_RED;
+        snprintf(what, sizeof(what), "X %s", c.partner >= 0 ? relayName((RelayIndex)c.partner) : "?");
+        break;
+      default:                      col = COLOR_DARKGREY; snprintf(what, sizeof(what), "--"); break;
+    }
+    _tft->setTextColor(ST77XX_WHITE, ST77XX_BLACK);
+    _tft->setCursor(6, y);  _tft->print(relayName((RelayIndex)i));
+    _tft->setTextColor(col, ST77XX_BLACK);
+    _tft->setCursor(56, y); _tft->print(what);
+    if (c.cls != WireClass::NotRun && c.cls != WireClass::Open) {
+      _tft->setTextColor(ST77XX_WHITE, ST77XX_BLACK);
+      _tft->setCursor(118, y); _tft->printf("%4.1fA", c.settledDeciA / 10.0f);
+    }
+    if (drift && drift->flags[i]) {
+      _tft->setTextColor(ST77XX_ORANGE, ST77XX_BLACK);
+      _tft->setCursor(152, y); _tft->print("!");
+    }
+  }
+
+  if (drift) {
+    _tft->setCursor(6, 100);
+    if (drift->driftedMask) {
+      _tft->setTextColor(ST77XX_ORANGE, ST77XX_BLACK);
+      _tft->printf("Drift vs %.15s", drift->name);
+    } else {
+      _tft->setTextColor(ST77XX_GREEN, ST77XX_BLACK);
+      _tft->printf("Matches %.16s", drift->name);
+    }
+  }
+
+  _tft->setTextColor(ST77XX_YELLOW, ST77XX_BLACK);
+  _tft->setCursor(6, 112); _tft->print("OK=Close");
+  _tft->setTextColor(ST77XX_WHITE, ST77XX_BLACK);
+
+  while (true) {
+    if (okPressed() || backPressed()) break;
+    delay(10);
+  }
+  g_forceHomeFull = true;
+  _needRedraw = true;
+}
+
+// Trailer baselines: the knob scrolls the name-ordered index (one record read
+// per visible row). OK on a trailer makes it the comparison baseline for the
+// next wiring diagnostic (OK on the active one clears it); the first row saves
+// the last finished diagnostic under a typed name.
+void DisplayUI::showTrailerProfiles(){
+  static char row[TrailerProfile::NAME_LEN + 2];
+  auto get = [&](int i) -> const char* {
+    if (i == 0) return "+ Save last test";
+    TrailerProfile p;
+    if (!trailerStore.at((uint16_t)(i - 1), p)) return "?";
+    const bool act = trailerStore.hasActive() && strcmp(trailerStore.active().name, p.name) == 0;
+    snprintf(row, sizeof(row), "%c%s", act ? '*' : ' ', p.name);
+    return row;
+  };
+  int pick = listPickerDynamic("Trailer Profiles", get, trailerStore.count() + 1, 0);
+  if (pick < 0) return;
+
+  char msg[40];
+  if (pick == 0) {
+    if (!trailerStore.hasLastReport()) {
+      snprintf(msg, sizeof(msg), "Run Wiring Diag first");
+    } else {
+      String name = textInput("Trailer name", "", TrailerProfile::NAME_LEN - 1, "abc/ABC/123/sym  OK=sel  BACK=del");
+      snprintf(msg, sizeof(msg), "%s", trailerStore.saveLast(name.c_str()) ? "Saved" : "Not saved");
+    }
+  } else {
+    TrailerProfile p;
+    if (!trailerStore.at((uint16_t)(pick - 1), p)) return;
+    if (trailerStore.hasActive() && strcmp(trailerStore.active().name, p.name) == 0) {
+      trailerStore.setActive(nullptr);
+      snprintf(msg, sizeof(msg), "Baseline cleared");
+    } else {
+      trailerStore.setActive(p.name);
+      snprintf(msg, sizeof(msg), "Active: %s", p.name);
+    }
+  }
+  _tft->fillScreen(ST77XX_BLACK);
+  _tft->setTextSize(1);
+  _tft->setTextColor(ST77XX_WHITE, ST77XX_BLACK);
+  _tft->setCursor(6,10); _tft->println("Trailer Profiles");
+  _tft->setCursor(6,28); _tft->println(msg);
+  delay(900);
+  g_forceHomeFull = true;
+}
+
 // ================================================================
 // Wi-Fi + OTA
 // ================================================================
@@ -1532,6 +1803,7 @@ void DisplayUI::wifiForget(){
 
 // OTA
 void DisplayUI::runOta(){
+  if (_otaStart) _otaStart();
   // Stop BLE advertising to prevent radio conflicts during WiFi/OTA operations
   if (_bleStop) _bleStop();
   
@@ -1631,6 +1903,42 @@ void DisplayUI::showSystemInfo(){
   bool bypass = _getLvpBypass ? _getLvpBypass() : false;
   line("LVP bypass", bypass ? "ON" : "OFF");
 
+  // Battery health from the internal-resistance estimator
+  {
+    char buf[28];
+    if (_last.battSohPct <= 100) snprintf(buf, sizeof(buf), "%u%% (%u mOhm)", _last.battSohPct, _last.battRintMilliOhm);
+    else                         snprintf(buf, sizeof(buf), "learning");
+    line("Batt SOH", buf);
+  }
+
+  // RF receiver: noise-monitor quality figure and the tolerance it chose
+  {
+    char buf[28];
+    RF::SignalQuality q = RF::signalQuality();
+    snprintf(buf, sizeof(buf), "%u%% (tol %u%%)", q.percent, q.tolerancePct);
+    line("RF signal", buf);
+  }
+
+  // App commands: BLE task enqueue -> loop apply
+  {
+    char buf[28];
+    uint32_t avgUs = 0, maxUs = 0;
+    if (_bleCmdLatency && _bleCmdLatency(avgUs, maxUs)) {
+      snprintf(buf, sizeof(buf), "%.1f ms (max %.1f)", avgUs / 1000.0f, maxUs / 1000.0f);
+    } else {
+      snprintf(buf, sizeof(buf), "no commands yet");
+    }
+    line("BLE cmd", buf);
+  }
+
+  // Relay wear: most-worn contact; OK opens the per-relay page
+  {
+    char buf[28];
+    RelayIndex w = RelayWear::worst();
+    snprintf(buf, sizeof(buf), "%s %.1f%% used", relayName(w), RelayWear::channel(w).usedPct);
+    line("Relay wear", buf);
+  }
+
   if (_faultMask==0) line("Faults", "None");
   else {
     if (_faultMask & FLT_INA_LOAD_MISSING)  line("Load INA226", "MISSING (0x40)");
@@ -1640,8 +1948,36 @@ void DisplayUI::showSystemInfo(){
   }
 
   _tft->setTextColor(ST77XX_YELLOW);
-  _tft->setCursor(4, y+4);
-  _tft->println("BACK=Exit");
+  _tft->setCursor(4, y+4 < 120 ? y+4 : 120);
+  _tft->println("BACK=Exit  OK=Relays");
+  while(!backPressed()){
+    if (okPressed()) { showRelayWear(); return; }
+    delay(10);
+  }
+  g_forceHomeFull = true;
+}
+
+// Per-relay cycles, life used and projected cycles left
+void DisplayUI::showRelayWear(){
+  _tft->fillScreen(ST77XX_BLACK);
+  _tft->setTextSize(1);
+  _tft->setCursor(4, 6);  _tft->setTextColor(ST77XX_CYAN); _tft->println("Relay Wear");
+  _tft->setTextColor(COLOR_DARKGREY);
+  _tft->setCursor(4, 18); _tft->print("relay  cycles  used   left");
+  for (int i = 0; i < (int)R_COUNT; ++i) {
+    RelayWear::Channel c = RelayWear::channel((RelayIndex)i);
+    const int y = 30 + i * 11;
+    _tft->setTextColor(c.usedPct >= 80.0f ? ST77XX_RED : (c.usedPct >= 50.0f ? ST77XX_YELLOW : ST77XX_WHITE));
+    char left[8];
+    if (c.remainingCycles >= 1000000) snprintf(left, sizeof(left), "%luM", (unsigned long)(c.remainingCycles / 1000000));
+    else if (c.remainingCycles >= 1000) snprintf(left, sizeof(left), "%luk", (unsigned long)(c.remainingCycles / 1000));
+    else snprintf(left, sizeof(left), "%lu", (unsigned long)c.remainingCycles);
+    _tft->setCursor(4, y);
+    _tft->printf("%-6s %6lu %4.1f%% %5s", relayName((RelayIndex)i), (unsigned long)c.cycles, c.usedPct, left);
+  }
+  _tft->setTextColor(ST77XX_YELLOW);
+  _tft->setCursor(4, 112); _tft->print("BACK=Exit");
+  _tft->setTextColor(ST77XX_WHITE);
   while(!backPressed()){ delay(10); }
   g_forceHomeFull = true;
 }
@@ -6,6 +6,8 @@
 #include <Preferences.h>
 #include <Adafruit_ST7735.h>
 #include "telemetry.hpp"
+#include "diag/WiringDiag.hpp"
+#include "storage/TrailerStore.hpp"
 
 struct DisplayPins { int CS, DC, RST, BL; };
 
@@ -24,7 +26,7 @@ struct DisplayCtor {
   std::function<void(float)> onOutvChanged;   // Output V cutoff changed
   std::function<bool()>      getOutvBypass;   // OUTV bypass getter
   std::function<void(bool)>  setOutvBypass;   // OUTV bypass setter
-  std::function<bool(int)>   onRfLearn;
+  std::function<bool(int)>   onRfLearn;        // start learning a slot (progress is polled from RF)
 
   // NEW: LVP bypass accessors provided by main/protector
   std::function<bool()>      getLvpBypass;
@@ -36,6 +38,18 @@ struct DisplayCtor {
   // BLE control for WiFi coexistence
   std::function<void()>      onBleStop;
   std::function<void()>      onBleRestart;
+
+  // Battery model: refine an auto-detected LVP cutoff (nominal V, table cutoff) -> cutoff
+  std::function<float(float, float)> refineLvCut;
+
+  // Wiring diagnostics: request a run (false = not allowed right now)
+  std::function<bool()>      onWiringDiag;
+
+  // Wiggle test: toggle the harness flicker detector, returns the new state
+  std::function<bool()>      onWiggleToggle;
+
+  // BLE command queue: enqueue-to-apply latency (avg, max us); false = no commands yet
+  std::function<bool(uint32_t&, uint32_t&)> getBleCmdLatency;
 };
 
 enum FaultBits : uint32_t {
@@ -44,6 +58,7 @@ enum FaultBits : uint32_t {
   FLT_INA_SRC_MISSING   = 1u << 1,
   FLT_WIFI_DISCONNECTED = 1u << 2,
   FLT_RF_MISSING        = 1u << 3,
+  FLT_CHANNEL_BLEED     = 1u << 4,   // current of an OFF channel seen with another ON
 };
 
 class DisplayUI {
@@ -61,19 +76,22 @@ public:
 
   void showStatus(const Telemetry& t);
   void setFaultMask(uint32_t m);
+  void setBleedPair(int8_t onCh, int8_t intoCh);  // names shown with FLT_CHANNEL_BLEED
   void setActiveLabel(const char* label); // Override active relay display (for BLE control)
 
   // OCP modal
   bool protectionAlarm(const char* title, const char* line1, const char* line2 = nullptr);
 
+  // Wiring diagnostic report (one screen, OK/BACK closes); 'drift' marks the
+  // channels that moved away from the active trailer's stored baseline
+  void showWiringReport(const WiringReport& r, const TrailerDrift* drift = nullptr);
+
   // Dev boot: restrict menu to Wi‑Fi and OTA only and keep UI in menu
   void setDevMenuOnly(bool on);
   void enterMenu(int startIdx = 0);
   bool menuActive() const { return _inMenu; }
 
-  // Optional: expose mode getters/setters if other modules need it later
-  enum UIMode : uint8_t { MODE_HD = 0, MODE_RV = 1 };
-  UIMode mode() const { return (UIMode)_mode; }
+  // Mode = channel mapping profile (see ChannelMap); short OK press cycles it
   void   toggleMode();
   // Force next Home draw to be a full-screen repaint (after blocking modals)
   void   requestFullHomeRepaint();
@@ -93,18 +111,21 @@ private:
   void adjustOcpLimit();
   void adjustOutputVCutoff();
   void toggleOutvBypass();          // NEW: Output V bypass toggle
+  void adjustFlasher();             // LEFT/RIGHT flash option, rate and duty
+  void adjustRfResponse();          // RF fast response: exact frames needed, or off
   void toggleLvpBypass();          // NEW
   void wifiScanAndConnectUI();
   void wifiForget();
   void runOta();
   void showSystemInfo();
+  void showRelayWear();
+  void showTrailerProfiles();
 
   // small helpers
   enum class OkPressEvent { None, Short, Long };
   OkPressEvent pollHomeOkPress();
   int8_t readStep(); bool okPressed(); bool backPressed();
   void   saveLvCut(float v);
-  void   saveMode(uint8_t m);
   void   saveOutvCut(float v);
 
   // fault banner (scrolling)
@@ -132,6 +153,10 @@ private:
   std::function<bool()> _getStartupGuard;
   std::function<void()> _bleStop;
   std::function<void()> _bleRestart;
+  std::function<float(float, float)> _refineLvCut;
+  std::function<bool()> _wiringDiag;
+  std::function<bool()> _wiggleToggle;
+  std::function<bool(uint32_t&, uint32_t&)> _bleCmdLatency;
 
   Preferences* _prefs=nullptr;
 
@@ -144,6 +169,7 @@ private:
   uint32_t _lastMs=0; bool _needRedraw=true; Telemetry _last{};
   int _menuIdx=0; int _prevMenuIdx=-1;
   uint32_t _faultMask = 0;
+  int8_t   _bleedA = -1, _bleedB = -1;
 
   // fault ticker state
   String _faultText;
@@ -155,11 +181,16 @@ private:
   uint32_t _lastOkMs = 0;
 
   // Home interactions
-  uint8_t _mode = 0;          // 0=HD, 1=RV (persisted)
   bool     _okHolding = false;
   bool     _okHoldLong = false;
   uint32_t _okDownMs = 0;
 
   // Dev-boot menu restriction
   bool _devMenuOnly = false;
+
+  // RF learn page (driven from tick, not a modal loop)
+  void tickRfLearn(int8_t d, bool ok, bool back);
+  bool _rfLearnPage = false;
+  int  _rfSel = 0, _rfLastSel = -1;
+  int  _rfShownSecs = -1;
 };
@@ -0,0 +1,137 @@
+// File Overview: Implements the esp_timer flasher: absolute-deadline ON/OFF scheduling,
+// ownership of the flashed relay channels, and persisted rate/duty settings.
+#include "flasher.hpp"
+#include "esp_timer.h"
+#include "prefs.hpp"
+#include "power/Protector.hpp"
+
+namespace {
+  portMUX_TYPE       g_mux = portMUX_INITIALIZER_UNLOCKED;
+  esp_timer_handle_t g_timer = nullptr;
+  Preferences*       g_prefs = nullptr;
+
+  volatile uint8_t g_mask = 0;       // flashed channels (0 = idle)
+  bool     g_lit = false;
+  int64_t  g_litSinceUs = 0;
+  int64_t  g_nextUs = 0;             // deadline of the next edge
+  uint8_t  g_fpm = Flasher::FPM_DEFAULT;
+  uint8_t  g_duty = Flasher::DUTY_DEFAULT;
+  bool     g_turnFlash = false;
+
+  inline int64_t onUs()  { return (60000000LL / g_fpm) * g_duty / 100; }
+  inline int64_t offUs() { return (60000000LL / g_fpm) - onUs(); }
+
+  void onTimer(void*) {
+    const int64_t nowUs = esp_timer_get_time();
+    int64_t next = 0;
+    // A latched fault releases the outputs here too; the loop may be parked in a fault modal
+    ProtectionState ps;
+    bool fault = protector.tryState(ps) && ps.anyLatched();
+    portENTER_CRITICAL(&g_mux);
+    if (g_mask && fault) {
+      relaysUpdate(g_mask, 0);
+      g_mask = 0;
+      g_lit = false;
+    } else if (g_mask) {
+      g_lit = !g_lit;
+      // Chain from the previous deadline; resync only if we fell a whole phase behind
+      int64_t edge = (nowUs - g_nextUs > offUs()) ? nowUs : g_nextUs;
+      if (g_lit) g_litSinceUs = edge;
+      g_nextUs = edge + (g_lit ? onUs() : offUs());
+      relaysUpdate(g_mask, g_lit ? g_mask : 0);
+      next = g_nextUs;
+    }
+    portEXIT_CRITICAL(&g_mux);
+    if (next) {
+      int64_t delayUs = next - esp_timer_get_time();
+      esp_timer_start_once(g_timer, (uint64_t)(delayUs > 50 ? delayUs : 50));
+    }
+  }
+}
+
+namespace Flasher {
+
+void begin(Preferences* prefs){
+  g_prefs = prefs;
+  if (g_prefs) {
+    g_fpm = g_prefs->getUChar(KEY_FLASH_FPM, FPM_DEFAULT);
+    g_duty = g_prefs->getUChar(KEY_FLASH_DUTY, DUTY_DEFAULT);
+    g_turnFlash = g_prefs->getBool(KEY_FLASH_TURN, false);
+  }
+  if (g_fpm < FPM_MIN || g_fpm > FPM_MAX) g_fpm = FPM_DEFAULT;
+  if (g_duty < DUTY_MIN || g_duty > DUTY_MAX) g_duty = DUTY_DEFAULT;
+  if (!g_timer) {
+    esp_timer_create_args_t args = {};
+    args.callback = &onTimer;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "flasher";
+    if (esp_timer_create(&args, &g_timer) != ESP_OK) {
+      g_timer = nullptr;
+      Serial.println("[FLASH] esp_timer_create failed");
+    }
+  }
+}
+
+void start(uint8_t mask){
+  mask &= RELAY_MASK_OUTPUTS;
+  if (!mask) { stop(); return; }
+  if (!g_timer || mask == g_mask) return;
+  esp_timer_stop(g_timer);
+  const int64_t nowUs = esp_timer_get_time();
+  portENTER_CRITICAL(&g_mux);
+  uint8_t prev = g_mask;
+  g_mask = mask;
+  g_lit = true;
+  g_litSinceUs = nowUs;
+  g_nextUs = nowUs + onUs();
+  relaysUpdate(prev | mask, mask);    // drop channels no longer flashed, light the new set
+  portEXIT_CRITICAL(&g_mux);
+  esp_timer_start_once(g_timer, (uint64_t)onUs());
+}
+
+void stop(){
+  if (!g_mask) return;
+  if (g_timer) esp_timer_stop(g_timer);
+  portENTER_CRITICAL(&g_mux);
+  relaysUpdate(g_mask, 0);
+  g_mask = 0;
+  g_lit = false;
+  portEXIT_CRITICAL(&g_mux);
+}
+
+uint8_t activeMask(){ return g_mask; }
+bool    isLit(){ return g_mask && g_lit; }
+
+int64_t litSinceUs(){
+  portENTER_CRITICAL(&g_mux);
+  int64_t t = g_litSinceUs;
+  portEXIT_CRITICAL(&g_mux);
+  return t;
+}
+
+void setRate(uint8_t fpm, uint8_t dutyPct){
+  if (fpm < FPM_MIN) fpm = FPM_MIN;
+  if (fpm > FPM_MAX) fpm = FPM_MAX;
+  if (dutyPct < DUTY_MIN) dutyPct = DUTY_MIN;
+  if (dutyPct > DUTY_MAX) dutyPct = DUTY_MAX;
+  portENTER_CRITICAL(&g_mux);
+  g_fpm = fpm;
+  g_duty = dutyPct;
+  portEXIT_CRITICAL(&g_mux);
+  if (g_prefs) {
+    g_prefs->putUChar(KEY_FLASH_FPM, fpm);
+    g_prefs->putUChar(KEY_FLASH_DUTY, dutyPct);
+  }
+}
+
+uint8_t fpm(){ return g_fpm; }
+uint8_t dutyPct(){ return g_duty; }
+
+bool turnSignalsFlash(){ return g_turnFlash; }
+
+void setTurnSignalsFlash(bool on){
+  g_turnFlash = on;
+  if (g_prefs) g_prefs->putBool(KEY_FLASH_TURN, on);
+}
+
+} // namespace Flasher
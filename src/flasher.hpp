@@ -0,0 +1,35 @@
+// File Overview: Declares the turn-signal/hazard flasher that blinks relay outputs from
+// an esp_timer at a configurable rate and duty, independent of loop/TFT timing.
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+#include "relays.hpp"
+
+// Channels handed to the flasher are owned by it until stop(): the rotary
+// enforcement and RF exclusivity must leave those bits alone. Every ON edge goes
+// through the relay driver, so the protector sees it (with the exact edge time)
+// and applies the learned inrush envelope per flash.
+namespace Flasher {
+  // SAE/FMVSS 108 turn signal window is 60..120 flashes per minute
+  static constexpr uint8_t FPM_MIN = 60, FPM_MAX = 120, FPM_DEFAULT = 90;
+  static constexpr uint8_t DUTY_MIN = 30, DUTY_MAX = 75, DUTY_DEFAULT = 50;
+
+  void begin(Preferences* prefs);      // loads rate/duty/turn-flash option
+
+  // Flash exactly these outputs (replaces the current set; no-op if unchanged)
+  void start(uint8_t mask);
+  // Release the flashed outputs (OFF)
+  void stop();
+
+  uint8_t activeMask();                // 0 = idle
+  bool    isLit();
+  int64_t litSinceUs();                // esp_timer time of the last ON edge
+
+  void    setRate(uint8_t fpm, uint8_t dutyPct);   // clamped and persisted
+  uint8_t fpm();
+  uint8_t dutyPct();
+
+  // When set, LEFT/RIGHT from the 1P8T and RF flash instead of staying on
+  bool turnSignalsFlash();
+  void setTurnSignalsFlash(bool on);
+}
@@ -27,10 +27,22 @@
 #include "display/DisplayUI.hpp"
 #include "sensors/INA226.hpp"
 #include "rf/RF.hpp"
+#include "rf/RmtCapture.hpp"
 #include "buzzer.hpp"
 #include "relays.hpp"
 #include <Preferences.h>
 #include "power/Protector.hpp"
+#include "power/BatteryModel.hpp"
+#include "seq/Sequencer.hpp"
+#include "diag/WiringDiag.hpp"
+#include "diag/BleedDetector.hpp"
+#include "diag/FlickerDetector.hpp"
+#include "sensors/LoadSampler.hpp"
+#include "sensors/LoadSpectrum.hpp"
+#include "flasher.hpp"
+#include "relay_wear.hpp"
+#include "channel_map.hpp"
+#include "storage/TrailerStore.hpp"
 #include "ble/TltbBleService.hpp"
 
 // =============================================================================
@@ -65,6 +77,16 @@ static constexpr uint32_t HIGH_CURRENT_LIMIT_MS = 120000;  // Maximum high curre
 static constexpr uint32_t COOLDOWN_PERIOD_MS = 120000;     // Required cooldown time (2 minutes)
 static constexpr float HIGH_CURRENT_THRESHOLD = 20.5f;     // Current threshold (amps)
 
+// =============================================================================
+// Predictive LVP warning (battery model)
+// Warn when the predicted sag at present load plus headroom nears the cutoff
+// =============================================================================
+
+static constexpr float LVP_WARN_MARGIN_V   = 0.3f;  // volts above cutoff that still warns
+static constexpr float LVP_WARN_HEADROOM_A = 2.0f;  // extra planned load (e.g. a brake tap)
+static constexpr float LVP_WARN_RELEASE_V  = 0.2f;  // clears only this far above the warn level
+static constexpr uint32_t LVP_WARN_HOLD_MS  = 10000; // ... for this long (flasher load swings on/off)
+
 // =============================================================================
 // Display Backlight Control
 // =============================================================================
@@ -143,83 +165,69 @@ static void enforceRotaryMode(RotaryMode m) {
       g_startupGuard = false;
     }
     // Keep all relays OFF while guard is active
-    for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+    Flasher::stop();
+    allOff();
     return;
   }
 
   // Protection fault override: if any fault is latched, keep all relays OFF regardless of rotary position
-  if (protector.isLvpLatched() || protector.isOcpLatched() || protector.isOutvLatched()) {
-    for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+  if (protector.state().anyLatched()) {
+    Flasher::stop();
+    allOff();
     return;
   }
 
-  // Normal operation: In all non-RF modes, we *force* the relay states each loop.
-  // This guarantees RF is effectively ignored unless in MODE_RF_ENABLE.
-  auto allOff = [](){
-    // Turn off all output relays, but NOT R_ENABLE (system master relay)
-    for (int i = 0; i < (int)R_ENABLE; ++i) relayOff(i);
-  };
-
   // Clear BLE active relay tracking when not in RF mode
   // (BLE can only control relays in RF mode, so this keeps display accurate)
   if (m != MODE_RF_ENABLE) {
     g_bleActiveRelay = -1;
   }
 
+  // Normal operation: In all non-RF modes, we *force* the relay states each loop.
+  // This guarantees RF is effectively ignored unless in MODE_RF_ENABLE.
+  // The wanted state is built as one mask and applied in a single driver update,
+  // which only touches the GPIOs when it differs from what is already driven.
+  uint8_t owned = RELAY_MASK_ALL;   // channels this mode forces
+  uint8_t want  = 0;                // ON channels among those
+  uint8_t flash = 0;                // channels handed to the flasher instead
+
   switch (m) {
     case MODE_ALL_OFF:
-      #ifndef DEV_MODE
-      allOff();
+      #ifdef DEV_MODE
+      owned = relayBit(R_ENABLE);
       #endif
       break;
 
     case MODE_RF_ENABLE:
       // Do not force anything; RF subsystem may control relays.
+      owned = relayBit(R_ENABLE);
       break;
 
-    case MODE_LEFT:
-      allOff(); relayOn(R_LEFT);
-      break;
-
-    case MODE_RIGHT:
-      allOff(); relayOn(R_RIGHT);
-      break;
-
-    case MODE_BRAKE:
-      allOff();
-      if (getUiMode() == 1) { // RV
-        relayOn(R_LEFT); relayOn(R_RIGHT);
-      } else {
-        relayOn(R_BRAKE);
-      }
-      break;
-
-    case MODE_TAIL:
-      allOff(); relayOn(R_TAIL);
-      break;
-
-    case MODE_MARKER:
-      allOff(); relayOn(R_MARKER);
-      break;
-
-    case MODE_AUX:
-      allOff();
-      if (getUiMode() == 1) { // RV
-        relayOn(R_AUX);
-      } else {
-        relayOn(R_AUX);
-      }
-      break;
+    default: {
+      // P3..P8: relays and flash behaviour come from the active channel profile
+      const uint8_t slot = (uint8_t)(m - MODE_LEFT);
+      const uint8_t mask = ChannelMap::slotMask(slot);
+      if ((ChannelMap::slotFlags(slot) & CH_SLOT_TURN) && Flasher::turnSignalsFlash()) flash = mask;
+      else                                                                           want = mask;
+    } break;
   }
 
   // Relay 7 (R_ENABLE) must be OFF when the selector is in position 1 (ALL_OFF)
   // and ON in all other positions. This is independent of RF control for the
   // other relays — we enforce it here.
-  if (m == MODE_ALL_OFF) {
-    relayOff(R_ENABLE);
-  } else {
-    relayOn(R_ENABLE);
+  if (m != MODE_ALL_OFF) {
+    want |= relayBit(R_ENABLE);
+  }
+
+  // Outside RF mode the rotary decides what flashes; in RF mode RF/BLE do.
+  // Whatever the flasher owns is left to its timer.
+  if (m != MODE_RF_ENABLE) {
+    if (flash) Flasher::start(flash);
+    else       Flasher::stop();
   }
+  owned &= (uint8_t)~Flasher::activeMask();
+
+  relaysUpdate(owned, want);
 }
 
 // (Relay scan feature removed)
@@ -231,6 +239,7 @@ static uint32_t computeFaultMask(){
   if (!INA226_SRC::PRESENT) m |= FLT_INA_SRC_MISSING;
 
   if (!RF::isPresent())     m |= FLT_RF_MISSING;
+  if (bleedDetector.active()) m |= FLT_CHANNEL_BLEED;
   return m;
 }
 
@@ -244,16 +253,115 @@ static bool bleCanDriveRelays() {
   #else
   if (g_stableRotaryMode != MODE_RF_ENABLE) return false;
   #endif
-  if (protector.isLvpLatched() || protector.isOcpLatched() || protector.isOutvLatched()) return false;
+  // Snapshot: this runs on the NimBLE host task as well as the loop
+  if (protector.state().anyLatched()) return false;
   return true;
 }
 
+// Wiring diagnostics need the RF-mode enable relay and a clean protection state
+static bool canStartWiringDiag() {
+  if (g_stableRotaryMode != MODE_RF_ENABLE || g_startupGuard) return false;
+  if (protector.state().anyLatched() || tele.cooldownActive) return false;
+  return true;
+}
+
+static bool startWiringDiag() {
+  if (!canStartWiringDiag()) {
+    Serial.println("[DIAG] Start blocked (RF mode required, no faults)");
+    return false;
+  }
+  if (sequencer.running()) sequencer.requestStop();
+  wiringDiag.requestStart();
+  return true;
+}
+
+// RF recorder download, requested from the BLE task and streamed by the loop:
+// one slice per pass, as base64 on the result characteristic (sized to the MTU,
+// resent until a notify succeeds) and as hex lines ("[RFREC] offset hex") on
+// Serial for scripts/rf_replay
+static volatile bool g_rfDumpRequest = false;
+static constexpr size_t RFREC_SERIAL_SLICE = 480;   // bytes per pass without a BLE client
+
+// One slice as "[RFREC] offset hex" lines of up to 48 bytes, written in one go
+static void printRfRecordHex(size_t pos, const uint8_t* data, size_t n) {
+  static constexpr size_t LINE_BYTES = 48;
+  static char text[(RFREC_SERIAL_SLICE / LINE_BYTES + 1) * (20 + 2 * LINE_BYTES)];
+  static const char kHex[] = "0123456789abcdef";
+  size_t len = 0;
+  for (size_t i = 0; i < n; i += LINE_BYTES) {
+    len += snprintf(text + len, sizeof(text) - len, "[RFREC] %u ", (unsigned)(pos + i));
+    for (size_t k = i; k < n && k < i + LINE_BYTES; ++k) {
+      text[len++] = kHex[data[k] >> 4];
+      text[len++] = kHex[data[k] & 0x0F];
+    }
+    text[len++] = '\n';
+  }
+  Serial.write(reinterpret_cast<const uint8_t*>(text), len);
+}
+
+static void serviceRfRecordDump() {
+  static bool     s_active = false;
+  static size_t   s_pos = 0, s_total = 0;
+  static uint32_t s_lastMs = 0;
+  static uint8_t  s_failures = 0;
+  static constexpr uint32_t SLICE_INTERVAL_MS = 40; // let the notify queue drain
+  static constexpr uint8_t  MAX_FAILURES = 50;      // ~2 s of refused notifies
+  if (g_rfDumpRequest) {
+    g_rfDumpRequest = false;
+    RmtCapture::setRecording(false);
+    s_total = RmtCapture::recordSize();
+    s_pos = 0;
+    s_failures = 0;
+    s_active = true;
+    Serial.printf("[RFREC] begin %u\n", (unsigned)s_total);
+  }
+  if (!s_active || millis() - s_lastMs < SLICE_INTERVAL_MS) return;
+  s_lastMs = millis();
+  // With a client the MTU sets the slice; without one Serial takes bigger ones
+  const size_t bleMax = g_bleService.rfRecordChunkMax();
+  uint8_t buf[RFREC_SERIAL_SLICE];
+  const size_t n = RmtCapture::readRecord(s_pos, buf, bleMax && bleMax < sizeof(buf) ? bleMax : sizeof(buf));
+  if (n && bleMax && !g_bleService.publishRfRecordChunk(s_pos, s_total, buf, n)) {
+    if (++s_failures < MAX_FAILURES) return;      // same slice next pass
+    s_active = false;
+    Serial.println("[RFREC] aborted: notifies refused");
+    return;
+  }
+  s_failures = 0;
+  printRfRecordHex(s_pos, buf, n);
+  s_pos += n;
+  if (n == 0 || s_pos >= s_total) {
+    s_active = false;
+    Serial.println("[RFREC] end");
+  }
+}
+
+// Inrush capture sampler for the wiring diagnostic: one direct load reading,
+// with the protector ticked on it so OCP is evaluated at sensor rate
+static float sampleLoadProtected() {
+  float a = INA226::PRESENT ? INA226::readCurrentA() : NAN;
+  protector.tick(tele.srcV, a, tele.outV, millis());
+  return a;
+}
+
 static void handleBleRelayCommand(RelayIndex idx, bool desiredOn) {
   Serial.printf("[BLE] Relay command received: idx=%d, desiredOn=%d\n", (int)idx, desiredOn);
+  if (wiringDiag.running()) {
+    Serial.println("[BLE] Relay command aborts wiring diagnostic");
+    wiringDiag.requestStop();
+    return;
+  }
+  if (sequencer.running()) {
+    // Manual intervention ends an automated test; the command itself is dropped
+    Serial.println("[BLE] Relay command aborts running sequence");
+    sequencer.requestStop();
+    return;
+  }
   if (!bleCanDriveRelays()) {
+    ProtectionState ps = protector.state();
     Serial.printf("[BLE] Relay control blocked - startupGuard=%d, rotaryMode=%d (need %d for RF), lvp=%d, ocp=%d, outv=%d\n",
       g_startupGuard, (int)g_stableRotaryMode, (int)MODE_RF_ENABLE,
-      protector.isLvpLatched(), protector.isOcpLatched(), protector.isOutvLatched());
+      ps.lvpLatched, ps.ocpLatched, ps.outvLatched);
     return;
   }
   int target = static_cast<int>(idx);
@@ -272,11 +380,67 @@ static void handleBleRelayCommand(RelayIndex idx, bool desiredOn) {
   }
 }
 
+// RF presses: any press aborts a running sequence or diagnostic; the sequence slot starts one
+static bool rfTriggerHook(int slot) {
+  if (wiringDiag.running()) {
+    wiringDiag.requestStop();
+    Buzzer::beep();
+    return true;
+  }
+  if (sequencer.running()) {
+    sequencer.requestStop();
+    Buzzer::beep();
+    return true;
+  }
+  if (slot == RF::SLOT_SEQUENCE) {
+    if (g_stableRotaryMode == MODE_RF_ENABLE && !g_startupGuard) {
+      sequencer.requestStart(0);
+      Buzzer::beep();
+    }
+    return true;
+  }
+  return false;
+}
+
+// Verdict of the last sequence run, shown in place of the mode label for a while
+static SeqVerdict g_seqVerdict = SeqVerdict::None;
+static uint32_t   g_seqVerdictAtMs = 0;
+static constexpr uint32_t SEQ_VERDICT_SHOW_MS = 10000;
+
 static const char* describeActiveLabel(RotaryMode mode) {
   if (g_startupGuard) {
     return "SAFE";
   }
 
+  if (wiringDiag.running()) {
+    static char diagLabel[12];
+    snprintf(diagLabel, sizeof(diagLabel), "DIAG %u/%u",
+             (unsigned)wiringDiag.currentChannel() + 1, (unsigned)WiringReport::CHANNELS);
+    return diagLabel;
+  }
+  if (sequencer.running()) {
+    static char seqLabel[12];
+    snprintf(seqLabel, sizeof(seqLabel), "SEQ %u/%u",
+             (unsigned)sequencer.currentStep() + 1, (unsigned)sequencer.stepCount());
+    return seqLabel;
+  }
+  if (g_seqVerdict != SeqVerdict::None) {
+    if (millis() - g_seqVerdictAtMs < SEQ_VERDICT_SHOW_MS) {
+      switch (g_seqVerdict) {
+        case SeqVerdict::Pass:    return "SEQ PASS";
+        case SeqVerdict::Fail:    return "SEQ FAIL";
+        default:                  return "SEQ ABORT";
+      }
+    }
+    g_seqVerdict = SeqVerdict::None;
+  }
+  if (flickerDetector.enabled()) {
+    static char wigLabel[16];
+    snprintf(wigLabel, sizeof(wigLabel), "WIG %lu %u/m",
+             (unsigned long)flickerDetector.events(), (unsigned)flickerDetector.eventsPerMinute(millis()));
+    return wigLabel;
+  }
+
   // Check if BLE has an active relay - takes priority over rotary position
   // This allows the display to show what's actually on when controlled via app
   if (g_bleActiveRelay >= (int)R_LEFT && g_bleActiveRelay < (int)R_ENABLE) {
@@ -290,16 +454,17 @@ static const char* describeActiveLabel(RotaryMode mode) {
   }
 
   switch (mode) {
-    case MODE_LEFT:   return "LEFT";
-    case MODE_RIGHT:  return "RIGHT";
-    case MODE_BRAKE:  return "BRAKE";
-    case MODE_TAIL:   return "TAIL";
-    case MODE_MARKER: return (getUiMode() == 1) ? "REV" : "MARK";
-    case MODE_AUX:    return (getUiMode() == 1) ? "Ele Brakes" : "AUX";
+    case MODE_LEFT:
+    case MODE_RIGHT:
+    case MODE_BRAKE:
+    case MODE_TAIL:
+    case MODE_MARKER:
+    case MODE_AUX:    return ChannelMap::slotLabel((uint8_t)(mode - MODE_LEFT));
     case MODE_RF_ENABLE: {
+      if (Flasher::activeMask() == (relayBit(R_LEFT) | relayBit(R_RIGHT))) return "HAZARD";
       int8_t rfRelay = RF::getActiveRelay();
       if (rfRelay >= (int)R_LEFT && rfRelay < (int)R_ENABLE) {
-        return relayName(static_cast<RelayIndex>(rfRelay));
+        return ChannelMap::slotLabel((uint8_t)rfRelay);
       }
       return "RF";
     }
@@ -402,6 +567,7 @@ void setup() {
 
   // prefs first
   prefs.begin(NVS_NS, false);
+  ChannelMap::begin(&prefs);      // before the UI: home screen shows the profile tag
 
   // Dev-boot now uses existing UI Wi‑Fi/OTA pages; no special flow here.
 
@@ -414,20 +580,35 @@ void setup() {
     .kWifiPass   = KEY_WIFI_PASS,
     .readSrcV    = [](){ return INA226_SRC::readBusV(); },
     .readLoadA   = [](){ return INA226::readCurrentA(); },
-    .onOtaStart  = nullptr,
+    .onOtaStart  = [](){ RelayWear::flush(); protector.flushLearned(millis()); },
     .onOtaEnd    = nullptr,
     // Apply new LVP cutoff immediately to protector
     .onLvCutChanged = [](float v){ protector.setLvpCutoff(v); },
   .onOcpChanged   = [](float a){ protector.setOcpLimit(a); },
   .onOutvChanged  = [](float v){ protector.setOutvCutoff(v); },
-  .getOutvBypass  = [](){ return protector.outvBypass(); },
+  .getOutvBypass  = [](){ return protector.state().outvBypass; },
   .setOutvBypass  = [](bool on){ protector.setOutvBypass(on); },
-    .onRfLearn      = [](int idx){ return RF::learn(idx); },
-    .getLvpBypass   = [](){ return protector.lvpBypass(); },
+    .onRfLearn      = [](int idx){ return RF::learnStart(idx); },
+    .getLvpBypass   = [](){ return protector.state().lvpBypass; },
     .setLvpBypass   = [](bool on){ protector.setLvpBypass(on); },
     .getStartupGuard = [](){ return g_startupGuard; },
     .onBleStop      = [](){ g_bleService.shutdownForOta(); },
     .onBleRestart   = [](){ g_bleService.restartAfterOta(); },
+    .refineLvCut    = [](float nominalV, float cutoffV){
+      battery.setNominalVoltage(nominalV);
+      return battery.recommendCutoff(cutoffV);
+    },
+    .onWiringDiag   = [](){ return startWiringDiag(); },
+    .onWiggleToggle = [](){
+      flickerDetector.setEnabled(!flickerDetector.enabled());
+      return flickerDetector.enabled();
+    },
+    .getBleCmdLatency = [](uint32_t& avgUs, uint32_t& maxUs){
+      TltbBleService::CommandStats st = g_bleService.commandStats();
+      avgUs = st.avgUs;
+      maxUs = st.maxUs;
+      return st.applied > 0;
+    },
   });
   ui->attachTFT(tft, PIN_TFT_BL);
   ui->attachBrightnessSetter(setBacklight);
@@ -469,7 +650,10 @@ void setup() {
   // Initialize sensors, RF, and buzzer
   INA226::begin();
   INA226_SRC::begin();
+  LoadSampler::begin();
+  LoadSpectrum::begin();
   RF::begin();
+  RF::setTriggerHook(rfTriggerHook);
   Buzzer::begin();
 
   // Auto-join Wi-Fi (non-blocking)
@@ -481,6 +665,13 @@ void setup() {
 
   // Protector init (loads thresholds)
   protector.begin(&prefs);
+  battery.begin(&prefs);
+  sequencer.begin(&prefs);
+  wiringDiag.begin(sampleLoadProtected);
+  bleedDetector.begin(&prefs);
+  RelayWear::begin(&prefs);
+  trailerStore.begin(&prefs);
+  Flasher::begin(&prefs);
   ui->setFaultMask(computeFaultMask());
   // Don't show home screen yet - let battery detection run first with splash visible
   
@@ -505,7 +696,7 @@ void setup() {
         tft->println("Contact support.");
 
         while (true) {
-          for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+          allOff();
           delay(100);
         }
       } else {
@@ -544,7 +735,7 @@ void setup() {
     tft->printf("Boot current: %.1fA", bootCurrent);
     // Block here forever - require power cycle
     while(true) {
-      for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+      allOff();
       delay(100);
     }
   }
@@ -556,6 +747,64 @@ void setup() {
   bleCallbacks.onRefreshRequest = []() {
     g_bleService.requestImmediateStatus();
   };
+  bleCallbacks.onSequenceStore = [](uint8_t slot, const SeqProgram& program) {
+    return sequencer.requestStore(slot, program);
+  };
+  bleCallbacks.onSequenceRun = [](uint8_t slot) {
+    if (!bleCanDriveRelays()) {
+      Serial.println("[BLE] Sequence start blocked (RF mode required, no faults)");
+      return;
+    }
+    sequencer.requestStart(slot);
+  };
+  bleCallbacks.onSequenceStop = []() {
+    sequencer.requestStop();
+  };
+  bleCallbacks.onFlashCommand = [](uint8_t mask, uint8_t fpm, uint8_t duty) {
+    if (fpm || duty) {
+      Flasher::setRate(fpm ? fpm : Flasher::fpm(), duty ? duty : Flasher::dutyPct());
+    }
+    if (!mask) {
+      Flasher::stop();
+      return;
+    }
+    if (!bleCanDriveRelays()) {
+      Serial.println("[BLE] Flash command blocked (RF mode required, no faults)");
+      return;
+    }
+    if (sequencer.running()) sequencer.requestStop();
+    if (wiringDiag.running()) wiringDiag.requestStop();
+    // Flashing replaces any steady output, like an RF/BLE relay selection does
+    relaysUpdate(RELAY_MASK_OUTPUTS & (uint8_t)~mask, 0);
+    g_bleActiveRelay = -1;
+    Flasher::start(mask);
+  };
+  // NimBLE task: only the request; the loop gates it and starts the run
+  bleCallbacks.onDiagStart = []() {
+    wiringDiag.requestStart();
+  };
+  bleCallbacks.onDiagStop = []() {
+    wiringDiag.requestStop();
+  };
+  bleCallbacks.onWiggle = [](bool on) {
+    flickerDetector.requestEnabled(on);
+  };
+  bleCallbacks.onTrailerCommand = [](TrailerStore::Op op, const char* name) {
+    return trailerStore.request(op, name);
+  };
+  bleCallbacks.onRfRecord = [](bool on) {
+    RmtCapture::setRecording(on);
+    Serial.printf("[RF] Recorder %s\n", on ? "started" : "stopped");
+  };
+  bleCallbacks.onRfDump = []() {
+    g_rfDumpRequest = true;
+  };
+  bleCallbacks.onProfileStore = [](const ChannelProfile& profile) {
+    return ChannelMap::requestStoreCustom(profile);
+  };
+  bleCallbacks.onProfileSelect = [](uint8_t id) {
+    return ChannelMap::requestSelect(id);
+  };
   g_bleService.begin("TLTB Controller", bleCallbacks);
   Serial.println("[APP] BLE begin invoked");
 
@@ -580,14 +829,60 @@ void loop() {
     protector.setOcpHold(false);
   }
   protector.tick(tele.srcV, tele.loadA, tele.outV, millis());
-  // Track latches separately for UI clarity
-  tele.lvpLatched   = protector.isLvpLatched();
-  tele.ocpLatched   = protector.isOcpLatched();
-  tele.outvLatched  = protector.isOutvLatched();
+  // Track latches separately for UI clarity (one consistent snapshot per tick)
+  ProtectionState prot = protector.state();
+  tele.lvpLatched   = prot.lvpLatched;
+  tele.ocpLatched   = prot.ocpLatched;
+  tele.outvLatched  = prot.outvLatched;
+  tele.revLatched   = prot.revLatched;
+  tele.revWarn      = prot.revWarn;
+  // A low-voltage trip may be followed by losing power: save pending wear
+  // counts and learned inrush envelopes
+  {
+    static bool s_prevLvp = false;
+    if (prot.lvpLatched && !s_prevLvp) {
+      RelayWear::flush();
+      protector.flushLearned(millis());
+    }
+    s_prevLvp = prot.lvpLatched;
+  }
+
+  // Battery model: fit internal resistance from relay load steps, predict sag
+  battery.sample(tele.srcV, tele.loadA, millis());
+  {
+    // Raise at once, clear only after the prediction has stayed above the
+    // warn level plus a margin for LVP_WARN_HOLD_MS: one chirp per episode
+    static uint32_t s_lvpWarnClearSinceMs = 0;
+    const uint32_t nowMs = millis();
+    const bool armed = !tele.lvpLatched && !prot.lvpBypass;
+    const float planned = (isnan(tele.loadA) ? 0.0f : fabsf(tele.loadA)) + LVP_WARN_HEADROOM_A;
+    const float warnV = prot.lvpCutoffV + LVP_WARN_MARGIN_V;
+    bool warn = tele.lvpWarn;
+    if (!armed) {
+      warn = false;
+    } else if (battery.predictsSagBelow(warnV, planned)) {
+      if (!warn) Buzzer::beep(30); // single chirp on rising edge
+      warn = true;
+      s_lvpWarnClearSinceMs = nowMs;
+    } else if (warn) {
+      if (battery.predictsSagBelow(warnV + LVP_WARN_RELEASE_V, planned)) s_lvpWarnClearSinceMs = nowMs;
+      else if (nowMs - s_lvpWarnClearSinceMs >= LVP_WARN_HOLD_MS) warn = false;
+    }
+    tele.lvpWarn = warn;
+    float r = battery.internalResistanceOhm();
+    tele.battRintMilliOhm = (uint16_t)(r * 1000.0f + 0.5f);
+    tele.battSohPct = battery.stateOfHealthPct();
+  }
+
+  // Block RMS of every conversion: pulsed (PWM LED, brake controller) loads
+  // make single snapshots jump, so cooldown and the Load readout use this
+  LoadSpectrum::service(millis());
+  tele.loadRmsA = LoadSpectrum::rmsA(millis());
 
   // Cooldown timer logic: limit sustained high current usage
   uint32_t now = millis();
-  float current = !isnan(tele.loadA) ? fabsf(tele.loadA) : 0.0f;
+  float current = !isnan(tele.loadRmsA) ? tele.loadRmsA
+                : (!isnan(tele.loadA) ? fabsf(tele.loadA) : 0.0f);
   
   if (g_cooldownStartMs > 0) {
     // Currently in cooldown period - keep enable relay OFF
@@ -634,8 +929,9 @@ void loop() {
   {
     bool beepFault = false;
     if (tele.ocpLatched) beepFault = true; // OCP always beeps (no bypass)
-    if (tele.lvpLatched && !protector.lvpBypass()) beepFault = true;
-    if (tele.outvLatched && !protector.outvBypass()) beepFault = true;
+    if (tele.revLatched) beepFault = true; // back-feed trip has no bypass either
+    if (tele.lvpLatched && !prot.lvpBypass) beepFault = true;
+    if (tele.outvLatched && !prot.outvBypass) beepFault = true;
     if (ui && ui->menuActive()) {
       beepFault = false; // silence buzzer whenever settings menu is on screen
     }
@@ -648,6 +944,9 @@ void loop() {
   {
     bool ocpLatched = protector.isOcpLatched();
     if (ocpLatched) {
+      // Blame the channel under test before the modal blocks and the clear at
+      // OFF hides the trip from the diagnostic
+      wiringDiag.noteOcpTrip(tele.loadA);
       // Require user to return 1P8T to OFF before allowing 12V enable again
       g_startupGuard = true;
       // Always hold OCP while latched so it cannot auto-clear until OFF is selected
@@ -692,7 +991,7 @@ void loop() {
           uint32_t offStableStart = 0;
           while (true) {
             RotaryMode m = readRotary();
-            for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+            allOff();
             if (m == MODE_ALL_OFF) {
               if (offStableStart == 0) offStableStart = millis();
               // Require OFF to be held stable for at least 300ms
@@ -727,6 +1026,7 @@ void loop() {
   }
 
   g_faultMask = computeFaultMask();
+  ui->setBleedPair(tele.bleedOn, tele.bleedInto);
   ui->setFaultMask(g_faultMask);
   
   // Update display with current active label (includes BLE tracking)
@@ -761,7 +1061,7 @@ void loop() {
           uint32_t offStableStart = 0;
           while (true) {
             RotaryMode m = readRotary();
-            for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+            allOff();
             if (m == MODE_ALL_OFF) {
               if (offStableStart == 0) offStableStart = millis();
               // Require OFF to be held stable for at least 300ms
@@ -816,7 +1116,7 @@ void loop() {
           uint32_t offStableStart = 0;
           while (true) {
             RotaryMode m = readRotary();
-            for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+            allOff();
             if (m == MODE_ALL_OFF) {
               if (offStableStart == 0) offStableStart = millis();
               // Require OFF to be held stable for at least 300ms
@@ -844,19 +1144,90 @@ void loop() {
     }
   }
 
+  // Reverse-current modal (single-shot per continuous fault; re-armed after healthy period)
+  static bool     revAcked = false;
+  static uint32_t revHealthySince = 0;
+  {
+    bool revLatched = protector.isRevLatched();
+    if (revLatched) {
+      revHealthySince = 0;
+      if (!revAcked) {
+        // Show a blocking modal that requires OFF position to clear
+        if (tft) {
+          tft->fillScreen(ST77XX_RED);
+          tft->setTextColor(ST77XX_WHITE, ST77XX_RED);
+          tft->setTextSize(2);
+          tft->setCursor(6, 6);  tft->print("Back-feed");
+          tft->setTextSize(1);
+          tft->setCursor(6, 34); tft->print("Reverse current from");
+          tft->setCursor(6, 46); tft->print("trailer (or polarity).");
+          // Hint: first output relay that was on when reverse flow began
+          uint8_t mask = protector.revRelayMask();
+          for (int i = 0; i < (int)R_ENABLE; ++i) {
+            if (mask & (1u << i)) {
+              tft->setCursor(6, 58);
+              tft->print("Check: ");
+              tft->print(relayName(static_cast<RelayIndex>(i)));
+              break;
+            }
+          }
+          // Footer instruction
+          tft->fillRect(0, 108, 160, 20, ST77XX_BLACK);
+          tft->setTextColor(ST77XX_YELLOW, ST77XX_BLACK);
+          tft->setCursor(6, 112); tft->print("Rotate to OFF to restart");
+        }
+        // Block until OFF is detected (debounced); keep relays off
+        {
+          uint32_t offStableStart = 0;
+          while (true) {
+            RotaryMode m = readRotary();
+            allOff();
+            if (m == MODE_ALL_OFF) {
+              if (offStableStart == 0) offStableStart = millis();
+              // Require OFF to be held stable for at least 300ms
+              if (millis() - offStableStart >= 300) break;
+            } else {
+              offStableStart = 0; // reset stability if moved away
+            }
+            delay(10);
+          }
+        }
+        // OFF detected: clear reverse-current latch; allow resume
+        protector.clearRevLatch();
+        tele.revLatched = false;
+        revAcked = true;  // suppress further pop-ups until fault truly resolves
+        // Ensure the Home screen fully repaints after leaving blocking modal
+        ui->requestFullHomeRepaint();
+        ui->showStatus(tele);
+      }
+    } else {
+      uint32_t now = millis();
+      if (revHealthySince == 0) revHealthySince = now;
+      if (now - revHealthySince >= 1000) {
+        revAcked = false;
+      }
+    }
+  }
+
   // OTA validation disabled - using simple OTA
   // (Rollback protection removed to fix OTA data partition corruption)
 
   // Let RF run, but we will enforce rotary below unless in MODE_RF_ENABLE
   RF::service();
 
+  // App relay/flash commands, queued by the BLE task, apply here like RF presses
+  g_bleService.serviceCommands();
+
   // Rotary has final say unless P2 (RF enabled)
   static RotaryMode s_prevMode = readRotary();
   RotaryMode curMode = readRotary();
   if (curMode != s_prevMode) {
-    // On any mode change, suppress OCP for a short window to avoid false trips during relay transitions
-    protector.suppressOcpUntil(millis() + 700); // tune 500–800ms as needed
-    
+    // Relay transitions are covered by the protector's learned inrush envelopes
+    // (it watches the relay mask itself), so OCP stays armed through mode changes.
+
+    // A flash started in one position never carries into the next
+    Flasher::stop();
+
     // Reset RF state when entering or exiting RF mode
     if (curMode == MODE_RF_ENABLE || s_prevMode == MODE_RF_ENABLE) {
       RF::reset();
@@ -868,22 +1239,122 @@ void loop() {
       g_stableRotaryMode = curMode;
     }
   }
+
+  // Test sequence: steps run from its own timer; here it samples current and
+  // aborts as soon as RF mode is left or any protection/cooldown condition appears
+  {
+    bool seqAllowed = (curMode == MODE_RF_ENABLE) && !g_startupGuard &&
+                      !protector.state().anyLatched() && !tele.cooldownActive &&
+                      !wiringDiag.running();
+    sequencer.service(tele.loadA, seqAllowed, millis());
+    tele.seqRunning = sequencer.running();
+    SeqResult result;
+    if (sequencer.takeResult(result)) {
+      g_seqVerdict = result.verdict;
+      g_seqVerdictAtMs = millis();
+      Buzzer::beep(result.verdict == SeqVerdict::Pass ? 60 : 400);
+      g_bleService.publishSequenceResult(result);
+      g_bleService.requestImmediateStatus();
+    }
+  }
+
+  // Wiring diagnostic: walks LEFT..AUX through the enable relay; a protection
+  // latch during a channel is reported as a short. The report page blocks like
+  // the other modals, with every output already released.
+  {
+    // Starts come from the menu or BLE; a BLE request is only gated here
+    if (wiringDiag.startPending() && !wiringDiag.running()) {
+      if (!canStartWiringDiag()) {
+        Serial.println("[DIAG] Start blocked (RF mode required, no faults)");
+        wiringDiag.requestStop();
+      } else if (sequencer.running()) {
+        sequencer.requestStop();
+      }
+    }
+    const bool diagWasRunning = wiringDiag.running();
+    bool diagOk = (curMode == MODE_RF_ENABLE) && !g_startupGuard;
+    wiringDiag.service(tele.loadA, tele.outV, diagOk, millis());
+    // The run released every output, BLE-selected relays included
+    if (!diagWasRunning && wiringDiag.running()) g_bleActiveRelay = -1;
+    tele.diagRunning = wiringDiag.running();
+    WiringReport report;
+    if (wiringDiag.takeReport(report)) {
+      Buzzer::beep(report.aborted ? 400 : 60);
+      bleedDetector.learnFromReport(report);
+      TrailerDrift drift;
+      const bool compared = trailerStore.noteReport(report, drift);
+      g_bleService.publishWiringReport(report);
+      if (compared) g_bleService.publishTrailerDrift(drift);
+      g_bleService.requestImmediateStatus();
+      if (!report.aborted || curMode == MODE_RF_ENABLE) {
+        ui->showWiringReport(report, compared ? &drift : nullptr);
+        ui->requestFullHomeRepaint();
+      }
+    }
+  }
+
   enforceRotaryMode(curMode);
 
+  // Channel bleed: compare steady load current with the learned per-channel and
+  // combination baselines; flashing and the diagnostic itself are not steady
+  {
+    bool steady = !g_startupGuard && !wiringDiag.running() && !Flasher::activeMask() &&
+                  !protector.state().anyLatched();
+    bleedDetector.service(tele.loadA, steady, millis());
+    tele.bleedOn = bleedDetector.pairA();
+    tele.bleedInto = bleedDetector.pairB();
+  }
+
+  // Wiggle test: full-rate dropout detection on whatever output is steadily on
+  {
+    bool steady = !g_startupGuard && !wiringDiag.running() && !sequencer.running() &&
+                  !Flasher::activeMask() && !protector.state().anyLatched();
+    flickerDetector.service(relaysMask() & RELAY_MASK_OUTPUTS, steady, millis());
+    tele.wiggleActive = flickerDetector.enabled();
+    static uint32_t s_lastWiggleNotifyMs = 0;
+    if (flickerDetector.takeEvent() || (tele.wiggleActive && millis() - s_lastWiggleNotifyMs >= 10000)) {
+      if (millis() - s_lastWiggleNotifyMs >= 250) {
+        s_lastWiggleNotifyMs = millis();
+        g_bleService.publishWiggle(flickerDetector.events(), flickerDetector.eventsPerMinute(millis()));
+      }
+    }
+  }
+
+  // Deferred custom channel profile upload (NVS write on the loop task)
+  ChannelMap::service();
+
+  // Deferred trailer profile commands (SPIFFS on the loop task)
+  {
+    bool ok = false;
+    if (trailerStore.service(ok)) g_bleService.publishTrailerState(ok);
+  }
+
+  // RF recorder download in progress (paced slices)
+  serviceRfRecordDump();
+
+  // Relay wear: cycles and switched current, written to NVS at a bounded rate
+  RelayWear::service(tele.loadA, millis());
+
   BleStatusContext bleCtx{};
   bleCtx.telemetry = tele;
   bleCtx.faultMask = g_faultMask;
   bleCtx.startupGuard = g_startupGuard;
-  bleCtx.lvpBypass = protector.lvpBypass();
-  bleCtx.outvBypass = protector.outvBypass();
+  {
+    ProtectionState ps = protector.state();
+    bleCtx.lvpBypass = ps.lvpBypass;
+    bleCtx.outvBypass = ps.outvBypass;
+  }
   bleCtx.enableRelay = relayIsOn(R_ENABLE);
   bleCtx.activeLabel = describeActiveLabel(g_stableRotaryMode);
   bleCtx.timestampMs = millis();
-  bleCtx.uiMode = getUiMode();
+  bleCtx.modeTag = ChannelMap::tag();
+  bleCtx.profileId = ChannelMap::activeId();
+  bleCtx.rotaryPos = (uint8_t)g_stableRotaryMode;
   for (int i = 0; i < (int)R_COUNT; ++i) {
     bleCtx.relayStates[i] = relayIsOn(static_cast<RelayIndex>(i));
   }
   g_bleService.publishStatus(bleCtx);
+  g_bleService.publishLoadStream(tele.outV);
 
   delay(1); // keep UI responsive
 }
@@ -0,0 +1,118 @@
+// File Overview: Implements the battery internal-resistance/OCV estimator, fed from the
+// main loop telemetry, including step detection, filtering, and NVS persistence.
+#include "BatteryModel.hpp"
+#include <math.h>
+#include "prefs.hpp"
+
+// Global instance
+BatteryModel battery;
+
+void BatteryModel::begin(Preferences* prefs) {
+  _prefs = prefs;
+  // The single pre-split key could hold any pack's fit
+  if (_prefs && _prefs->isKey("batt_rint")) _prefs->remove("batt_rint");
+  _rOhm = 0.0f;
+  _rKey = nullptr;
+  _savedROhm = 0.0f;
+  _ocv = NAN;
+  _steps = 0;
+  _havePrev = false;
+  _pending = false;
+}
+
+void BatteryModel::setNominalVoltage(float nominalV) {
+  // 18V tool packs (5S Li-ion) run several times the resistance of a 12V battery
+  const bool tool = nominalV >= 15.0f;
+  const char* key = tool ? KEY_BATT_RINT_18 : KEY_BATT_RINT_12;
+  _rNewOhm = tool ? 0.080f : 0.020f;
+  if (key == _rKey) return;
+  if (_rKey) {
+    // Re-detected as the other kind of pack: nothing fitted so far applies
+    _steps = 0;
+    _ocv = NAN;
+  }
+  _rKey = key;
+  _rOhm = 0.0f;
+  if (_prefs) {
+    const float r = _prefs->getFloat(_rKey, 0.0f);
+    if (r >= R_MIN_OHM && r <= R_MAX_OHM) _rOhm = r;
+  }
+  _savedROhm = _rOhm;
+}
+
+void BatteryModel::sample(float srcV, float loadA, uint32_t nowMs) {
+  if (isnan(srcV) || isnan(loadA)) { _havePrev = false; _pending = false; return; }
+  const float i = fabsf(loadA);
+
+  if (_pending) {
+    if ((nowMs - _stepAtMs) >= STEP_SETTLE_MS) {
+      float dI = i - _baseI;
+      if (fabsf(dI) >= STEP_MIN_A) acceptStep(srcV - _baseV, dI, srcV, i, nowMs);
+      _pending = false;
+    }
+  } else if (_havePrev && fabsf(i - _prevI) >= STEP_MIN_A) {
+    // Step edge: remember the pre-step operating point, measure once settled
+    _pending = true;
+    _baseV = _prevV;
+    _baseI = _prevI;
+    _stepAtMs = nowMs;
+  }
+
+  // Track OCV continuously from the fitted resistance
+  if (_rOhm > 0.0f && !_pending) {
+    float ocv = srcV + _rOhm * i;
+    _ocv = isnan(_ocv) ? ocv : (_ocv + 0.05f * (ocv - _ocv));
+  }
+
+  _prevV = srcV;
+  _prevI = i;
+  _havePrev = true;
+}
+
+void BatteryModel::acceptStep(float dV, float dI, float v, float i, uint32_t nowMs) {
+  float r = -dV / dI;   // voltage falls as current rises
+  if (r < R_MIN_OHM || r > R_MAX_OHM) return;
+
+  _rOhm = (_rOhm > 0.0f && _steps > 0) ? (_rOhm + R_FILTER_ALPHA * (r - _rOhm))
+                                       : r; // first step this boot replaces the seed
+  if (_steps < 0xFF) _steps++;
+  _ocv = v + _rOhm * i;
+
+  // Persist only meaningful drift, and not more than once a minute
+  if (_prefs && _rKey && fabsf(_rOhm - _savedROhm) > 0.1f * _rOhm &&
+      (_lastSaveMs == 0 || (nowMs - _lastSaveMs) >= SAVE_MIN_INTERVAL_MS)) {
+    _prefs->putFloat(_rKey, _rOhm);
+    _savedROhm = _rOhm;
+    _lastSaveMs = nowMs;
+  }
+}
+
+float BatteryModel::predictTerminalV(float loadA) const {
+  if (_rOhm <= 0.0f || isnan(_ocv)) return NAN;
+  return _ocv - _rOhm * fabsf(loadA);
+}
+
+bool BatteryModel::predictsSagBelow(float cutoffV, float loadA) const {
+  float v = predictTerminalV(loadA);
+  return !isnan(v) && v < cutoffV;
+}
+
+uint8_t BatteryModel::stateOfHealthPct() const {
+  if (_rOhm <= 0.0f) return 0xFF;
+  // Resistance-based SOH: 100% at fresh-pack resistance, 0% at double that
+  float soh = 100.0f * (2.0f * _rNewOhm - _rOhm) / _rNewOhm;
+  if (soh < 0.0f) soh = 0.0f;
+  if (soh > 100.0f) soh = 100.0f;
+  return (uint8_t)(soh + 0.5f);
+}
+
+float BatteryModel::recommendCutoff(float tableCutoffV) const {
+  if (_steps == 0 || _rOhm <= 0.0f) return tableCutoffV;
+  // Only compensate the excess over a fresh pack; a worn pack sags more at the
+  // same state of charge, so the table value would trip it early.
+  float excess = _rOhm - _rNewOhm;
+  if (excess <= 0.0f) return tableCutoffV;
+  float comp = excess * TYPICAL_LOAD_A;
+  if (comp > MAX_CUTOFF_COMP_V) comp = MAX_CUTOFF_COMP_V;
+  return tableCutoffV - comp;
+}
@@ -0,0 +1,70 @@
+// File Overview: Declares the BatteryModel estimator that fits the source battery's
+// internal resistance and open-circuit voltage from relay switching steps, predicts
+// loaded sag for LVP early warning, and derives a state-of-health figure.
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+
+// Every relay switch produces a load-current step with a matching sag in the
+// source voltage. Each clean step gives one R = -dV/dI observation; the filtered
+// resistance plus the latest sample yield the open-circuit voltage (OCV).
+class BatteryModel {
+public:
+  void begin(Preferences* prefs);
+  void sample(float srcV, float loadA, uint32_t nowMs);
+
+  // Nominal pack voltage (12/18V) selects the fresh-battery resistance used for
+  // SOH and the stored fit for that kind of pack. A different nominal voltage
+  // than before means another pack: this boot's fit is discarded.
+  void setNominalVoltage(float nominalV);
+
+  bool  hasFit() const { return _rOhm > 0.0f; }
+  float internalResistanceOhm() const { return _rOhm; }
+  float openCircuitV() const { return _ocv; }
+
+  // Terminal voltage expected at the given load (NAN until OCV is known)
+  float predictTerminalV(float loadA) const;
+  // True when the predicted terminal voltage at loadA falls below cutoffV
+  bool  predictsSagBelow(float cutoffV, float loadA) const;
+
+  // 0..100 %, or 0xFF when no resistance fit is available yet
+  uint8_t stateOfHealthPct() const;
+
+  // Lower a table cutoff by the expected sag at a typical load so a healthy but
+  // high-resistance pack isn't tripped by its own IR drop. Only from a fit made
+  // on the connected pack this boot; a stored value may belong to another pack.
+  float recommendCutoff(float tableCutoffV) const;
+
+private:
+  void acceptStep(float dV, float dI, float v, float i, uint32_t nowMs);
+
+  Preferences* _prefs = nullptr;
+
+  float _rOhm = 0.0f;          // filtered internal resistance (0 = unknown)
+  float _ocv  = NAN;           // open-circuit voltage estimate
+  float _rNewOhm = 0.020f;     // fresh-pack resistance for SOH (set by nominal V)
+  const char* _rKey = nullptr; // NVS key for this nominal voltage (null until set)
+  uint8_t _steps = 0;          // accepted steps this boot (saturates)
+
+  // Step detector
+  bool     _havePrev = false;
+  float    _prevV = 0.0f, _prevI = 0.0f;
+  bool     _pending = false;
+  float    _baseV = 0.0f, _baseI = 0.0f;
+  uint32_t _stepAtMs = 0;
+
+  // Persistence (rate limited to spare NVS)
+  float    _savedROhm = 0.0f;
+  uint32_t _lastSaveMs = 0;
+
+  static constexpr float    STEP_MIN_A      = 0.5f;    // smallest current step worth fitting
+  static constexpr uint32_t STEP_SETTLE_MS  = 30;      // sample after relay bounce/inrush peak
+  static constexpr float    R_MIN_OHM       = 0.001f;  // reject implausible fits
+  static constexpr float    R_MAX_OHM       = 1.0f;
+  static constexpr float    R_FILTER_ALPHA  = 0.2f;    // EMA weight of each new step
+  static constexpr float    TYPICAL_LOAD_A  = 10.0f;   // load used for cutoff compensation
+  static constexpr float    MAX_CUTOFF_COMP_V = 0.8f;  // never relax a cutoff by more than this
+  static constexpr uint32_t SAVE_MIN_INTERVAL_MS = 60000;
+};
+
+extern BatteryModel battery;
@@ -0,0 +1,88 @@
+// File Overview: Declares the ProtectionState snapshot the Protector publishes each tick and
+// on every setting or latch change, and the double-buffered seqlock that lets any task,
+// core, or ISR read a consistent copy without locks.
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+// Everything a consumer needs to decide whether outputs may be driven. Readers
+// get all fields from the same tick, never a mix of two ticks.
+struct ProtectionState {
+  uint32_t version = 0;        // publish counter (0 = never published)
+  uint32_t tickMs = 0;         // millis() of the tick that produced it
+  float    lvpCutoffV = 0.0f;
+  float    ocpLimitA = 0.0f;
+  float    outvCutoffV = 0.0f;
+  int8_t   ocpTripRelay = -1;
+  bool     lvpLatched = false;
+  bool     ocpLatched = false;
+  bool     outvLatched = false;
+  bool     lvpBypass = false;
+  bool     outvBypass = false;
+  bool     revLatched = false;     // sustained reverse current (back-feed) trip
+  bool     revWarn = false;        // reverse current present, below trip level/time
+  uint8_t  revRelayMask = 0;       // relays on when reverse current was detected
+
+  bool anyLatched() const { return lvpLatched || ocpLatched || outvLatched || revLatched; }
+};
+
+// Single-writer seqlock over two slots. The writer fills the slot readers are
+// not pointed at, then flips the version, so a reader that interrupts the
+// writer (same core / ISR) still finds the previous slot complete. A reader
+// only retries if the writer published twice during its copy.
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLock payload must be trivially copyable");
+  static constexpr size_t kWords = (sizeof(T) + 3) / 4;
+
+public:
+  // Writer side: one task only
+  void publish(const T& value) {
+    uint32_t v = _version.load(std::memory_order_relaxed) + 1;
+    Slot& s = _slots[v & 1u];
+    uint32_t words[kWords] = {};
+    memcpy(words, &value, sizeof(T));
+    s.seq.store(2u * v - 1u, std::memory_order_relaxed);   // odd = being written
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kWords; ++i) s.words[i].store(words[i], std::memory_order_relaxed);
+    s.seq.store(2u * v, std::memory_order_release);
+    _version.store(v, std::memory_order_release);
+  }
+
+  // Reader side: single attempt per slot check; bounded for ISR use
+  bool tryRead(T& out, uint32_t* version = nullptr, int attempts = 4) const {
+    while (attempts-- > 0) {
+      uint32_t v = _version.load(std::memory_order_acquire);
+      const Slot& s = _slots[v & 1u];
+      uint32_t s1 = s.seq.load(std::memory_order_acquire);
+      if (s1 != 2u * v) continue;                           // writer lapped us
+      uint32_t words[kWords];
+      for (size_t i = 0; i < kWords; ++i) words[i] = s.words[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s.seq.load(std::memory_order_relaxed) != s1) continue;
+      memcpy(&out, words, sizeof(T));
+      if (version) *version = v;
+      return true;
+    }
+    return false;
+  }
+
+  // Task-context reader: retries until a consistent copy is obtained
+  T read(uint32_t* version = nullptr) const {
+    T out{};
+    while (!tryRead(out, version)) {}
+    return out;
+  }
+
+  uint32_t version() const { return _version.load(std::memory_order_acquire); }
+
+private:
+  struct Slot {
+    std::atomic<uint32_t> seq{0};
+    std::atomic<uint32_t> words[kWords] = {};
+  };
+  Slot _slots[2];
+  std::atomic<uint32_t> _version{0};
+};
@@ -37,18 +37,28 @@ void Protector::begin(Preferences* prefs, float lvpDefault, float ocpDefault) {
   // Initialize OCP grace idle; will be armed on first over-current event
   _ocpGraceUntilMs = 0;
   _ocpTripRelay = -1;
+  _revWarn = _revLatched = false;
+  _revWarnStartMs = _revTripStartMs = 0;
+  _revRelayMask = 0;
+  // Inrush envelopes survive reboots; transitions start idle
+  loadInrush();
+  _relayMaskPrev = 0;
+  _inrushActive = false;
+  publishState(millis());
 }
 
 void Protector::setOcpLimit(float amps) {
   if (amps < OCP_MIN_A) amps = OCP_MIN_A;
   if (amps > OCP_MAX_A) amps = OCP_MAX_A;
   _ocp = amps;
+  publishState(millis());
 }
 
 void Protector::setLvpCutoff(float v) {
   if (v < LVP_MIN_V) v = LVP_MIN_V;
   if (v > LVP_MAX_V) v = LVP_MAX_V;
   _lvp = v;
+  publishState(millis());
 }
 
 void Protector::setLvpBypass(bool on) {
@@ -57,40 +67,52 @@ void Protector::setLvpBypass(bool on) {
     // clear any existing LVP latch when bypassing
     _lvpLatched = false;
   }
+  publishState(millis());
 }
 
 void Protector::tripLvp() {
   if (_lvpLatched) return;
   _lvpLatched = true;
   // immediate hard cut
-  for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+  allOff();
   _cutsent = true;
 }
 
 void Protector::tripOcp() {
   if (_ocpLatched) return;
   _ocpLatched = true;
+  _inrushLearnable = false; // never learn from a tripped transition
   // Capture which relay was ON at the moment of trip (before hard cut)
   _ocpTripRelay = -1;
   for (int i = 0; i < (int)R_COUNT; ++i) {
     if (relayIsOn(i)) { _ocpTripRelay = (int8_t)i; break; }
   }
   // immediate hard cut
-  for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+  allOff();
+  _cutsent = true;
+}
+
+void Protector::tripRev() {
+  if (_revLatched) return;
+  _revLatched = true;
+  allOff();
   _cutsent = true;
 }
 
 void Protector::clearLatches() {
-  _lvpLatched = _ocpLatched = _outvLatched = false;
+  _lvpLatched = _ocpLatched = _outvLatched = _revLatched = false;
+  _revWarnStartMs = _revTripStartMs = 0;
   _belowStartMs = _overStartMs = 0;
   _outvBelowStartMs = 0;
   _cutsent = false;
+  publishState(millis());
 }
 
 void Protector::clearLvpLatch(){
   _lvpLatched = false;
   _belowStartMs = 0;
   _aboveClearStartMs = 0;
+  publishState(millis());
 }
 
 void Protector::clearOcpLatch(){
@@ -99,11 +121,20 @@ void Protector::clearOcpLatch(){
   _overStartMs = 0;
   _ocpTripRelay = -1;
   _ocpClearAllowed = false; // consume permission
+  publishState(millis());
+}
+
+void Protector::clearRevLatch(){
+  _revLatched = false;
+  _revWarn = false;
+  _revWarnStartMs = _revTripStartMs = 0;
+  publishState(millis());
 }
 
 void Protector::clearOutvLatch(){
   _outvLatched = false;
   _outvBelowStartMs = 0;
+  publishState(millis());
 }
 
 void Protector::setOutvBypass(bool on) {
@@ -112,12 +143,14 @@ void Protector::setOutvBypass(bool on) {
     _outvLatched = false; // clear existing OUTV latch when bypassed
     _outvBelowStartMs = 0;
   }
+  publishState(millis());
 }
 
 void Protector::setOutvCutoff(float v) {
   if (v < OUTV_MIN_V) v = OUTV_MIN_V;
   if (v > OUTV_MAX_V) v = OUTV_MAX_V;
   _outvCut = v;
+  publishState(millis());
 }
 
 void Protector::tick(float srcV, float loadA, float outV, uint32_t nowMs) {
@@ -160,7 +193,13 @@ void Protector::tick(float srcV, float loadA, float outV, uint32_t nowMs) {
   // Tier 1: Instant trip for extreme overcurrent (>2x OCP limit) - likely short circuit
   // Tier 2: Fast debounced trip for moderate overload (>OCP limit, <2x OCP limit)
   bool ocpSuppressed = (_ocpSuppressUntilMs != 0) && (nowMs < _ocpSuppressUntilMs);
-  if (!ocpSuppressed && haveI && loadA > _ocp) {
+  // During a relay transition the limit follows the learned inrush envelope;
+  // anything above it trips at once, anything below is tolerated inrush.
+  float inrushLim = inrushLimit(haveI ? loadA : NAN, nowMs);
+  if (inrushLim >= 0.0f) {
+    if (haveI && loadA > inrushLim && !_ocpLatched) tripOcp();
+    _overStartMs = 0;
+  } else if (!ocpSuppressed && haveI && loadA > _ocp) {
     // Check for extreme overcurrent requiring instant trip
     float instantTripThreshold = _ocp * OCP_INSTANT_MULTIPLIER;
     if (loadA >= instantTripThreshold) {
@@ -185,6 +224,26 @@ void Protector::tick(float srcV, float loadA, float outV, uint32_t nowMs) {
     // OCP will only be cleared explicitly via clearOcpLatch() after OFF is selected.
   }
 
+  // -------- Reverse current (back-feed), own debounce for warn and trip --------
+  if (haveI && loadA < -REV_WARN_A) {
+    if (_revWarnStartMs == 0) {
+      _revWarnStartMs = nowMs;
+      // Attribute to whatever was switched on when reverse flow began
+      _revRelayMask = 0;
+      _revRelayMask = relaysMask();
+    }
+    if ((nowMs - _revWarnStartMs) >= REV_WARN_MS) _revWarn = true;
+    if (loadA < -REV_TRIP_A) {
+      if (_revTripStartMs == 0) _revTripStartMs = nowMs;
+      if ((nowMs - _revTripStartMs) >= REV_TRIP_MS) tripRev();
+    } else {
+      _revTripStartMs = 0;
+    }
+  } else {
+    _revWarnStartMs = _revTripStartMs = 0;
+    _revWarn = false;            // warning is live-only; the trip latches
+  }
+
   // -------- Output Voltage Fault (dynamic): active only while under cutoff (<_outvCut) or <8V, and if >16V. --------
   if (haveOutV) {
     if (_outvBypass) {
@@ -200,7 +259,7 @@ void Protector::tick(float srcV, float loadA, float outV, uint32_t nowMs) {
         // High-side fault is immediate
         if (!_outvLatched) {
           _outvLatched = true;
-          for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+          allOff();
         }
         _outvBelowStartMs = 0;
       } else if (loExtreme || loSoft) {
@@ -209,7 +268,7 @@ void Protector::tick(float srcV, float loadA, float outV, uint32_t nowMs) {
         if ((nowMs - _outvBelowStartMs) >= _outvTripMs) {
           if (!_outvLatched) {
             _outvLatched = true;
-            for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+            allOff();
           }
         }
       } else {
@@ -239,14 +298,140 @@ void Protector::tick(float srcV, float loadA, float outV, uint32_t nowMs) {
   // -------- Continuous enforcement while latched --------
   // Previously this only cut once (gated by _cutsent). That allowed relays to be re-enabled later.
   // Now, while *either* latch is active, we force all relays OFF on every tick.
-  if (_lvpLatched || _ocpLatched || _outvLatched) {
-    for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
+  if (_lvpLatched || _ocpLatched || _outvLatched || _revLatched) {
+    allOff();
     _cutsent = true;       // keep flag for backward compatibility
   } else {
     _cutsent = false;      // reset when no latches are active
   }
+
+  // Learned envelopes go to NVS promptly only while the outputs are idle
+  _inrushBlob.service(nowMs, !_inrushActive && (relaysMask() & RELAY_MASK_OUTPUTS) == 0);
+
+  publishState(nowMs);
+}
+
+void Protector::publishState(uint32_t nowMs) {
+  ProtectionState st;
+  st.version      = _published.version() + 1;
+  st.tickMs       = nowMs;
+  st.lvpCutoffV   = _lvp;
+  st.ocpLimitA    = _ocp;
+  st.outvCutoffV  = _outvCut;
+  st.ocpTripRelay = _ocpTripRelay;
+  st.lvpLatched   = _lvpLatched;
+  st.ocpLatched   = _ocpLatched;
+  st.outvLatched  = _outvLatched;
+  st.lvpBypass    = _lvpBypass;
+  st.outvBypass   = _outvBypass;
+  st.revLatched   = _revLatched;
+  st.revWarn      = _revWarn;
+  st.revRelayMask = _revRelayMask;
+  _published.publish(st);
 }
 
 void Protector::setOcpHold(bool on) {
   _ocpHold = on;
 }
+
+// ----------------------------------------------------------------------------
+// Inrush envelopes
+// ----------------------------------------------------------------------------
+
+float Protector::inrushEnvelopeA(int relay, int bucket) const {
+  if (relay < 0 || relay >= (int)R_COUNT || bucket < 0 || bucket >= INRUSH_BUCKETS) return 0.0f;
+  return _inrush[relay].learned ? _inrush[relay].peakA[bucket] : 0.0f;
+}
+
+bool Protector::inrushLearned(int relay) const {
+  return relay >= 0 && relay < (int)R_COUNT && _inrush[relay].learned > 0;
+}
+
+float Protector::inrushLimit(float loadA, uint32_t nowMs) {
+  uint8_t mask = relaysMask();
+  uint8_t rising = mask & (uint8_t)~_relayMaskPrev;
+  _relayMaskPrev = mask;
+
+  if (rising) {
+    // Enabling the 12V buck energizes every output already on at that moment
+    uint8_t watch = rising;
+    if (rising & (1u << R_ENABLE)) watch |= mask;
+    if (_inrushActive) {
+      // Overlapping transition: watch the union, but don't learn from it
+      watch |= (_inrushMask & mask);
+      _inrushLearnable = false;
+    } else {
+      uint8_t outputs = watch & (uint8_t)~(1u << R_ENABLE);
+      _inrushLearnable = (outputs != 0) && ((outputs & (outputs - 1)) == 0);
+    }
+    _inrushMask = watch;
+    // Start the window at the actual edge (flasher/sequencer switch from a timer
+    // between ticks), not at the tick that noticed it
+    _inrushStartMs = nowMs;
+    for (int i = 0; i < (int)R_COUNT; ++i) {
+      if (!(rising & (1u << i))) continue;
+      uint32_t edgeMs = relayLastEdgeMs(static_cast<RelayIndex>(i));
+      if (edgeMs != 0 && (nowMs - edgeMs) < INRUSH_BUCKETS * INRUSH_BUCKET_MS && (int32_t)(edgeMs - _inrushStartMs) < 0) {
+        _inrushStartMs = edgeMs;
+      }
+    }
+    _inrushActive = true;
+    for (int b = 0; b < INRUSH_BUCKETS; ++b) _inrushPeakA[b] = -1.0f;
+  }
+
+  if (!_inrushActive) return -1.0f;
+
+  uint32_t t = nowMs - _inrushStartMs;
+  int b = (int)(t / INRUSH_BUCKET_MS);
+  if (b >= INRUSH_BUCKETS) {
+    // Window over: settled current must be healthy before we learn from it
+    if (_inrushLearnable && !isnan(loadA) && loadA <= _ocp) commitInrush(nowMs);
+    _inrushActive = false;
+    return -1.0f;
+  }
+  if (!isnan(loadA) && loadA > _inrushPeakA[b]) _inrushPeakA[b] = loadA;
+
+  const float ceiling = _ocp * OCP_INSTANT_MULTIPLIER;
+  float envSum = 0.0f;
+  for (int i = 0; i < (int)R_COUNT; ++i) {
+    if (!(_inrushMask & (1u << i))) continue;
+    if (!_inrush[i].learned) return ceiling; // unknown load: short-circuit ceiling only
+    envSum += _inrush[i].peakA[b];
+  }
+  float lim = envSum * INRUSH_MARGIN + INRUSH_OFFSET_A;
+  if (lim < _ocp) lim = _ocp;
+  if (lim > ceiling) lim = ceiling;
+  return lim;
+}
+
+void Protector::commitInrush(uint32_t nowMs) {
+  int ch = -1;
+  for (int i = 0; i < (int)R_ENABLE; ++i) if (_inrushMask & (1u << i)) { ch = i; break; }
+  if (ch < 0) return;
+
+  InrushEnvelope& env = _inrush[ch];
+  bool changed = false;
+  float last = 0.0f;
+  for (int b = 0; b < INRUSH_BUCKETS; ++b) {
+    // Buckets the loop didn't sample inherit the previous bucket's peak
+    float obs = (_inrushPeakA[b] >= 0.0f) ? _inrushPeakA[b] : last;
+    last = obs;
+    float prev = env.peakA[b];
+    float next;
+    if (!env.learned)     next = obs;
+    else if (obs > prev)  next = obs;                            // grow immediately
+    else                  next = prev + 0.25f * (obs - prev);    // decay slowly
+    if (fabsf(next - prev) >= INRUSH_SAVE_DELTA_A) changed = true;
+    env.peakA[b] = next;
+  }
+  if (!env.learned) changed = true;
+  if (env.learned < 0xFF) env.learned++;
+  if (changed) _inrushBlob.markDirty(nowMs);
+}
+
+void Protector::loadInrush() {
+  _inrushBlob.begin(_prefs, KEY_INRUSH_ENV, _inrush, sizeof(_inrush), INRUSH_SAVE_MIN_MS, INRUSH_SAVE_MAX_MS);
+  if (!_inrushBlob.load()) {
+    for (int i = 0; i < (int)R_COUNT; ++i) _inrush[i] = InrushEnvelope{};
+  }
+}
@@ -3,6 +3,9 @@
 #pragma once
 #include <Arduino.h>
 #include <Preferences.h>
+#include "relays.hpp"
+#include "ProtectionState.hpp"
+#include "storage/CoalescedBlob.hpp"
 
 // Simple LVP/OCP protector. Debounced, latched trips; relay cut on trip.
 // LVP can be bypassed via setLvpBypass(true).
@@ -11,13 +14,26 @@ public:
   void begin(Preferences* prefs, float lvpDefault = 16.5f, float ocpDefault = 22.0f);
   void tick(float srcV, float loadA, float outV, uint32_t nowMs);
 
+  // Consistent snapshot published at the end of every tick and by every setter
+  // or latch clear below, so a reader never sees a cleared latch or new cutoff
+  // late. Safe from any task, core, or ISR (use tryState() in ISRs). The
+  // getters below read live fields and belong to the loop task that drives
+  // tick() and calls the setters.
+  ProtectionState state() const { return _published.read(); }
+  bool tryState(ProtectionState& out) const { return _published.tryRead(out); }
+
   bool isLvpLatched() const { return _lvpLatched; }
   bool isOcpLatched() const { return _ocpLatched; }
   bool isOutvLatched() const { return _outvLatched; }
+  bool isRevLatched() const { return _revLatched; }
+  bool revWarning() const { return _revWarn; }
+  // Relay mask (bit per RelayIndex) that was ON when reverse current was seen
+  uint8_t revRelayMask() const { return _revRelayMask; }
   void clearLatches();      // clears both latches
   void clearLvpLatch();     // clear only LVP latch
   void clearOcpLatch();     // clear only OCP latch
   void clearOutvLatch();    // clear only OUTV latch
+  void clearRevLatch();     // clear only reverse-current latch
   // Prevent automatic OCP clear while interlock is active
   void setOcpHold(bool on);
   // Relay index that was ON when OCP tripped; -1 if unknown
@@ -26,6 +42,12 @@ public:
   void setOcpClearAllowed(bool on) { _ocpClearAllowed = on; }
   // Transient suppression: ignore OCP detection until the given time
   void suppressOcpUntil(uint32_t untilMs) { _ocpSuppressUntilMs = untilMs; }
+  // Learned inrush envelope: peak current in a 50 ms bucket after the channel
+  // switched on (0 if not yet learned)
+  float inrushEnvelopeA(int relay, int bucket) const;
+  bool  inrushLearned(int relay) const;
+  // Write learned envelopes still held back by the rate limit (before OTA, on LVP)
+  void  flushLearned(uint32_t nowMs) { _inrushBlob.flush(nowMs); }
 
   // LVP bypass control
   void setLvpBypass(bool on);
@@ -46,6 +68,13 @@ public:
 private:
   void tripLvp();
   void tripOcp();
+  void tripRev();
+  void publishState(uint32_t nowMs);
+  // Inrush envelope tracking; returns the OCP limit to apply this tick, or a
+  // negative value when no relay transition is in progress
+  float inrushLimit(float loadA, uint32_t nowMs);
+  void  commitInrush(uint32_t nowMs);
+  void  loadInrush();
 
   Preferences* _prefs = nullptr;
   float _lvp = 17.0f;   // volts
@@ -89,6 +118,19 @@ private:
   bool  _ocpClearAllowed = false; // gate explicit clears
   uint32_t _ocpSuppressUntilMs = 0; // transient ignore window for OCP
 
+  // -------- Reverse current / back-feed (signed load current) --------
+  // A trailer with its own breakaway battery can push current back into the
+  // box. Small sustained reverse current warns; larger sustained current trips.
+  static constexpr float    REV_WARN_A  = 0.5f;   // |I| below zero that counts as reverse
+  static constexpr uint32_t REV_WARN_MS = 500;    // sustain before warning
+  static constexpr float    REV_TRIP_A  = 3.0f;   // reverse current that trips
+  static constexpr uint32_t REV_TRIP_MS = 100;    // sustain before tripping
+  uint32_t _revWarnStartMs = 0;
+  uint32_t _revTripStartMs = 0;
+  bool     _revWarn = false;
+  bool     _revLatched = false;
+  uint8_t  _revRelayMask = 0;
+
   // LVP bypass: when true, LVP never trips (and existing LVP latch is cleared)
   bool  _lvpBypass = false;
 
@@ -100,6 +142,35 @@ private:
   // the window do we begin normal debounce and trip.
   uint32_t _ocpGraceUntilMs = 0;   // 0 = idle; else timestamp when grace ends
   // OCP no longer auto-clears; explicit clear via clearOcpLatch()
+
+  // -------- Learned inrush envelopes (replaces fixed post-switch OCP blinding) --------
+  // When a relay turns on, OCP stays armed: current is compared against the
+  // channel's learned peak-per-bucket envelope (plus margin) instead of the
+  // steady OCP limit. Unlearned channels get the instant-trip ceiling, so a short
+  // still trips immediately. Clean single-channel transitions refine the envelope.
+  static constexpr int      INRUSH_BUCKETS   = 8;
+  static constexpr uint32_t INRUSH_BUCKET_MS = 50;    // 8 x 50 ms = 400 ms window
+  static constexpr float    INRUSH_MARGIN    = 1.25f; // multiplicative headroom over envelope
+  static constexpr float    INRUSH_OFFSET_A  = 1.0f;  // additive headroom (sensor noise)
+  static constexpr float    INRUSH_SAVE_DELTA_A = 0.5f; // persist only material changes
+  // Every turn flash is a learnable edge: write at most once a minute while
+  // idle, once per 5 minutes while switching (same bounds as relay wear)
+  static constexpr uint32_t INRUSH_SAVE_MIN_MS = 60000;
+  static constexpr uint32_t INRUSH_SAVE_MAX_MS = 300000;
+  struct InrushEnvelope {
+    float   peakA[INRUSH_BUCKETS];
+    uint8_t learned;                 // clean captures folded in (saturates)
+  };
+  InrushEnvelope _inrush[R_COUNT] = {};
+  CoalescedBlob  _inrushBlob;
+  uint8_t  _relayMaskPrev = 0;
+  uint8_t  _inrushMask = 0;          // channels whose inrush is being watched
+  uint32_t _inrushStartMs = 0;
+  bool     _inrushActive = false;
+  bool     _inrushLearnable = false; // single channel, no overlap, no trip
+  float    _inrushPeakA[INRUSH_BUCKETS] = {};
+
+  SeqLock<ProtectionState> _published;
 };
 
 extern Protector protector;
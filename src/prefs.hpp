@@ -12,7 +12,7 @@ static constexpr const char* KEY_LV_CUTOFF   = "lv_cut";
 static constexpr const char* KEY_OCP         = "ocp_a";
 static constexpr const char* KEY_OUTV_CUTOFF = "outv_cut"; // output (buck) voltage cutoff user setting
 static constexpr const char* RF_PREF_KEYS[6] = {"rf_left","rf_right","rf_brake","rf_tail","rf_marker","rf_aux"};
-// UI mode: 0=HD, 1=RV
+// Channel mapping profile id: 0=7-way HD, 1=7-way RV, 2=4-way, 3=6-way, 4=custom
 static constexpr const char* KEY_UI_MODE     = "ui_mode";
 
 static constexpr const char* KEY_OTA_URL     = "ota_url";
@@ -22,6 +22,32 @@ static constexpr const char* KEY_CURR_INV    = "cur_inv";
 static constexpr const char* KEY_RF_BB_ORIENT = "rf_bb_or";
 // Extreme current event detection (for buck OCP shutdown detection)
 static constexpr const char* KEY_EXTREME_I = "ext_i";
+// Last fitted battery internal resistance (ohms), one per nominal pack voltage.
+// Shown (SOH, sag prediction) until this boot's first fit; never used for the cutoff.
+static constexpr const char* KEY_BATT_RINT_12 = "batt_rint12";
+static constexpr const char* KEY_BATT_RINT_18 = "batt_rint18";
+// Learned per-relay inrush envelopes (blob, see Protector)
+static constexpr const char* KEY_INRUSH_ENV = "inrush_env";
+// Stored relay test programs, one blob per slot ("seq0".."seq3", see Sequencer)
+static constexpr const char* KEY_SEQ_FMT = "seq%u";
+// Flasher: rate (flashes/min), ON duty (%), and LEFT/RIGHT flash option (bool)
+static constexpr const char* KEY_FLASH_FPM  = "flash_fpm";
+static constexpr const char* KEY_FLASH_DUTY = "flash_duty";
+static constexpr const char* KEY_FLASH_TURN = "flash_turn";
+// Per-channel and per-combination load baselines (blob, see BleedDetector)
+static constexpr const char* KEY_CH_BASELINE = "ch_base";
+// Relay wear counters (blob, coalesced writes, see relay_wear)
+static constexpr const char* KEY_RELAY_WEAR = "relay_wear";
+// Custom channel mapping profile uploaded over BLE (blob, see channel_map)
+static constexpr const char* KEY_CH_PROFILE = "ch_prof";
+// Name of the trailer profile new wiring diagnostics are compared against (see TrailerStore)
+static constexpr const char* KEY_TRAILER_ACTIVE = "trl_active";
+// Trailer store change counter, bumped before each data file change the index must follow
+static constexpr const char* KEY_TRAILER_GEN = "trl_gen";
+// Learned RF remote codes, all slots (blob, see RfCodeTable)
+static constexpr const char* KEY_RF_CODES = "rf_codes";
+// RF fast response: exact frames needed to fire before the burst ends (0 = off, see BurstVoter)
+static constexpr const char* KEY_RF_FAST = "rf_fast";
 #define KEY_FW_VER       "fw_ver"
 #ifndef OTA_LATEST_ASSET_URL
 #define OTA_LATEST_ASSET_URL ""
@@ -30,9 +56,3 @@ static constexpr const char* KEY_EXTREME_I = "ext_i";
 #ifndef FW_VERSION
 #define FW_VERSION "unknown"
 #endif
-
-// Lightweight accessor for UI mode from global prefs; returns 0 (HD) if unset
-inline uint8_t getUiMode() {
-	extern Preferences prefs;
-	return prefs.getUChar(KEY_UI_MODE, 0);
-}
@@ -0,0 +1,110 @@
+// File Overview: Implements relay wear accounting: edge-count deltas, switched-current
+// attribution across loop passes, coalesced persistence and life estimates.
+#include "relay_wear.hpp"
+#include <math.h>
+#include "prefs.hpp"
+#include "storage/CoalescedBlob.hpp"
+
+namespace {
+  struct Stored {
+    uint32_t cycles[R_COUNT];
+    float    switchedA[R_COUNT];
+  };
+
+  Stored        g_data = {};
+  CoalescedBlob g_blob;
+  uint32_t      g_lastEdges[R_COUNT] = {};
+  uint8_t       g_prevMask = 0;
+  float         g_prevA = 0.0f;
+  bool          g_havePrev = false;
+
+  // Written at most every 5 minutes while switching, and promptly (1 min) when
+  // everything is off; a power cut loses at most a few minutes of counts.
+  constexpr uint32_t SAVE_MIN_INTERVAL_MS = 60000;
+  constexpr uint32_t SAVE_MAX_DELAY_MS    = 300000;
+}
+
+namespace RelayWear {
+
+void begin(Preferences* prefs){
+  g_blob.begin(prefs, KEY_RELAY_WEAR, &g_data, sizeof(g_data), SAVE_MIN_INTERVAL_MS, SAVE_MAX_DELAY_MS);
+  if (!g_blob.load()) g_data = Stored{};
+  for (int i = 0; i < (int)R_COUNT; ++i) g_lastEdges[i] = relayEdgeCount((RelayIndex)i);
+  g_prevMask = relaysMask();
+  g_havePrev = false;
+}
+
+void service(float loadA, uint32_t nowMs){
+  bool changed = false;
+  for (int i = 0; i < (int)R_COUNT; ++i) {
+    uint32_t e = relayEdgeCount((RelayIndex)i);
+    if (e != g_lastEdges[i]) {
+      g_data.cycles[i] += e - g_lastEdges[i];
+      g_lastEdges[i] = e;
+      changed = true;
+    }
+  }
+
+  const uint8_t mask = relaysMask();
+  const float a = isnan(loadA) ? NAN : fabsf(loadA);
+  if (g_havePrev && !isnan(a) && mask != g_prevMask) {
+    const uint8_t diff = mask ^ g_prevMask;
+    float stepA;
+    if ((diff & relayBit(R_ENABLE)) && !(mask & relayBit(R_ENABLE))) {
+      // Master contact opened: it broke whatever was flowing
+      stepA = g_prevA;
+      g_data.switchedA[R_ENABLE] += stepA;
+    } else {
+      stepA = fabsf(a - g_prevA);
+      int n = 0;
+      for (int i = 0; i < (int)R_COUNT; ++i) if (diff & (1u << i)) n++;
+      for (int i = 0; i < (int)R_COUNT; ++i) {
+        if (diff & (1u << i)) g_data.switchedA[i] += stepA / (float)n;
+      }
+    }
+    changed = true;
+  }
+  g_prevMask = mask;
+  if (!isnan(a)) { g_prevA = a; g_havePrev = true; }
+
+  if (changed) g_blob.markDirty(nowMs);
+  g_blob.service(nowMs, (mask & RELAY_MASK_OUTPUTS) == 0);
+}
+
+void flush(){
+  g_blob.flush(millis());
+}
+
+Channel channel(RelayIndex r){
+  Channel c;
+  if ((int)r >= (int)R_COUNT) return c;
+  c.cycles = g_data.cycles[r];
+  c.switchedA = g_data.switchedA[r];
+  const float mech = (float)c.cycles / (float)MECH_LIFE_OPS;
+  const float elec = c.switchedA / (RATED_A * (float)ELEC_LIFE_OPS);
+  const float used = mech > elec ? mech : elec;
+  c.usedPct = used * 100.0f;
+  if (used >= 1.0f) {
+    c.remainingCycles = 0;
+  } else if (c.cycles == 0) {
+    c.remainingCycles = MECH_LIFE_OPS;
+  } else {
+    // Life fraction per cycle so far, projected over what is left
+    const float perCycle = used / (float)c.cycles;
+    const float left = (1.0f - used) / perCycle;
+    c.remainingCycles = left > 4.0e9f ? 4000000000u : (uint32_t)left;
+  }
+  return c;
+}
+
+RelayIndex worst(){
+  RelayIndex w = R_LEFT;
+  float best = -1.0f;
+  for (int i = 0; i < (int)R_COUNT; ++i) {
+    float p = channel((RelayIndex)i).usedPct;
+    if (p > best) { best = p; w = (RelayIndex)i; }
+  }
+  return w;
+}
+
+} // namespace RelayWear
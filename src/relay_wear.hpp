@@ -0,0 +1,40 @@
+// File Overview: Declares relay wear accounting: per-channel switching cycles and the
+// load current switched at each edge (contact arc estimate), persisted through a
+// coalescing NVS layer, with end-of-life estimates for the UI and BLE.
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+#include "relays.hpp"
+
+// Cycles come from the relay driver's edge counters, so timer-driven edges
+// (flasher, sequencer) are never missed. Switched current is the step in load
+// current seen by the loop across an edge, shared by the channels that changed
+// together; R_ENABLE breaking interrupts the whole load and is charged for it.
+//
+// Wear is the larger of mechanical use (cycles / MECH_LIFE_OPS) and electrical
+// use (switched amps / (RATED_A * ELEC_LIFE_OPS)), i.e. each operation costs
+// I/RATED_A of a rated-load operation. Figures are for a typical 30A
+// automotive relay.
+namespace RelayWear {
+  static constexpr uint32_t MECH_LIFE_OPS = 1000000;
+  static constexpr uint32_t ELEC_LIFE_OPS = 100000;
+  static constexpr float    RATED_A       = 30.0f;
+
+  struct Channel {
+    uint32_t cycles = 0;           // OFF->ON operations, lifetime
+    float    switchedA = 0.0f;     // sum of current switched at make and break
+    float    usedPct = 0.0f;       // 0..100+ of rated life
+    uint32_t remainingCycles = 0;  // at this channel's average switched current
+  };
+
+  void begin(Preferences* prefs);
+
+  // Loop task, once per pass after the outputs were enforced
+  void service(float loadA, uint32_t nowMs);
+
+  // Persist pending counts now (before OTA, when the supply is failing)
+  void flush();
+
+  Channel    channel(RelayIndex r);
+  RelayIndex worst();              // channel with the highest usedPct
+}
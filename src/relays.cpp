@@ -1,6 +1,81 @@
-// File Overview: Provides the single definition of the relay state array referenced by
-// the inline helpers, keeping ON/OFF tracking consistent across modules.
+// File Overview: Implements the shadow-state relay driver behind the inline helpers,
+// applying channel changes as single GPIO output-enable register writes.
 #include "relays.hpp"
+#include "soc/gpio_reg.h"
 
 // Shared relay state storage definition (one definition for the whole program)
-bool g_relay_on[R_COUNT] = {false, false, false, false, false, false, false};
+volatile uint8_t g_relay_mask = 0;
+
+namespace {
+  portMUX_TYPE     s_mux = portMUX_INITIALIZER_UNLOCKED;
+  uint32_t         s_enBitLo[R_COUNT];     // GPIO0..31 output-enable bit per channel
+  uint32_t         s_enBitHi[R_COUNT];     // GPIO32..48 output-enable bit per channel
+  uint32_t         s_edges[R_COUNT];
+  uint32_t         s_lastEdgeMs[R_COUNT];
+  RelayDriverStats s_stats;
+
+  inline void enableBits(uint8_t mask, uint32_t& lo, uint32_t& hi) {
+    lo = 0; hi = 0;
+    for (int i = 0; i < (int)R_COUNT; ++i) {
+      if (mask & (1u << i)) { lo |= s_enBitLo[i]; hi |= s_enBitHi[i]; }
+    }
+  }
+}
+
+void relaysBegin(){
+  portENTER_CRITICAL(&s_mux);
+  g_relay_mask = 0;
+  portEXIT_CRITICAL(&s_mux);
+  for (int i = 0; i < (int)R_COUNT; ++i){
+    const int pin = RELAY_PIN[i];
+    pinMode(pin, INPUT);          // OFF = high-Z; also routes the pad to plain GPIO out
+    digitalWrite(pin, LOW);       // preload OUT latch; enabling the driver now sinks
+    s_enBitLo[i] = (pin < 32)  ? (1u << pin) : 0u;
+    s_enBitHi[i] = (pin >= 32) ? (1u << (pin - 32)) : 0u;
+    s_edges[i] = 0;
+    s_lastEdgeMs[i] = 0;
+  }
+}
+
+void relaysUpdate(uint8_t clearMask, uint8_t setMask){
+  const uint32_t nowMs = millis();
+  portENTER_CRITICAL(&s_mux);
+  s_stats.requests++;
+  const uint8_t prev = g_relay_mask;
+  const uint8_t next = (uint8_t)(((prev & ~clearMask) | setMask) & RELAY_MASK_ALL);
+  const uint8_t goingOff = prev & ~next;
+  const uint8_t goingOn  = next & ~prev;
+  if (goingOff | goingOn) {
+    uint32_t offLo, offHi, onLo, onHi;
+    enableBits(goingOff, offLo, offHi);
+    enableBits(goingOn, onLo, onHi);
+    // Break before make: release channels before sinking new ones
+    if (offLo) { REG_WRITE(GPIO_ENABLE_W1TC_REG,  offLo); s_stats.regWrites++; }
+    if (offHi) { REG_WRITE(GPIO_ENABLE1_W1TC_REG, offHi); s_stats.regWrites++; }
+    if (onLo)  { REG_WRITE(GPIO_ENABLE_W1TS_REG,  onLo);  s_stats.regWrites++; }
+    if (onHi)  { REG_WRITE(GPIO_ENABLE1_W1TS_REG, onHi);  s_stats.regWrites++; }
+    g_relay_mask = next;
+    for (int i = 0; i < (int)R_COUNT; ++i) {
+      const uint8_t bit = (uint8_t)(1u << i);
+      if ((goingOff | goingOn) & bit) s_lastEdgeMs[i] = nowMs;
+      if (goingOn & bit) s_edges[i]++;
+    }
+    s_stats.applies++;
+  }
+  portEXIT_CRITICAL(&s_mux);
+}
+
+uint32_t relayEdgeCount(RelayIndex r){
+  return ((int)r < (int)R_COUNT) ? s_edges[(int)r] : 0;
+}
+
+uint32_t relayLastEdgeMs(RelayIndex r){
+  return ((int)r < (int)R_COUNT) ? s_lastEdgeMs[(int)r] : 0;
+}
+
+RelayDriverStats relaysStats(){
+  portENTER_CRITICAL(&s_mux);
+  RelayDriverStats s = s_stats;
+  portEXIT_CRITICAL(&s_mux);
+  return s;
+}
@@ -20,28 +20,47 @@ enum RelayIndex : uint8_t {
 static_assert(sizeof(RELAY_PIN) / sizeof(RELAY_PIN[0]) == R_COUNT,
               "RELAY_PIN[] size must equal R_COUNT");
 
-// We track software state since OFF uses high-Z (INPUT)
+// Shadow of the driven state, one bit per RelayIndex (bit set = ON)
 // Single shared definition provided in relays.cpp
-extern bool g_relay_on[R_COUNT];
+extern volatile uint8_t g_relay_mask;
+
+inline constexpr uint8_t relayBit(RelayIndex r) { return (uint8_t)(1u << (uint8_t)r); }
+static constexpr uint8_t RELAY_MASK_ALL     = (uint8_t)((1u << R_COUNT) - 1u);
+static constexpr uint8_t RELAY_MASK_OUTPUTS = (uint8_t)(RELAY_MASK_ALL & ~relayBit(R_ENABLE));
 
 // ----- Open-drain emulation on 3.3V MCU driving 5V LOW-trigger inputs -----
-// ON  = sink to GND  -> pinMode(OUTPUT); digitalWrite(LOW)
-// OFF = high-impedance -> pinMode(INPUT) (no pullup)
+// ON  = sink to GND       -> output driver enabled, OUT latch LOW
+// OFF = high-impedance    -> output driver disabled (board's pull-up drives it HIGH)
+//
+// The OUT latch is preloaded LOW once in relaysBegin(); switching afterwards only
+// flips output-enable bits through the GPIO W1TC/W1TS registers. All channel
+// changes of one call are written inside a single critical section (releases
+// first, then sinks), and nothing touches hardware when the shadow already matches.
 
-inline void _sinkOn(int pin) {
-  pinMode(pin, OUTPUT);
-  digitalWrite(pin, LOW);        // actively pull low
-}
+// Pin-operation accounting for the driver (scripts/relay_driver checks it against the pads)
+struct RelayDriverStats {
+  uint32_t requests = 0;    // update calls
+  uint32_t applies = 0;     // calls that changed at least one channel
+  uint32_t regWrites = 0;   // GPIO register writes issued
+};
 
-inline void _floatOff(int pin) {
-  pinMode(pin, INPUT);           // high-Z; board's pull-up drives it HIGH (OFF)
-  // (do NOT enable INPUT_PULLUP here)
-}
+// One-time setup: ensure every channel is OFF (floating)
+void relaysBegin();
+
+// Channels in clearMask go OFF, then channels in setMask go ON, as one transition
+void relaysUpdate(uint8_t clearMask, uint8_t setMask);
+// Drive exactly the channels in mask ON, everything else OFF
+inline void relaysApply(uint8_t mask) { relaysUpdate(RELAY_MASK_ALL, mask); }
+inline uint8_t relaysMask() { return g_relay_mask; }
+
+uint32_t relayEdgeCount(RelayIndex r);    // OFF->ON transitions since boot
+uint32_t relayLastEdgeMs(RelayIndex r);   // millis() of the last change (0 = never)
+RelayDriverStats relaysStats();
 
 // Core controls
-inline void relayOn(RelayIndex r)  { _sinkOn(RELAY_PIN[(int)r]); g_relay_on[(int)r] = true; }
-inline void relayOff(RelayIndex r) { _floatOff(RELAY_PIN[(int)r]); g_relay_on[(int)r] = false; }
-inline bool relayIsOn(RelayIndex r){ return g_relay_on[(int)r]; }
+inline void relayOn(RelayIndex r)  { relaysUpdate(0, relayBit(r)); }
+inline void relayOff(RelayIndex r) { relaysUpdate(relayBit(r), 0); }
+inline bool relayIsOn(RelayIndex r){ return (g_relay_mask & relayBit(r)) != 0; }
 
 // int overloads for convenience
 inline void relayOn(int r)         { relayOn((RelayIndex)r); }
@@ -53,17 +72,7 @@ inline void relayToggle(RelayIndex r){
 }
 
 // All OFF at once
-inline void allOff(){
-  for (int i = 0; i < (int)R_COUNT; ++i) relayOff(i);
-}
-
-// One-time setup: ensure every channel is OFF (floating)
-inline void relaysBegin(){
-  for (int i = 0; i < (int)R_COUNT; ++i){
-    _floatOff(RELAY_PIN[i]);      // OFF = INPUT (high-Z)
-    g_relay_on[i] = false;
-  }
-}
+inline void allOff(){ relaysApply(0); }
 
 // Optional: stable display names for primary user relays
 inline const char* relayName(RelayIndex r){
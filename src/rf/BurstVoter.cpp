@@ -0,0 +1,83 @@
+// File Overview: Implements burst voting (weighted per-slot votes, EV-first winner choice,
+// unambiguous-only fallback for short frames), the fast first-confident-frame trigger and
+// the post-trigger cooldown.
+#include "BurstVoter.hpp"
+
+void BurstVoter::reset() {
+  _active = false;
+  _lastMs = 0;
+  _startMs = 0;
+  _anyEv = false;
+  _fired = false;
+  _streakSlot = -1;
+  _streak = 0;
+  for (uint8_t i = 0; i < SLOTS; ++i) { _votes[i] = 0; _coarseVotes[i] = 0; _bestScore[i] = 0xFFFFFFFFu; }
+}
+
+int BurstVoter::vote(uint8_t slot, bool evFrame, uint32_t score, uint32_t nowMs) {
+  if (slot >= SLOTS) return -1;
+  if (!_active) { reset(); _active = true; _startMs = nowMs; }
+  _lastMs = nowMs;
+  if (_fired) return -1;                       // tail of a press that already fired
+  if (evFrame) {
+    _anyEv = true;
+    uint16_t v = (uint16_t)_votes[slot] + 2;   // EV frames are reliable, count more
+    _votes[slot] = (uint8_t)(v > 255 ? 255 : v);
+    if (score < _bestScore[slot]) _bestScore[slot] = score;
+  } else if (!_anyEv) {
+    // Only track coarse votes if no EV frames seen in this burst
+    uint16_t v = (uint16_t)_coarseVotes[slot] + 1;
+    _coarseVotes[slot] = (uint8_t)(v > 255 ? 255 : v);
+  }
+  return fastWinner(slot, evFrame && score == 0);
+}
+
+int BurstVoter::fastWinner(uint8_t slot, bool exact) {
+  if (!_fastConfirm) return -1;
+  if (!exact) { _streak = 0; return -1; }
+  if (_streakSlot != (int8_t)slot) { _streakSlot = (int8_t)slot; _streak = 0; }
+  if (_streak < 255) _streak++;
+  if (_streak < _fastConfirm) return -1;
+  // Another button heard in this burst: ambiguous, leave it to the end-of-burst vote
+  for (uint8_t i = 0; i < SLOTS; ++i) {
+    if (i != slot && (_votes[i] || _coarseVotes[i])) return -1;
+  }
+  _fired = true;
+  return slot;
+}
+
+int BurstVoter::pickWinner() const {
+  int winner = -1;
+  if (_anyEv) {
+    uint8_t bestVotes = 0; uint32_t bestScore = 0xFFFFFFFFu;
+    for (uint8_t i = 0; i < SLOTS; ++i) {
+      const uint8_t v = _votes[i];
+      if (!v) continue;
+      const uint32_t sc = _bestScore[i];
+      if (v > bestVotes || (v == bestVotes && sc < bestScore)) {
+        bestVotes = v; bestScore = sc; winner = i;
+      }
+    }
+  } else {
+    // Fallback: short frames decide only if unambiguous (single non-zero bucket)
+    int nz = 0;
+    for (uint8_t i = 0; i < SLOTS; ++i) { if (_coarseVotes[i]) { nz++; winner = i; } }
+    if (nz != 1) winner = -1;
+  }
+  return winner;
+}
+
+bool BurstVoter::poll(uint32_t nowMs, int& winner) {
+  winner = -1;
+  if (!_active) return false;
+  if (_fired) {
+    if ((nowMs - _lastMs) <= GAP_MS) return false;
+    reset();
+    return true;
+  }
+  if ((nowMs - _lastMs) <= GAP_MS && (nowMs - _startMs) <= MAX_MS) return false;
+  winner = pickWinner();
+  if (winner >= 0) block(nowMs);
+  reset();
+  return true;
+}
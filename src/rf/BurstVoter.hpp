@@ -0,0 +1,58 @@
+// File Overview: Declares the RF button-burst vote aggregator: frames of one key press are
+// collected per slot, a winner is picked once the burst goes quiet (or, in fast mode, on
+// the first confident frame), and the tail of the press is swallowed.
+#pragma once
+#include <stdint.h>
+
+// Plain C++ (time is passed in), so the replay harness drives the exact logic
+// RF::service() runs, at whatever speed it likes.
+class BurstVoter {
+public:
+  static constexpr uint8_t  SLOTS       = 8;      // RF::SLOT_COUNT
+  static constexpr uint32_t COOLDOWN_MS = 1000;   // suppress repeats after a trigger (1s debounce)
+  static constexpr uint32_t GAP_MS      = 250;    // gap indicating end of a button-burst
+  static constexpr uint32_t MAX_MS      = 500;    // finalize even if still noisy after this window
+  static constexpr uint8_t  FAST_CONFIRM_MAX = 3;
+
+  // Fast mode: fire as soon as one slot has 'frames' consecutive exact frames
+  // (structured, score 0) and no other slot has voted in the burst. Each frame
+  // is already two identical captures. The rest of the burst - until GAP_MS of
+  // quiet, however long the button is held - only suppresses repeats, with no
+  // cooldown after it. 0 = off: wait for the end of the burst, then cooldown.
+  void setFastConfirm(uint8_t frames) { _fastConfirm = frames > FAST_CONFIRM_MAX ? FAST_CONFIRM_MAX : frames; }
+  uint8_t fastConfirm() const { return _fastConfirm; }
+
+  void reset();                                   // drop the burst in progress
+  bool active() const { return _active; }
+  uint32_t startMs() const { return _startMs; }
+
+  bool blocked(uint32_t nowMs) const { return (int32_t)(nowMs - _blockUntil) < 0; }
+  void block(uint32_t nowMs) { _blockUntil = nowMs + COOLDOWN_MS; }
+
+  // One matched frame. EV-class frames (from a chip decoder) count double and
+  // win over any number of short-frame votes; 'score' breaks ties (lower wins).
+  // Returns the slot to fire right away (fast mode), else -1.
+  int vote(uint8_t slot, bool evFrame, uint32_t score, uint32_t nowMs);
+
+  // True once the burst is over (quiet for GAP_MS or older than MAX_MS);
+  // 'winner' is the slot to fire or -1, and the cooldown starts on a winner.
+  // A burst that already fired in fast mode ends on quiet only, with no winner.
+  bool poll(uint32_t nowMs, int& winner);
+
+private:
+  int  pickWinner() const;
+  int  fastWinner(uint8_t slot, bool exact);
+
+  bool     _active = false;
+  uint32_t _lastMs = 0;
+  uint32_t _startMs = 0;
+  uint32_t _blockUntil = 0;
+  uint8_t  _votes[SLOTS] = {};
+  uint32_t _bestScore[SLOTS] = {};
+  uint8_t  _coarseVotes[SLOTS] = {};
+  bool     _anyEv = false;
+  uint8_t  _fastConfirm = 0;
+  bool     _fired = false;         // fast mode fired this burst
+  int8_t   _streakSlot = -1;
+  uint8_t  _streak = 0;            // consecutive exact frames for _streakSlot
+};
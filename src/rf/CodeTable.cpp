@@ -0,0 +1,106 @@
+// File Overview: Implements the learned-remote hash table (linear probing, no deletes
+// other than clear) and its little-endian blob encoding.
+#include "CodeTable.hpp"
+
+void RfCodeTable::clear() {
+  for (uint16_t i = 0; i < CAPACITY; ++i) _b[i] = RfCode{};
+  _count = 0;
+}
+
+uint8_t RfCodeTable::countForSlot(uint8_t slot) const {
+  uint8_t n = 0;
+  for (uint16_t i = 0; i < CAPACITY; ++i) {
+    if (_b[i].code != 0 && _b[i].slot == slot) n++;
+  }
+  return n;
+}
+
+uint32_t RfCodeTable::tagScore(const RfCode& e, uint8_t protocol, uint8_t bits) {
+  // (bits*8 + protocol) distance << 4, plus bit-length distance
+  const int32_t sumA = e.bits * 8 + e.protocol, sumB = bits * 8 + protocol;
+  const uint32_t dsum = (uint32_t)(sumA > sumB ? sumA - sumB : sumB - sumA);
+  const uint32_t ldiff = (uint32_t)(e.bits > bits ? e.bits - bits : bits - e.bits);
+  return (dsum << 4) + ldiff;
+}
+
+RfCodeTable::Put RfCodeTable::put(const RfCode& c) {
+  if (c.code == 0) return Put::Full;
+  uint16_t i = bucketOf(c.code);
+  for (uint16_t n = 0; n < CAPACITY; ++n, i = (i + 1) & (CAPACITY - 1)) {
+    RfCode& e = _b[i];
+    if (e.code == 0) {
+      if (_count >= MAX_CODES) return Put::Full;
+      e = c;
+      _count++;
+      return Put::Added;
+    }
+    if (e.code == c.code && e.protocol == c.protocol && e.bits == c.bits) {
+      e.slot = c.slot;
+      e.families |= c.families;
+      return Put::Rebound;
+    }
+  }
+  return Put::Full;
+}
+
+const RfCode* RfCodeTable::find(uint32_t code, uint8_t protocol, uint8_t bits, uint32_t* score) const {
+  if (code == 0) return nullptr;
+  const RfCode* best = nullptr;
+  uint32_t bestScore = 0xFFFFFFFFu;
+  uint16_t i = bucketOf(code);
+  // The run ends at the first empty bucket (never deleted individually)
+  for (uint16_t n = 0; n < CAPACITY && _b[i].code != 0; ++n, i = (i + 1) & (CAPACITY - 1)) {
+    if (_b[i].code != code) continue;
+    const uint32_t sc = tagScore(_b[i], protocol, bits);
+    if (sc < bestScore) {
+      best = &_b[i];
+      bestScore = sc;
+      if (sc == 0) break;
+    }
+  }
+  if (best && score) *score = bestScore;
+  return best;
+}
+
+size_t RfCodeTable::serialize(uint8_t* out, size_t cap) const {
+  const size_t need = HEADER_BYTES + (size_t)_count * ENTRY_BYTES;
+  if (!out || cap < need) return 0;
+  out[0] = BLOB_VERSION;
+  out[1] = 0;
+  out[2] = (uint8_t)(_count & 0xFF);
+  out[3] = (uint8_t)(_count >> 8);
+  uint8_t* p = out + HEADER_BYTES;
+  for (uint16_t i = 0; i < CAPACITY; ++i) {
+    const RfCode& e = _b[i];
+    if (e.code == 0) continue;
+    p[0] = (uint8_t)e.code;
+    p[1] = (uint8_t)(e.code >> 8);
+    p[2] = (uint8_t)(e.code >> 16);
+    p[3] = (uint8_t)(e.code >> 24);
+    p[4] = e.protocol;
+    p[5] = e.bits;
+    p[6] = e.slot;
+    p[7] = e.families;
+    p += ENTRY_BYTES;
+  }
+  return need;
+}
+
+bool RfCodeTable::deserialize(const uint8_t* in, size_t len) {
+  clear();
+  if (!in || len < HEADER_BYTES || (in[0] != BLOB_VERSION && in[0] != 1)) return false;
+  const size_t entry = in[0] == 1 ? ENTRY_BYTES_V1 : ENTRY_BYTES;
+  const uint16_t count = (uint16_t)(in[2] | (in[3] << 8));
+  if (count > MAX_CODES || len < HEADER_BYTES + (size_t)count * entry) return false;
+  const uint8_t* p = in + HEADER_BYTES;
+  for (uint16_t k = 0; k < count; ++k, p += entry) {
+    RfCode c;
+    c.code = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    c.protocol = p[4];
+    c.bits = p[5];
+    c.slot = p[6];
+    c.families = entry > ENTRY_BYTES_V1 ? p[7] : 0;
+    if (put(c) == Put::Full) { clear(); return false; }
+  }
+  return true;
+}
@@ -0,0 +1,67 @@
+// File Overview: Declares the learned-remote code table: an open-addressing hash keyed by
+// the decoded code with protocol/bit-length tags, many remotes per slot, and its
+// compact serialized form (one NVS blob).
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Plain C++ like OokDecoder, so the host replay tools can load a saved blob.
+struct RfCode {
+  uint32_t code = 0;        // OokFrame::value (0 = empty bucket)
+  uint8_t  protocol = 0;
+  uint8_t  bits = 0;
+  uint8_t  slot = 0;        // RF learn slot (relay index, RF::SLOT_SEQUENCE or RF::SLOT_HAZARD)
+  uint8_t  families = 0;    // OokDecoder::familyBit() of the decoder that learned it (0 = unknown)
+};
+
+class RfCodeTable {
+public:
+  static constexpr uint16_t CAPACITY  = 128;   // buckets, power of two
+  static constexpr uint16_t MAX_CODES = 96;    // 75% load keeps probe runs short
+
+  // Serialized: {version, reserved, count (LE16)} + count * {code LE32, protocol, bits, slot, families}.
+  // Version 1 blobs (no families byte) still load, with families unknown.
+  static constexpr uint8_t BLOB_VERSION = 2;
+  static constexpr size_t  HEADER_BYTES = 4;
+  static constexpr size_t  ENTRY_BYTES  = 8;
+  static constexpr size_t  ENTRY_BYTES_V1 = 7;
+  static constexpr size_t  MAX_BLOB     = HEADER_BYTES + MAX_CODES * ENTRY_BYTES;
+
+  enum class Put : uint8_t { Added, Rebound, Full };
+
+  void clear();
+  uint16_t size() const { return _count; }
+  uint8_t  countForSlot(uint8_t slot) const;
+
+  // Same code with the same tags is one remote: binding it again moves it to 'slot'
+  // and adds the decoder that heard it this time
+  Put put(const RfCode& c);
+
+  // O(1) expected: probe the code's run; among entries with that code the one
+  // whose tags are closest to (protocol, bits) wins. 'score' is 0 for an exact
+  // tag match, larger the further apart (same scale the burst voting used).
+  const RfCode* find(uint32_t code, uint8_t protocol, uint8_t bits, uint32_t* score = nullptr) const;
+
+  template <class Fn>
+  void forEach(Fn fn) const {
+    for (const RfCode& e : _b) {
+      if (e.code) fn(e);
+    }
+  }
+
+  size_t serialize(uint8_t* out, size_t cap) const;
+  bool   deserialize(const uint8_t* in, size_t len);   // false (table cleared) on a bad blob
+
+  static uint32_t tagScore(const RfCode& e, uint8_t protocol, uint8_t bits);
+
+private:
+  static uint16_t bucketOf(uint32_t code) {
+    // Fibonacci hashing: remote codes share low bits (button id), so mix first
+    return (uint16_t)((code * 2654435761u) >> 25) & (CAPACITY - 1);
+  }
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+  static_assert(CAPACITY == 128, "bucketOf() shift assumes 7 index bits");
+
+  RfCode   _b[CAPACITY];
+  uint16_t _count = 0;
+};
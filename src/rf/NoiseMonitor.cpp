@@ -0,0 +1,76 @@
+// File Overview: Implements the RF noise monitor's windowed rates, the tolerance and gate
+// adaptation rules and the signal-quality figure.
+#include "NoiseMonitor.hpp"
+
+namespace {
+  // Level 0 is OokDecoder's default gate. Chip decoders bottom out at 100us
+  // (PT2262), so the strictest level still passes every supported remote.
+  constexpr NoiseMonitor::Gate kGates[NoiseMonitor::GATE_LEVELS] = {
+    {80,  8,  150, 0},
+    {100, 16, 400, 80},
+    {100, 0,  0xFFFF, 250},
+  };
+
+  // EWMA with weight 1/4 per window
+  inline uint32_t ewma(uint32_t avgX16, uint32_t sample) {
+    return avgX16 - avgX16 / 4 + sample * 16 / 4;
+  }
+
+  inline uint16_t sat16(uint32_t v) { return (uint16_t)(v > 0xFFFF ? 0xFFFF : v); }
+}
+
+const NoiseMonitor::Gate& NoiseMonitor::gate(uint8_t level) {
+  return kGates[level < GATE_LEVELS ? level : GATE_LEVELS - 1];
+}
+
+void NoiseMonitor::reset(uint32_t nowMs, const Counters& c) {
+  _prev = c;
+  _windowStart = nowMs;
+  _noiseX16 = 0;
+  _strayX16 = 0;
+  _unmatchedX16 = 0;
+  _clean = 0;
+  _q = Quality();
+}
+
+bool NoiseMonitor::update(uint32_t nowMs, const Counters& c) {
+  const uint32_t span = nowMs - _windowStart;
+  if (span < WINDOW_MS) return false;
+  const uint32_t rejected = c.rejected - _prev.rejected;
+  const uint32_t stray = c.stray - _prev.stray;
+  const uint32_t unmatched = c.unmatched - _prev.unmatched;
+  _prev = c;
+  _windowStart = nowMs;
+
+  _noiseX16 = ewma(_noiseX16, rejected * 1000u / span);
+  _strayX16 = ewma(_strayX16, stray * 60000u / span);
+  _unmatchedX16 = ewma(_unmatchedX16, unmatched * 60000u / span);
+  const uint32_t noise = _noiseX16 / 16;
+
+  // Hiss that decodes means the tolerance is looser than this site allows:
+  // tighten at once. Loosen one step per CLEAN_LOOSEN quiet windows to regain
+  // range. Unmatched frames are real (foreign) remotes; tolerance cannot help.
+  if (stray >= STRAY_TIGHTEN) {
+    _clean = 0;
+    _q.tolPct = _q.tolPct >= TOL_MIN + TOL_STEP ? (uint8_t)(_q.tolPct - TOL_STEP) : TOL_MIN;
+  } else if (stray <= STRAY_CLEAN && ++_clean >= CLEAN_LOOSEN) {
+    _clean = 0;
+    _q.tolPct = _q.tolPct + TOL_STEP <= TOL_MAX ? (uint8_t)(_q.tolPct + TOL_STEP) : TOL_MAX;
+  }
+
+  // A high noise floor wastes decode passes: reject more captures at the gate
+  if (noise >= kGates[_q.gateLevel].upPerSec && _q.gateLevel + 1 < GATE_LEVELS) _q.gateLevel++;
+  else if (_q.gateLevel > 0 && noise < kGates[_q.gateLevel].downPerSec) _q.gateLevel--;
+
+  // Heuristic 0..100: noise floor up to 40 (200/s), stray decodes up to 30
+  // (120/min), foreign frames up to 30 (10/min)
+  const uint32_t strayPerMin = _strayX16 / 16, unmatchedPerMin = _unmatchedX16 / 16;
+  const uint32_t noisePenalty = noise >= 200 ? 40 : noise / 5;
+  const uint32_t strayPenalty = strayPerMin >= 120 ? 30 : strayPerMin / 4;
+  const uint32_t unmatchedPenalty = unmatchedPerMin >= 10 ? 30 : unmatchedPerMin * 3;
+  _q.percent = (uint8_t)(100 - noisePenalty - strayPenalty - unmatchedPenalty);
+  _q.noisePerSec = sat16(noise);
+  _q.strayPerMin = sat16(strayPerMin);
+  _q.unmatchedPerMin = sat16(unmatchedPerMin);
+  return true;
+}
@@ -0,0 +1,64 @@
+// File Overview: Declares the RF noise monitor: it tracks the receiver's noise floor
+// (captures that never decode), stray decodes of hiss and frames that match no learned
+// remote, adapts the decoder tolerance and noise gate, and derives a signal-quality figure.
+#pragma once
+#include <stdint.h>
+
+// Plain C++ (time and counters are passed in) like BurstVoter, so rf_replay
+// can run the same adaptation over a recording.
+class NoiseMonitor {
+public:
+  static constexpr uint32_t WINDOW_MS     = 5000;
+  static constexpr uint8_t  TOL_MIN       = 40;    // tightest: strong remotes still decode
+  static constexpr uint8_t  TOL_MAX       = 80;    // loosest: marginal remotes at range
+  static constexpr uint8_t  TOL_START     = TOL_MAX; // the fixed tolerance used before adaptation; stray decodes tighten it
+  static constexpr uint8_t  TOL_STEP      = 5;
+  // Stray decodes per window: a press adds one (its first capture), hiss the rest
+  static constexpr uint8_t  STRAY_TIGHTEN = 10;
+  static constexpr uint8_t  STRAY_CLEAN   = 3;
+  static constexpr uint8_t  CLEAN_LOOSEN  = 6;     // clean windows (30 s) before loosening a step
+
+  // Gate levels, stepped by the noise floor with hysteresis
+  struct Gate {
+    uint16_t minPulseUs;   // OokDecoder::setGate
+    uint8_t  glitchDiv;
+    uint16_t upPerSec;     // noise floor that moves to the next level
+    uint16_t downPerSec;   // ... and back to this one
+  };
+  static constexpr uint8_t GATE_LEVELS = 3;
+  static const Gate& gate(uint8_t level);
+
+  // Cumulative counters, as read from RmtCapture/RF
+  struct Counters {
+    uint32_t rejected = 0;     // gated + undecoded captures
+    uint32_t stray = 0;        // single decodes never repeat-confirmed
+    uint32_t unmatched = 0;    // confirmed frames that match no remote
+  };
+
+  struct Quality {
+    uint8_t  percent = 100;    // 100 = quiet band, nothing but learned remotes
+    uint16_t noisePerSec = 0;  // smoothed undecodable captures per second
+    uint16_t strayPerMin = 0;
+    uint16_t unmatchedPerMin = 0;
+    uint8_t  tolPct = TOL_START;
+    uint8_t  gateLevel = 0;
+  };
+
+  void reset(uint32_t nowMs, const Counters& c);
+
+  // True when a window closed; tolerance()/gateLevel() may have changed
+  bool update(uint32_t nowMs, const Counters& c);
+
+  uint8_t tolerance() const { return _q.tolPct; }
+  uint8_t gateLevel() const { return _q.gateLevel; }
+  const Quality& quality() const { return _q; }
+
+private:
+  Counters _prev;
+  uint32_t _windowStart = 0;
+  uint32_t _noiseX16 = 0;      // EWMAs, x16 fixed point
+  uint32_t _strayX16 = 0;
+  uint32_t _unmatchedX16 = 0;
+  uint8_t  _clean = 0;         // consecutive windows with few stray decodes
+  Quality  _q;
+};
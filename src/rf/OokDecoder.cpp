@@ -0,0 +1,178 @@
+// File Overview: Implements the portable OOK decoder: noise gate, the chip decoder registry,
+// generic per-protocol bit slicing with a base pulse recovered from the burst itself, and
+// two-capture repeat confirmation.
+#include "OokDecoder.hpp"
+#include "OokPolicies.hpp"
+
+namespace {
+  struct HighLow { uint8_t high, low; };
+  struct Protocol {
+    uint16_t pulseUs;     // nominal base pulse, used only to rank equally good matches
+    HighLow  zero, one;
+    bool     inverted;    // data pulses start LOW
+  };
+
+  // rc-switch 2.6 protocol table (sync factors omitted: the idle gap that ends
+  // a capture is the sync, so its length is never part of the pulses)
+  constexpr Protocol kProtocols[] = {
+    {350, {1, 3},  {3, 1},  false},   // 1
+    {650, {1, 2},  {2, 1},  false},   // 2
+    {100, {4, 11}, {9, 6},  false},   // 3
+    {380, {1, 3},  {3, 1},  false},   // 4
+    {500, {1, 2},  {2, 1},  false},   // 5
+    {450, {1, 2},  {2, 1},  true},    // 6 (HT6P20B)
+    {150, {1, 6},  {6, 1},  false},   // 7 (HS2303-PT)
+    {200, {7, 16}, {3, 16}, false},   // 8 (Conrad RS-200 RX)
+    {200, {16, 7}, {16, 3}, true},    // 9 (Conrad RS-200 TX)
+    {365, {3, 1},  {1, 3},  true},    // 10 (1ByOne doorbell)
+    {270, {1, 2},  {2, 1},  true},    // 11 (HT12E)
+    {320, {1, 2},  {2, 1},  true},    // 12 (SM5212)
+  };
+  constexpr uint8_t kProtocolCount = sizeof(kProtocols) / sizeof(kProtocols[0]);
+
+  inline uint32_t absDiff(uint32_t a, uint32_t b) { return a > b ? a - b : b - a; }
+
+  // Chip decoder registry, in trial order; index = OokFamily - 1
+  using DecodeFn = bool (*)(const OokPulse*, size_t, uint8_t, OokFrame&);
+  struct Registered {
+    OokFamily   family;
+    const char* name;
+    uint8_t     protocol, bits;   // the frame shape this decoder reports
+    DecodeFn    decode;
+  };
+  template <class P>
+  constexpr Registered entry(const char* name) {
+    return Registered{P::FAMILY, name, P::PROTOCOL, P::BITS, &OokPolicy::decode<P>};
+  }
+  constexpr Registered kRegistry[] = {
+    entry<OokPolicy::Pt2262>("PT2262"),
+    entry<OokPolicy::Ev1527>("EV1527"),
+    entry<OokPolicy::Ht6p20b>("HT6P20B"),
+    entry<OokPolicy::Ht12e>("HT12E"),
+  };
+  static_assert(sizeof(kRegistry) / sizeof(kRegistry[0]) + 1 == (size_t)OokFamily::Count,
+                "one registry entry per chip family");
+}
+
+const char* OokDecoder::familyName(OokFamily f) {
+  for (const Registered& r : kRegistry) {
+    if (r.family == f) return r.name;
+  }
+  return "generic";
+}
+
+uint8_t OokDecoder::familiesFor(uint8_t protocol, uint8_t bits, uint8_t learned) {
+  if (learned) return learned;
+  uint8_t mask = familyBit(OokFamily::Generic);
+  for (const Registered& r : kRegistry) {
+    if (r.protocol == protocol && r.bits == bits) mask |= familyBit(r.family);
+  }
+  return mask;
+}
+
+bool OokDecoder::plausible(const OokPulse* p, size_t n, uint16_t minPulseUs, uint8_t glitchDiv) {
+  if (!p || n < 2 * MIN_BITS || n > MAX_PULSES) return false;
+  size_t shortPulses = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (p[i].us < minPulseUs) shortPulses++;
+  }
+  // A real frame has none; by default allow one glitch per eight pulses
+  return glitchDiv ? shortPulses * glitchDiv <= n : shortPulses == 0;
+}
+
+// Slice one capture with protocol 'idx'. Each bit is a HIGH/LOW pair whose
+// ratio says zero or one; the base pulse then follows from the total length,
+// and every pulse must sit within the tolerance of its expected multiple.
+bool OokDecoder::decodeProtocol(uint8_t idx, const OokPulse* p, size_t n, OokFrame& out) const {
+  const Protocol& pr = kProtocols[idx];
+  const uint8_t firstLevel = pr.inverted ? 0 : 1;
+  size_t s = 0;
+  if (p[0].level != firstLevel) s = 1;      // inverted: the short sync tail leads
+  if (s >= n || p[s].level != firstLevel) return false;
+  const size_t pairs = (n - s) / 2;         // a trailing odd pulse is the sync head
+  if (pairs < MIN_BITS || pairs > MAX_BITS) return false;
+
+  // Ratios scaled by 256 to stay in integers
+  const uint32_t zeroRatio = 256u * pr.zero.high / (pr.zero.high + pr.zero.low);
+  const uint32_t oneRatio  = 256u * pr.one.high / (pr.one.high + pr.one.low);
+
+  uint32_t code = 0, units = 0, total = 0;
+  for (size_t b = 0; b < pairs; ++b) {
+    const uint32_t h = p[s + 2 * b].us, l = p[s + 2 * b + 1].us;
+    const uint32_t r = 256u * h / (h + l);
+    const bool one = absDiff(r, oneRatio) < absDiff(r, zeroRatio);
+    code = (code << 1) | (one ? 1u : 0u);
+    const HighLow& hl = one ? pr.one : pr.zero;
+    units += hl.high + hl.low;
+    total += h + l;
+  }
+  const uint32_t delay = total / units;
+  const uint32_t tol = delay * _tolPct / 100u;
+  if (delay == 0) return false;
+
+  for (size_t b = 0; b < pairs; ++b) {
+    const HighLow& hl = (code >> (pairs - 1 - b)) & 1u ? pr.one : pr.zero;
+    if (absDiff(p[s + 2 * b].us, delay * hl.high) >= tol) return false;
+    if (absDiff(p[s + 2 * b + 1].us, delay * hl.low) >= tol) return false;
+  }
+
+  out.value = code;
+  out.bits = (uint8_t)pairs;
+  out.protocol = (uint8_t)(idx + 1);
+  out.delayUs = (uint16_t)(delay > 0xFFFF ? 0xFFFF : delay);
+  return true;
+}
+
+// Several protocols share a bit shape (1 and 4; 2 and 5; 6, 11 and 12); the
+// one whose nominal pulse is closest to the decoded base pulse wins.
+bool OokDecoder::decodeGeneric(const OokPulse* p, size_t n, OokFrame& out) const {
+  bool found = false;
+  uint32_t bestErr = 0xFFFFFFFFu;
+  for (uint8_t i = 0; i < kProtocolCount; ++i) {
+    OokFrame f;
+    if (!decodeProtocol(i, p, n, f)) continue;
+    const uint32_t err = absDiff(f.delayUs, kProtocols[i].pulseUs) * 1024u / kProtocols[i].pulseUs;
+    if (!found || err < bestErr) {
+      out = f;
+      bestErr = err;
+      found = true;
+    }
+  }
+  return found;
+}
+
+// A chip decoder only accepts its exact frame length and timing range, so the
+// first one that matches ends the search without running the generic table.
+bool OokDecoder::decodeOnce(const OokPulse* p, size_t n, OokFrame& out) const {
+  for (const Registered& r : kRegistry) {
+    if ((_families & familyBit(r.family)) && r.decode(p, n, _tolPct, out)) return true;
+  }
+  if (!(_families & familyBit(OokFamily::Generic))) return false;
+  return decodeGeneric(p, n, out);
+}
+
+bool OokDecoder::decode(const OokPulse* p, size_t n, OokFrame& out) {
+  _stats.bursts++;
+  if (!plausible(p, n, _minPulseUs, _glitchDiv)) {
+    _stats.gated++;
+    _havePrev = false;
+    return false;
+  }
+  OokFrame f;
+  if (!decodeOnce(p, n, f)) {
+    _stats.undecoded++;
+    _havePrev = false;
+    return false;
+  }
+  const bool repeat = _havePrev && f.value == _prev.value && f.bits == _prev.bits &&
+                      f.protocol == _prev.protocol;
+  _prev = f;
+  _havePrev = true;
+  if (!repeat) {
+    _stats.unconfirmed++;
+    return false;
+  }
+  out = f;
+  _stats.frames++;
+  return true;
+}
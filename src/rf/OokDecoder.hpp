@@ -0,0 +1,95 @@
+// File Overview: Declares the portable OOK pulse-train decoder that turns one captured burst
+// of pulse durations into a remote code: the idle-noise gate, a registry of chip-specific
+// decoders (OokPolicies.hpp) and the generic rc-switch protocol table as fallback.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// No Arduino/IDF dependencies: captures come in as plain {level, duration}
+// arrays, so recorded pulse trains can be replayed through it on a PC.
+
+struct OokPulse {
+  uint16_t us;       // duration of this level
+  uint8_t  level;    // 1 = carrier on (receiver DATA high)
+};
+
+// Which decoder produced a frame; also the registry's bit index
+enum class OokFamily : uint8_t { Generic = 0, Pt2262, Ev1527, Ht6p20b, Ht12e, Count };
+
+struct OokFrame {
+  uint32_t value = 0;     // same code rc-switch reports (stored RF signatures stay valid)
+  uint8_t  bits = 0;
+  uint8_t  protocol = 0;  // rc-switch protocol number, 1-based
+  uint16_t delayUs = 0;   // decoded base pulse length
+  OokFamily family = OokFamily::Generic;
+};
+
+class OokDecoder {
+public:
+  static constexpr uint8_t  MIN_BITS = 4;        // rc-switch ignores shorter bursts as noise
+  static constexpr uint8_t  MAX_BITS = 32;
+  static constexpr size_t   MAX_PULSES = 2 * MAX_BITS + 4;
+  static constexpr uint16_t MIN_PULSE_US = 80;   // no supported protocol uses shorter pulses
+
+  struct Stats {
+    uint32_t bursts = 0;        // captures offered
+    uint32_t gated = 0;         // rejected by the noise gate
+    uint32_t undecoded = 0;     // plausible but no protocol matched
+    uint32_t unconfirmed = 0;   // decoded but not a repeat (first of a press, or decoded hiss)
+    uint32_t frames = 0;        // decoded and repeat-confirmed
+  };
+
+  // Registry: bit (1 << OokFamily) enables that decoder. Chip decoders are
+  // tried first, in enum order (PT2262 before the looser EV1527 shape); the
+  // generic table only runs when none of them accepts the capture.
+  static constexpr uint8_t familyBit(OokFamily f) { return (uint8_t)(1u << (uint8_t)f); }
+  static constexpr uint8_t ALL_FAMILIES = (uint8_t)((1u << (uint8_t)OokFamily::Count) - 1);
+  void setFamilies(uint8_t mask) { _families = mask; }
+  uint8_t families() const { return _families; }
+  static const char* familyName(OokFamily f);
+
+  // Decoders a stored code needs: the ones that learned it ('learned', a
+  // familyBit mask) when known. Otherwise every chip decoder that reports
+  // (protocol, bits) plus the generic table, which also reports chip-shaped
+  // codes the chip decoders reject (fast oscillators, invalid PT2262 trits).
+  static uint8_t familiesFor(uint8_t protocol, uint8_t bits, uint8_t learned);
+
+  // Frame from a chip decoder: fixed length, chip timing range and frame
+  // checks passed, so it may be trusted more than a generic-table guess
+  static bool structured(const OokFrame& f) { return f.family != OokFamily::Generic; }
+
+  // Percent of the base pulse a duration may deviate (rc-switch "receive
+  // tolerance"); chip decoders cap it at their own, tighter limit
+  void setTolerance(uint8_t pct) { _tolPct = pct; }
+
+  // One capture: the pulses between two idle gaps (the gap itself excluded).
+  // True with 'out' once the same code has been decoded from two consecutive
+  // captures - remotes repeat every frame, hiss never does.
+  bool decode(const OokPulse* p, size_t n, OokFrame& out);
+
+  // Idle-noise gate: too short/long a burst or too many pulses under
+  // 'minPulseUs' (one allowed per 'glitchDiv' pulses; 0 = none allowed)
+  static bool plausible(const OokPulse* p, size_t n, uint16_t minPulseUs = MIN_PULSE_US, uint8_t glitchDiv = 8);
+
+  // Gate used by decode(); the noise monitor tightens it in a noisy shop
+  void setGate(uint16_t minPulseUs, uint8_t glitchDiv) { _minPulseUs = minPulseUs; _glitchDiv = glitchDiv; }
+
+  // Try the enabled decoders on one capture (no repeat check); in the generic
+  // table the closest nominal pulse length wins among protocols of one shape
+  bool decodeOnce(const OokPulse* p, size_t n, OokFrame& out) const;
+
+  const Stats& stats() const { return _stats; }
+  void reset() { _havePrev = false; }
+
+private:
+  bool decodeProtocol(uint8_t idx, const OokPulse* p, size_t n, OokFrame& out) const;
+  bool decodeGeneric(const OokPulse* p, size_t n, OokFrame& out) const;
+
+  uint8_t  _tolPct = 60;
+  uint8_t  _families = ALL_FAMILIES;
+  uint16_t _minPulseUs = MIN_PULSE_US;
+  uint8_t  _glitchDiv = 8;
+  OokFrame _prev;
+  bool     _havePrev = false;
+  Stats    _stats;
+};
@@ -0,0 +1,111 @@
+// File Overview: Declares the chip-specific OOK decoders (EV1527, PT2262/2260, HT12E,
+// HT6P20B learning code) as policy classes for one slicing template, so each
+// decoder's bit count, pulse shape and timing limits are compile-time constants.
+#pragma once
+#include "OokDecoder.hpp"
+
+namespace OokPolicy {
+
+// Policy contract:
+//   BITS             exact frame length
+//   ZERO_H/L, ONE_H/L  pulse widths in base units
+//   INVERTED         data pulses start LOW
+//   T_MIN/T_MAX      accepted base pulse (us); the chip's oscillator range
+//   TOL_PCT          per-pulse tolerance cap (the runtime tolerance may only tighten it)
+//   PROTOCOL         rc-switch number reported, so learned codes keep matching
+//   FAMILY           OokFamily
+//   valid(code)      chip-level frame check
+
+// EV1527 and compatible learning-code encoders (HS1527, RT1527): 20-bit ID + 4 keys
+struct Ev1527 {
+  static constexpr uint8_t  BITS = 24;
+  static constexpr uint8_t  ZERO_H = 1, ZERO_L = 3, ONE_H = 3, ONE_L = 1;
+  static constexpr bool     INVERTED = false;
+  static constexpr uint16_t T_MIN = 200, T_MAX = 600;
+  static constexpr uint8_t  TOL_PCT = 50;
+  static constexpr uint8_t  PROTOCOL = 1;
+  static constexpr OokFamily FAMILY = OokFamily::Ev1527;
+  static constexpr bool valid(uint32_t code) { return code != 0 && code != 0xFFFFFFu; }
+};
+
+// PT2262/PT2260 fixed code: 12 tri-state digits sent as bit pairs 00 / 11 / 01
+// (floating). A 10 pair cannot be sent, which rejects most EV1527-shaped noise.
+struct Pt2262 {
+  static constexpr uint8_t  BITS = 24;
+  static constexpr uint8_t  ZERO_H = 1, ZERO_L = 3, ONE_H = 3, ONE_L = 1;
+  static constexpr bool     INVERTED = false;
+  static constexpr uint16_t T_MIN = 100, T_MAX = 700;
+  static constexpr uint8_t  TOL_PCT = 50;
+  static constexpr uint8_t  PROTOCOL = 1;
+  static constexpr OokFamily FAMILY = OokFamily::Pt2262;
+  static constexpr bool valid(uint32_t code) {
+    // Pair (hi, lo) == (1, 0) anywhere is invalid: hi bits & ~lo bits over the even/odd lanes
+    return ((code >> 1) & ~code & 0x555555u) == 0;
+  }
+};
+
+// HT12E: 8 address + 4 data bits, data sent LOW-first (rc-switch protocol 11)
+struct Ht12e {
+  static constexpr uint8_t  BITS = 12;
+  static constexpr uint8_t  ZERO_H = 1, ZERO_L = 2, ONE_H = 2, ONE_L = 1;
+  static constexpr bool     INVERTED = true;
+  static constexpr uint16_t T_MIN = 150, T_MAX = 600;
+  static constexpr uint8_t  TOL_PCT = 50;
+  static constexpr uint8_t  PROTOCOL = 11;
+  static constexpr OokFamily FAMILY = OokFamily::Ht12e;
+  static constexpr bool valid(uint32_t) { return true; }
+};
+
+// HT6P20B learning code: 22-bit ID + 2 data bits + fixed 0101 anti-code (rc-switch protocol 6)
+struct Ht6p20b {
+  static constexpr uint8_t  BITS = 28;
+  static constexpr uint8_t  ZERO_H = 1, ZERO_L = 2, ONE_H = 2, ONE_L = 1;
+  static constexpr bool     INVERTED = true;
+  static constexpr uint16_t T_MIN = 300, T_MAX = 700;
+  static constexpr uint8_t  TOL_PCT = 50;
+  static constexpr uint8_t  PROTOCOL = 6;
+  static constexpr OokFamily FAMILY = OokFamily::Ht6p20b;
+  static constexpr bool valid(uint32_t code) { return (code & 0xFu) == 0x5u; }
+};
+
+// Slice one capture with policy P; every check folds to constants per policy
+template <class P>
+bool decode(const OokPulse* p, size_t n, uint8_t tolPct, OokFrame& out) {
+  static_assert(P::BITS >= OokDecoder::MIN_BITS && P::BITS <= OokDecoder::MAX_BITS, "frame length");
+  constexpr uint8_t  firstLevel = P::INVERTED ? 0 : 1;
+  constexpr uint32_t zeroRatio = 256u * P::ZERO_H / (P::ZERO_H + P::ZERO_L);
+  constexpr uint32_t oneRatio  = 256u * P::ONE_H / (P::ONE_H + P::ONE_L);
+  constexpr uint32_t mid = (zeroRatio + oneRatio) / 2;
+  constexpr bool     oneIsHigher = oneRatio > zeroRatio;
+
+  const size_t s = (n > 0 && p[0].level != firstLevel) ? 1 : 0;
+  if (n < s + 2u * P::BITS || n > s + 2u * P::BITS + 1 || p[s].level != firstLevel) return false;
+
+  uint32_t code = 0, units = 0, total = 0;
+  for (uint8_t b = 0; b < P::BITS; ++b) {
+    const uint32_t h = p[s + 2 * b].us, l = p[s + 2 * b + 1].us;
+    const uint32_t r = 256u * h / (h + l);
+    const bool one = oneIsHigher ? r > mid : r < mid;
+    code = (code << 1) | (one ? 1u : 0u);
+    units += one ? (P::ONE_H + P::ONE_L) : (P::ZERO_H + P::ZERO_L);
+    total += h + l;
+  }
+  const uint32_t t = total / units;
+  if (t < P::T_MIN || t > P::T_MAX || !P::valid(code)) return false;
+  const uint32_t tol = t * (tolPct < P::TOL_PCT ? tolPct : P::TOL_PCT) / 100u;
+  for (uint8_t b = 0; b < P::BITS; ++b) {
+    const bool one = (code >> (P::BITS - 1 - b)) & 1u;
+    const uint32_t wantH = t * (one ? P::ONE_H : P::ZERO_H), wantL = t * (one ? P::ONE_L : P::ZERO_L);
+    const uint32_t h = p[s + 2 * b].us, l = p[s + 2 * b + 1].us;
+    if ((h > wantH ? h - wantH : wantH - h) >= tol) return false;
+    if ((l > wantL ? l - wantL : wantL - l) >= tol) return false;
+  }
+  out.value = code;
+  out.bits = P::BITS;
+  out.protocol = P::PROTOCOL;
+  out.delayUs = (uint16_t)t;
+  out.family = P::FAMILY;
+  return true;
+}
+
+} // namespace OokPolicy
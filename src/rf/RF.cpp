@@ -1,135 +1,199 @@
-// File Overview: Handles RF remote learning/storage plus runtime decoding with rc-switch
-// and drives the relay outputs (with buzzer feedback) according to received commands.
+// File Overview: Handles RF remote learning/storage plus runtime decoding of RMT-captured
+// frames (see RmtCapture/OokDecoder) and drives the relay outputs (with buzzer feedback) according to received commands.
 #include "RF.hpp"
 #include <Arduino.h>
 #include "pins.hpp"
 #include "relays.hpp"
 #include <Preferences.h>
-#include <RCSwitch.h>
 #include "buzzer.hpp"
 #include "prefs.hpp"
+#include "flasher.hpp"
+#include "channel_map.hpp"
+#include "RmtCapture.hpp"
+#include "CodeTable.hpp"
+#include "BurstVoter.hpp"
+#include "NoiseMonitor.hpp"
 
 #ifndef PIN_RF_DATA
 #  error "Define PIN_RF_DATA in pins.hpp for SYN480R DATA input"
 #endif
 
 namespace {
-  // Tunables
-  constexpr uint32_t RF_COOLDOWN_MS        = 1000; // suppress repeats after a trigger (1s debounce)
-  constexpr uint32_t BURST_GAP_MS          = 250;  // gap indicating end of a button-burst
-  constexpr uint32_t MAX_BURST_MS          = 500;  // finalize even if still noisy after this window
-
-  // rc-switch handles capture internally, no local ISR buffers needed
+  // Tunables: burst gap / window / cooldown live in BurstVoter, timing
+  // tolerance and noise gate are adapted by NoiseMonitor
 
   uint32_t g_last_activity_ms = 0;
 
-  struct Learned { uint32_t sig; uint32_t sum; uint16_t len; uint8_t relay; };
-  Learned g_learn[6];
+  // Learned remotes: many codes may share a slot (several remotes per channel)
+  RfCodeTable g_codes;
+  bool (*g_triggerHook)(int slot) = nullptr;
 
   Preferences g_prefs;
   int8_t activeRelay = -1; // -1 = none on
 
-  // Deduplicate repeated frames from held buttons
-  // Burst aggregator and trigger suppression
-  struct VoteAgg {
-    bool active;
-    uint32_t lastMs;
-    uint32_t startMs;
-    uint8_t votes[6];
-    uint32_t bestScore[6];
-    uint8_t coarseVotes[6];
-    bool anyEv;
+  // Deduplicate repeated frames from held buttons: burst voting + cooldown
+  BurstVoter g_votes;
+  static_assert(BurstVoter::SLOTS == RF::SLOT_COUNT, "one vote bucket per learn slot");
+  // Noise floor / stray decode tracking that tunes the decoder
+  NoiseMonitor g_noise;
+  uint32_t g_unmatched = 0;     // repeat-confirmed frames matching no remote (outside learning)
+
+  static_assert(BurstVoter::FAST_CONFIRM_MAX == RF::FAST_CONFIRM_MAX, "same fast-mode range");
+
+  // Learn session, advanced by frames arriving in service()
+  constexpr uint32_t LEARN_WINDOW_MS       = 8000; // whole session
+  constexpr uint32_t LEARN_REPEAT_MS       = 3000; // confirming capture must follow within this
+  constexpr uint8_t  LEARN_EVENT_QUEUE     = 8;    // power of two
+
+  struct LearnSession {
+    bool     active;
+    int8_t   slot;
+    uint8_t  heard;
+    uint32_t deadline;
+    OokFrame last;
+    uint32_t lastAt;
   };
-  VoteAgg g_agg = {false, 0, 0, {0,0,0,0,0,0}, {0xFFFFFFFFu,0xFFFFFFFFu,0xFFFFFFFFu,0xFFFFFFFFu,0xFFFFFFFFu,0xFFFFFFFFu}, {0,0,0,0,0,0}, false};
-  uint32_t g_block_until_ms = 0;
+  LearnSession g_learnSes = {};
+  RF::LearnEvent g_learnEvents[LEARN_EVENT_QUEUE];
+  uint8_t g_learnEvHead = 0, g_learnEvTail = 0;   // loop task only
+
+  void pushLearnEvent(RF::LearnEvent e) {
+    // Full: drop the oldest so the final result is never lost
+    if ((uint8_t)(g_learnEvHead - g_learnEvTail) >= LEARN_EVENT_QUEUE) g_learnEvTail++;
+    g_learnEvents[g_learnEvHead++ & (LEARN_EVENT_QUEUE - 1)] = e;
+  }
 
-  // Forward declaration for burst finalizer
+  // Forward declarations for burst finalizer
   void handleTrigger(uint8_t rindex);
+  void handleHazard();
 
-  static inline void aggReset() {
-    g_agg.active = false;
-    g_agg.lastMs = 0;
-    g_agg.startMs = 0;
-    g_agg.anyEv = false;
-    for (int i=0;i<6;++i){ g_agg.votes[i]=0; g_agg.coarseVotes[i]=0; g_agg.bestScore[i]=0xFFFFFFFFu; }
-  }
-
-  static void finalizeBurst() {
-    if (!g_agg.active) return;
-    int winner = -1; uint8_t bestVotes = 0; uint32_t bestScore = 0xFFFFFFFFu;
-    if (g_agg.anyEv) {
-      // choose winner from EV votes first
-      for (int i=0;i<6;++i){
-        uint8_t v = g_agg.votes[i];
-        if (!v) continue;
-        uint32_t sc = g_agg.bestScore[i];
-        if (v > bestVotes || (v == bestVotes && sc < bestScore)) {
-          bestVotes = v; bestScore = sc; winner = i;
-        }
-      }
-    } else {
-      // fallback: use coarse votes only if unambiguous (single non-zero bucket)
-      int nz = 0; int idx = -1;
-      for (int i=0;i<6;++i){ if (g_agg.coarseVotes[i]) { nz++; idx = i; } }
-      if (nz == 1 && idx >= 0) winner = idx;
-    }
-    if (winner >= 0) {
-      handleTrigger((uint8_t)g_learn[winner].relay);
-      g_block_until_ms = millis() + RF_COOLDOWN_MS;
-    }
-    aggReset();
+  static void fireWinner(int winner) {
+    bool consumed = g_triggerHook && g_triggerHook(winner);
+    if (consumed || winner == RF::SLOT_SEQUENCE) return;
+    if (winner == RF::SLOT_HAZARD) handleHazard();
+    else                           handleTrigger((uint8_t)winner);
   }
 
-  // rc-switch handles decoding; legacy ISR/EV1527 helpers removed
-
-  // rc-switch instance and compute-only receive path
-  RCSwitch g_rc;
-
-  static bool computeFromRcSwitch(uint32_t &outHash, uint32_t &outSum, uint16_t &outLen) {
-    if (!g_rc.available()) return false;
-    // Read once; rc-switch provides value, bit length, and protocol
-    unsigned long value = g_rc.getReceivedValue();
-    unsigned int bits = g_rc.getReceivedBitlength();
-    unsigned int proto = g_rc.getReceivedProtocol();
-    g_rc.resetAvailable();
-
-    if (value == 0 || bits == 0) return false;
+  // Frames come decoded and repeat-confirmed from the RMT capture task
+  static bool nextFrame(OokFrame& f) {
+    if (!RmtCapture::take(f)) return false;
+    if (f.value == 0 || f.bits == 0) return false;
 #ifdef RF_DEBUG
-    Serial.printf("[RF] rc-switch recv val=%lu bits=%u proto=%u\n", value, bits, proto);
-  
+    Serial.printf("[RF] recv val=%lu bits=%u proto=%u (%s) T=%uus\n", (unsigned long)f.value, f.bits, f.protocol,
+                  OokDecoder::familyName(f.family), f.delayUs);
 #endif
-  // Use (value) as signature; fold protocol into sum/len for coarse and tie-breakers
-    outHash = (uint32_t)value;
-    // Compose a coarse sum surrogate: bits*8 + proto to space-apart signatures
-    outSum = (uint32_t)(bits * 8u + (proto & 0xF));
-    outLen = (uint16_t)bits; // treat as length for evFrame detection and learning
     g_last_activity_ms = millis();
     return true;
   }
 
-  // Persistence
+  // Persistence: the whole table is one blob
+  void saveCodes() {
+    static uint8_t buf[RfCodeTable::MAX_BLOB];
+    const size_t n = g_codes.serialize(buf, sizeof(buf));
+    if (n) g_prefs.putBytes(KEY_RF_CODES, buf, n);
+  }
+
+  // Before the table: one code per slot in rf_sig%u / rf_sum%u / rf_len%u,
+  // with sum = bits*8 + protocol. Imported once, then the keys are removed.
+  bool migrateSlotKeys() {
+    bool any = false;
+    for (int i = 0; i < RF::SLOT_COUNT; ++i) {
+      char kSig[16], kSum[16], kLen[16];
+      snprintf(kSig, sizeof(kSig), "rf_sig%u", i);
+      snprintf(kSum, sizeof(kSum), "rf_sum%u", i);
+      snprintf(kLen, sizeof(kLen), "rf_len%u", i);
+      if (!g_prefs.isKey(kSig)) continue;
+      RfCode c;
+      c.code = g_prefs.getULong(kSig, 0);
+      const uint32_t sum = g_prefs.getULong(kSum, 0);
+      c.bits = (uint8_t)g_prefs.getUShort(kLen, 0);
+      c.protocol = (uint8_t)(sum - c.bits * 8u);
+      c.slot = (uint8_t)i;
+      if (c.code) { g_codes.put(c); any = true; }
+      g_prefs.remove(kSig);
+      g_prefs.remove(kSum);
+      g_prefs.remove(kLen);
+    }
+    return any;
+  }
+
   void loadPrefs() {
-    g_prefs.begin("tltb", false);
-    for (int i = 0; i < 6; ++i) {
-      char key[16];
-      snprintf(key, sizeof(key), "rf_sig%u", i);
-      g_learn[i].sig = g_prefs.getULong(key, 0);
-      snprintf(key, sizeof(key), "rf_sum%u", i);
-      g_learn[i].sum = g_prefs.getULong(key, 0);
-      snprintf(key, sizeof(key), "rf_len%u", i);
-      g_learn[i].len = (uint16_t)g_prefs.getUShort(key, 0);
-      g_learn[i].relay = (uint8_t)i;
+    g_prefs.begin(NVS_NS, false);
+    const uint32_t t0 = micros();
+    static uint8_t buf[RfCodeTable::MAX_BLOB];
+    const size_t len = g_prefs.getBytesLength(KEY_RF_CODES);
+    bool ok = len > 0 && len <= sizeof(buf) && g_prefs.getBytes(KEY_RF_CODES, buf, len) == len &&
+              g_codes.deserialize(buf, len);
+    if (!ok) g_codes.clear();
+    if (migrateSlotKeys()) {
+      saveCodes();
+      Serial.printf("[RF] Migrated %u per-slot codes into the table\n", g_codes.size());
     }
+    Serial.printf("[RF] Loaded %u remote codes in %lu us\n", g_codes.size(), (unsigned long)(micros() - t0));
+    g_votes.setFastConfirm(g_prefs.getUChar(KEY_RF_FAST, 0));
+  }
+
+  NoiseMonitor::Counters noiseCounters() {
+    const OokDecoder::Stats d = RmtCapture::stats().decoder;
+    NoiseMonitor::Counters c;
+    c.rejected = d.gated + d.undecoded;
+    c.stray = d.unconfirmed;
+    c.unmatched = g_unmatched;
+    return c;
+  }
+
+  // Decoder registry: run only the decoders that learned a stored code.
+  // Tolerance and gate follow the noise monitor. A learn session (or an empty
+  // table) gets every decoder, the loosest tolerance and the default gate so
+  // any remote can pair.
+  void applyReceiverConfig() {
+    uint8_t mask = 0;
+    g_codes.forEach([&](const RfCode& c) { mask |= OokDecoder::familiesFor(c.protocol, c.bits, c.families); });
+    if (g_learnSes.active || !mask) mask = OokDecoder::ALL_FAMILIES;
+    RmtCapture::setFamilies(mask);
+    RmtCapture::setTolerance(g_learnSes.active ? NoiseMonitor::TOL_MAX : g_noise.tolerance());
+    const NoiseMonitor::Gate& g = NoiseMonitor::gate(g_learnSes.active ? 0 : g_noise.gateLevel());
+    RmtCapture::setGate(g.minPulseUs, g.glitchDiv);
+  }
+
+  void learnEnd(RF::LearnEvent e) {
+    g_learnSes.active = false;
+    applyReceiverConfig();
+    pushLearnEvent(e);
   }
 
-  void saveSlot(int i) {
-    char key[16];
-    snprintf(key, sizeof(key), "rf_sig%u", i);
-    g_prefs.putULong(key, g_learn[i].sig);
-    snprintf(key, sizeof(key), "rf_sum%u", i);
-    g_prefs.putULong(key, g_learn[i].sum);
-    snprintf(key, sizeof(key), "rf_len%u", i);
-    g_prefs.putUShort(key, g_learn[i].len);
+  // Binds on a second frame with the identical code (value, protocol and bit
+  // length) within LEARN_REPEAT_MS of the previous one. A different code of the
+  // same shape is another remote or a neighbour's press, never a confirmation.
+  void learnFrame(const OokFrame& f, uint32_t nowMs) {
+    LearnSession& ls = g_learnSes;
+    Serial.printf("[RF] Learn: Received sig=%lu proto=%u len=%u (%s)\n", (unsigned long)f.value, f.protocol, f.bits,
+                  OokDecoder::familyName(f.family));
+    if (ls.heard < 255) ls.heard++;
+    const bool repeat = ls.last.value != 0 && (nowMs - ls.lastAt) <= LEARN_REPEAT_MS &&
+                        f.value == ls.last.value && f.protocol == ls.last.protocol && f.bits == ls.last.bits;
+    if (repeat) {
+      RfCode c;
+      c.code = f.value;
+      c.protocol = f.protocol;
+      c.bits = f.bits;
+      c.slot = (uint8_t)ls.slot;
+      c.families = OokDecoder::familyBit(f.family);
+      if (g_codes.put(c) == RfCodeTable::Put::Full) {
+        Serial.println("[RF] Code table full - clear remotes first");
+        learnEnd(RF::LearnEvent::TableFull);
+        return;
+      }
+      saveCodes();
+      // The rest of this button burst must not toggle the freshly bound slot
+      g_votes.block(nowMs);
+      Serial.printf("[RF] Learned slot %d (%u remotes)\n", ls.slot, g_codes.countForSlot((uint8_t)ls.slot));
+      learnEnd(RF::LearnEvent::Saved);
+      return;
+    }
+    pushLearnEvent(ls.last.value == 0 ? RF::LearnEvent::Heard : RF::LearnEvent::Mismatch);
+    ls.last = f;
+    ls.lastAt = nowMs;
   }
 
   // Check if RF mode is enabled (1P8T switch in position P2)
@@ -145,37 +209,47 @@ namespace {
     // Check if RF mode is enabled; if not, ignore the trigger silently
     if (!isRfModeEnabled()) return;
     
-    // Mode-aware behavior: if RV mode and BRAKE is requested, map to LEFT+RIGHT
-    bool isBrake = (rindex == (uint8_t)R_BRAKE);
-    bool rvMode = (getUiMode() == 1);
-
-    if (rvMode && isBrake) {
-      // Toggle behavior for RV brake: press again turns both off
-      bool bothOn = relayIsOn(R_LEFT) && relayIsOn(R_RIGHT);
-      if (activeRelay == (int)R_BRAKE || bothOn) {
-        relayOff(R_LEFT); relayOff(R_RIGHT);
-        activeRelay = -1;
-        Buzzer::beep();
-        return;
-      }
-      // Otherwise, activate RV brake mapping
-      for (int i = 0; i < 6; ++i) relayOff((RelayIndex)i);
-      relayOn(R_LEFT); relayOn(R_RIGHT);
-      activeRelay = (uint8_t)R_BRAKE;
+    // The button's relays come from the active channel profile (e.g. RV brake
+    // drives LEFT+RIGHT); a slot the connector doesn't have does nothing
+    const uint8_t mask = ChannelMap::slotMask(rindex);
+    if (!mask) return;
+
+    // Turn signals flash when that option is set; everything else is steady
+    bool flash = Flasher::turnSignalsFlash() && (ChannelMap::slotFlags(rindex) & CH_SLOT_TURN);
+
+    // Press again turns it off; a combination also toggles off when it is all on
+    bool combo = (mask & (mask - 1)) != 0;
+    if (activeRelay == rindex || (combo && (relaysMask() & mask) == mask)) {
+      Flasher::stop();
+      relaysUpdate(mask, 0);
+      activeRelay = -1;
       Buzzer::beep();
       return;
     }
+    Flasher::stop();
+    relaysUpdate(RELAY_MASK_OUTPUTS, flash ? 0 : mask);
+    if (flash) Flasher::start(mask);
+    activeRelay = rindex;
+    Buzzer::beep();
+  }
+
+  // Hazard: both turn relays flash together whatever the flash option says,
+  // the same mask as the BLE "hazard" flash command. Pressing it while a
+  // hazard is flashing (from RF or BLE) stops it
+  void handleHazard() {
+    if (!isRfModeEnabled()) return;
 
-    // Normal single-channel behavior
-    if (activeRelay == rindex) {
-      relayOff((RelayIndex)rindex);
+    const uint8_t mask = relayBit(R_LEFT) | relayBit(R_RIGHT);
+    const bool running = Flasher::activeMask() == mask;
+    Flasher::stop();
+    if (running) {
+      relaysUpdate(mask, 0);
       activeRelay = -1;
-      Buzzer::beep();
-      return;
+    } else {
+      relaysUpdate(RELAY_MASK_OUTPUTS, 0);
+      Flasher::start(mask);
+      activeRelay = RF::SLOT_HAZARD;
     }
-    for (int i = 0; i < 6; ++i) relayOff((RelayIndex)i);
-    relayOn((RelayIndex)rindex);
-    activeRelay = rindex;
     Buzzer::beep();
   }
 
@@ -187,175 +261,166 @@ bool begin() {
   // Configure RF data pin as plain INPUT (no pull-up - SYN480R has its own output driver)
   pinMode(PIN_RF_DATA, INPUT);
   
-  // Verify the pin supports interrupts
-  int8_t interruptNum = digitalPinToInterrupt(PIN_RF_DATA);
-  if (interruptNum == NOT_AN_INTERRUPT) {
-    Serial.println("[RF] ERROR: PIN_RF_DATA does not support interrupts!");
+  // Edges are timestamped by the RMT peripheral; no per-edge GPIO interrupt
+  if (!RmtCapture::begin(PIN_RF_DATA, NoiseMonitor::TOL_START)) {
+    Serial.println("[RF] ERROR: RMT capture could not start");
     return false;
   }
   
-  // Configure rc-switch with more tolerant settings for better compatibility
-  g_rc.enableReceive(interruptNum);
-  
-  // Set receive tolerance (default is 60, increase for noisy/marginal signals)
-  // Higher values = more tolerant of timing variations
-  g_rc.setReceiveTolerance(80);
-  
-  // Optional: Enable specific protocols if you know which one your remote uses
-  // Uncomment and adjust if you want to filter protocols:
-  // g_rc.enableReceive(interruptNum);
-  // g_rc.disableReceive();
-  // g_rc.setProtocol(1); // Enable only protocol 1
-  // g_rc.enableReceive(interruptNum);
-  
   loadPrefs();
+  g_noise.reset(millis(), noiseCounters());
+  applyReceiverConfig();
+  g_votes.reset();
   g_last_activity_ms = millis();
   Serial.println("[RF] Initialized successfully");
   return true;
 }
 
-// Runtime: actuate on a single exact match (EV1527 code) to improve responsiveness.
+// Runtime: match frames against the code table and let the burst voter decide when to fire
 void service() {
   uint32_t nowMs = millis();
-  // If an active burst has gone quiet, finalize it
-  if (g_agg.active && ((nowMs - g_agg.lastMs) > BURST_GAP_MS || (nowMs - g_agg.startMs) > MAX_BURST_MS)) finalizeBurst();
-  // If in cooldown, ignore frames
-  if (nowMs < g_block_until_ms) return;
-
-  uint32_t sig, sum; uint16_t len;
-  // Fetch a frame from rc-switch
-  if (!computeFromRcSwitch(sig, sum, len)) return;
-
-  // Determine best candidate index with scoring
-  auto scoreOf = [&](int i){
-    uint32_t dsum = (g_learn[i].sum > sum) ? (g_learn[i].sum - sum) : (sum - g_learn[i].sum);
-    uint16_t glen = g_learn[i].len;
-    uint32_t ldiff = (glen > len) ? (glen - len) : (len - glen);
-    return (dsum << 4) + ldiff;
-  };
-
-  int candidate = -1; uint32_t candScore = 0xFFFFFFFFu;
-  // Prefer exact signature matches; if multiple, pick closest by score
-  for (int i = 0; i < 6; ++i) {
-    if (g_learn[i].sig != 0 && g_learn[i].sig == sig) {
-      uint32_t sc = scoreOf(i);
-      if (sc < candScore) { candScore = sc; candidate = i; }
+  // Learning owns every frame until it ends; nothing is actuated meanwhile
+  if (g_learnSes.active) {
+    if ((int32_t)(nowMs - g_learnSes.deadline) >= 0) {
+      Serial.println("[RF] Learning timeout - no consistent signal received");
+      learnEnd(LearnEvent::TimedOut);
+      return;
     }
+    OokFrame f;
+    while (g_learnSes.active && nextFrame(f)) learnFrame(f, nowMs);
+    return;
   }
-  // Consider EV-like common bit-lengths as "exact" class for voting weight
-  bool evFrame = (len == 24 || len == 28 || len == 32);
-  if (candidate < 0) {
-    // Coarse fallback: require single close match
-    int coarseIdx = -1; uint32_t bestSc = 0xFFFFFFFFu; int matches = 0;
-    for (int i = 0; i < 6; ++i) {
-      if (g_learn[i].sig == 0) continue;
-      uint32_t dsum = (g_learn[i].sum > sum) ? (g_learn[i].sum - sum) : (sum - g_learn[i].sum);
-      uint16_t glen = g_learn[i].len;
-      if (dsum <= 6 && len + 2 >= glen && len <= glen + 2) {
-        uint32_t sc = scoreOf(i);
-        if (sc < bestSc) { bestSc = sc; coarseIdx = i; }
-        matches++;
-      }
-    }
-    if (matches == 1 && coarseIdx >= 0) { candidate = coarseIdx; candScore = bestSc; }
+
+  // Retune tolerance / gate once per noise window
+  if (g_noise.update(nowMs, noiseCounters())) {
+    const NoiseMonitor::Quality& q = g_noise.quality();
+    applyReceiverConfig();
+#ifdef RF_DEBUG
+    Serial.printf("[RF] noise %u/s stray %u/min unmatched %u/min -> tol %u%% gate %u, quality %u%%\n",
+                  q.noisePerSec, q.strayPerMin, q.unmatchedPerMin, q.tolPct, q.gateLevel, q.percent);
+#else
+    (void)q;
+#endif
   }
 
-  // Accumulate vote; do not actuate yet — wait for end of burst for stability
-  if (candidate >= 0) {
-    if (!g_agg.active) { g_agg.active = true; g_agg.startMs = nowMs; }
-    g_agg.lastMs = nowMs;
-    if (evFrame) {
-      g_agg.anyEv = true;
-      uint8_t weight = 2; // EV frames are reliable, count more
-      uint16_t newVotes = (uint16_t)g_agg.votes[candidate] + weight;
-      g_agg.votes[candidate] = (uint8_t)(newVotes > 255 ? 255 : newVotes);
-      if (candScore < g_agg.bestScore[candidate]) g_agg.bestScore[candidate] = candScore;
-    } else {
-      // Only track coarse votes if no EV frames seen in this burst
-      if (!g_agg.anyEv) {
-        uint16_t newVotes = (uint16_t)g_agg.coarseVotes[candidate] + 1;
-        g_agg.coarseVotes[candidate] = (uint8_t)(newVotes > 255 ? 255 : newVotes);
-      }
-    }
-  } else {
-    // no candidate; do not extend lastMs so quiet gap can be detected
+  // If an active burst has gone quiet, finalize it
+  int winner;
+  if (g_votes.poll(nowMs, winner) && winner >= 0) fireWinner(winner);
+
+  OokFrame f;
+  if (!nextFrame(f)) return;
+  // In cooldown: the frame is the tail of the press that just fired
+  if (g_votes.blocked(nowMs)) return;
+
+  // One hash probe; the tag score breaks ties between remotes sharing a code
+  uint32_t candScore = 0xFFFFFFFFu;
+  const RfCode* hit = g_codes.find(f.value, f.protocol, f.bits, &candScore);
+  // No candidate: do not extend the burst so its quiet gap can be detected
+  if (!hit || hit->slot >= SLOT_COUNT) {
+    g_unmatched++;
+    return;
   }
+  // Frames from a chip decoder (fixed length, chip timing, frame checks) vote
+  // as "exact"; generic-table guesses only count as coarse
+  bool evFrame = OokDecoder::structured(f);
+
+  // Accumulate vote; normally actuation waits for the end of the burst, in
+  // fast mode the first confident frame fires and the rest only suppresses
+  const int fastSlot = g_votes.vote(hit->slot, evFrame, candScore, nowMs);
+  if (fastSlot >= 0) fireWinner(fastSlot);
 }
 
 bool isPresent() {
-  // With a passive OOK receiver and rc-switch, we can't probe hardware presence.
+  // A passive OOK receiver can't be probed for hardware presence.
   // Treat RF as present so the UI doesn't warn just because no activity occurred recently.
   return true;
 }
 
-// Learning: require two consistent captures (within 2s) and decent fingerprint.
-bool learn(int relayIndex) {
-  if (relayIndex < 0) relayIndex = 0;
-  if (relayIndex > 5) relayIndex = 5;
-  uint32_t deadline = millis() + 8000;
-  uint32_t lastSig = 0, lastSum = 0, lastAt = 0;
-  uint16_t lastLen = 0;
-  
-  Serial.printf("[RF] Learning for relay %d (press button now)...\n", relayIndex);
-
-  while (millis() < deadline) {
-    uint32_t sig, sum; uint16_t len;
-    if (!computeFromRcSwitch(sig, sum, len)) { delay(20); continue; }
-    Serial.printf("[RF] Learn: Received sig=%lu sum=%lu len=%u\n", sig, sum, len);
-    // require basic repeat consistency
-    if (lastSig != 0) {
-      if (sig == lastSig && (millis() - lastAt) <= 3000) {
-        g_learn[relayIndex].sig = sig;
-        g_learn[relayIndex].sum = sum;
-        g_learn[relayIndex].len = len;
-        g_learn[relayIndex].relay = (uint8_t)relayIndex;
-        saveSlot(relayIndex);
-        return true;
-      }
-      // or accept if coarse sum is close on repeat
-      uint32_t diff = (lastSum > sum) ? (lastSum - sum) : (sum - lastSum);
-      if (diff <= 6 && (millis() - lastAt) <= 3000 && (len + 2 >= lastLen && len <= lastLen + 2)) {
-        g_learn[relayIndex].sig = sig;
-        g_learn[relayIndex].sum = sum;
-        g_learn[relayIndex].len = len;
-        g_learn[relayIndex].relay = (uint8_t)relayIndex;
-        saveSlot(relayIndex);
-        return true;
-      }
-    }
-    lastSig = sig;
-    lastSum = sum;
-    lastLen = len;
-    lastAt = millis();
-    delay(20);
+bool learnStart(int slot) {
+  if (g_learnSes.active) return false;
+  if (slot < 0) slot = 0;
+  if (slot > SLOT_COUNT - 1) slot = SLOT_COUNT - 1;
+  // Frames queued before the prompt belong to whatever was pressed earlier
+  OokFrame stale;
+  while (RmtCapture::take(stale)) {}
+  g_votes.reset();
+  g_learnSes = {};
+  g_learnSes.active = true;
+  g_learnSes.slot = (int8_t)slot;
+  g_learnSes.deadline = millis() + LEARN_WINDOW_MS;
+  applyReceiverConfig();
+  Serial.printf("[RF] Learning for relay %d (press button now)...\n", slot);
+  return true;
+}
+
+void learnCancel() {
+  if (g_learnSes.active) learnEnd(LearnEvent::Cancelled);
+}
+
+LearnStatus learnStatus() {
+  LearnStatus st;
+  st.active = g_learnSes.active;
+  st.slot = g_learnSes.slot;
+  st.heard = g_learnSes.heard;
+  if (st.active) {
+    int32_t left = (int32_t)(g_learnSes.deadline - millis());
+    st.msLeft = left > 0 ? (uint32_t)left : 0;
   }
-  Serial.println("[RF] Learning timeout - no consistent signal received");
-  return false;
+  return st;
+}
+
+LearnEvent pollLearnEvent() {
+  if (g_learnEvTail == g_learnEvHead) return LearnEvent::None;
+  return g_learnEvents[g_learnEvTail++ & (LEARN_EVENT_QUEUE - 1)];
 }
 
 bool clearAll() {
   // Clear all learned codes
-
-  for (int i = 0; i < 6; ++i) {
-    g_learn[i].sig = 0;
-    g_learn[i].sum = 0;
-    g_learn[i].len = 0;
-    g_learn[i].relay = (uint8_t)i;
-    saveSlot(i);
-  }
+  g_codes.clear();
+  saveCodes();
+  applyReceiverConfig();
   return true;
 }
 
+void setFastConfirm(uint8_t frames) {
+  g_votes.setFastConfirm(frames);
+  g_prefs.putUChar(KEY_RF_FAST, g_votes.fastConfirm());
+}
+
+uint8_t fastConfirm() {
+  return g_votes.fastConfirm();
+}
+
+uint8_t remoteCount(int slot) {
+  if (slot < 0 || slot >= SLOT_COUNT) return 0;
+  return g_codes.countForSlot((uint8_t)slot);
+}
+
+SignalQuality signalQuality() {
+  const NoiseMonitor::Quality& q = g_noise.quality();
+  SignalQuality s;
+  s.percent = q.percent;
+  s.noisePerSec = q.noisePerSec;
+  s.strayPerMin = q.strayPerMin;
+  s.unmatchedPerMin = q.unmatchedPerMin;
+  s.tolerancePct = q.tolPct;
+  s.gateLevel = q.gateLevel;
+  return s;
+}
+
 int8_t getActiveRelay() {
   return activeRelay;
 }
 
 void reset() {
   // Turn off all RF-controlled relays and clear active state
-  for (int i = 0; i < 6; ++i) {
-    relayOff((RelayIndex)i);
-  }
+  Flasher::stop();
+  relaysUpdate(RELAY_MASK_OUTPUTS, 0);
   activeRelay = -1;
 }
 
+void setTriggerHook(bool (*hook)(int slot)) {
+  g_triggerHook = hook;
+}
+
 } // namespace RF
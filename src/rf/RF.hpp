@@ -5,25 +5,81 @@
 
 namespace RF {
 
+// Learn slots 0..5 map to relays; the extra slots start the stored test
+// sequence and toggle the hazard flashers (LEFT+RIGHT, always flashing)
+static constexpr int SLOT_SEQUENCE = 6;
+static constexpr int SLOT_HAZARD   = 7;
+static constexpr int SLOT_COUNT    = 8;
+
 // Initialize SYN480R receiver and load saved codes
 bool begin();
 
 // Poll and process RF frames (call this often in loop)
 void service();
 
-// Always true in rc-switch mode (passive receiver can't be probed)
+// Always true (passive receiver can't be probed)
 bool isPresent();
 
-// Learn the current remote button and bind it to a relay [0..5]
-bool learn(int relayIndex);
+// Learning runs inside service(): start it for a slot [0..SLOT_COUNT-1], then
+// poll status/events until it ends. Two consistent captures bind the button;
+// a slot keeps every remote learned for it until clearAll().
+enum class LearnEvent : uint8_t {
+  None,
+  Heard,        // first capture of a new code; press/hold again to confirm
+  Mismatch,     // a different code arrived; it becomes the new candidate
+  Saved,
+  TableFull,
+  TimedOut,
+  Cancelled,
+};
+
+struct LearnStatus {
+  bool     active = false;
+  int8_t   slot = -1;
+  uint8_t  heard = 0;          // captures seen in this session
+  uint32_t msLeft = 0;
+};
+
+// False while another learn session is running
+bool learnStart(int slot);
+void learnCancel();
+LearnStatus learnStatus();
+
+// Oldest unread progress event (None when empty)
+LearnEvent pollLearnEvent();
 
-// Clear all saved remote signatures (all slots 0..5)
+// Clear all saved remote signatures (all slots)
 bool clearAll();
 
-// Get the currently active relay index from RF (-1 if none)
+// Response mode: 0 = fire when the button burst ends (robust, ~0.5 s); N =
+// fire on the first N consecutive exact frames from one remote (fast mode,
+// see BurstVoter). Persisted.
+static constexpr uint8_t FAST_CONFIRM_MAX = 3;
+void setFastConfirm(uint8_t frames);
+uint8_t fastConfirm();
+
+// Remotes currently bound to a slot
+uint8_t remoteCount(int slot);
+
+// Receiver health from the noise monitor, refreshed every few seconds
+struct SignalQuality {
+  uint8_t  percent = 100;       // heuristic: 100 = quiet band, no stray frames
+  uint16_t noisePerSec = 0;     // undecodable captures per second (noise floor)
+  uint16_t strayPerMin = 0;     // hiss that decoded once but never repeated
+  uint16_t unmatchedPerMin = 0; // confirmed frames matching no learned remote
+  uint8_t  tolerancePct = 0;    // current adapted decoder tolerance
+  uint8_t  gateLevel = 0;       // 0 = default noise gate, higher = stricter
+};
+SignalQuality signalQuality();
+
+// Get the currently active relay index from RF (-1 if none, SLOT_HAZARD for hazard)
 int8_t getActiveRelay();
 
 // Reset RF state: disable all outputs and clear active relay
 void reset();
 
+// Optional hook consulted for every decoded press before relays are touched.
+// Return true to consume the press (e.g. to start/abort a test sequence).
+void setTriggerHook(bool (*hook)(int slot));
+
 } // namespace RF
@@ -0,0 +1,34 @@
+// File Overview: Defines the RF recording stream format (raw RMT captures and the frames
+// decoded from them, with timestamps) shared by the firmware recorder and host tools.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Stream: MAGIC, then records back to back, all little-endian.
+//   capture: 'C' tMs:u32 n:u16 n*u16 pulse (bit 15 = level, bits 0..14 = us)
+//   frame:   'F' tMs:u32 value:u32 bits:u8 protocol:u8   (repeat-confirmed decode)
+// Durations saturate at 32767us; the RMT idle gap ends captures well before that.
+namespace RfRecord {
+  static constexpr uint8_t MAGIC[4] = {'R', 'F', 'R', '1'};
+  static constexpr uint8_t TYPE_CAPTURE = 'C';
+  static constexpr uint8_t TYPE_FRAME   = 'F';
+  static constexpr size_t  CAPTURE_HEADER = 1 + 4 + 2;
+  static constexpr size_t  FRAME_BYTES    = 1 + 4 + 4 + 1 + 1;
+  static constexpr uint16_t MAX_US = 0x7FFF;
+
+  inline void put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+  inline void put32(uint8_t* p, uint32_t v) { put16(p, (uint16_t)v); put16(p + 2, (uint16_t)(v >> 16)); }
+  inline uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+  inline uint32_t get32(const uint8_t* p) { return (uint32_t)get16(p) | ((uint32_t)get16(p + 2) << 16); }
+
+  inline uint16_t packPulse(uint16_t us, uint8_t level) {
+    return (uint16_t)((us > MAX_US ? MAX_US : us) | (level ? 0x8000u : 0u));
+  }
+
+  // Size of the record whose first CAPTURE_HEADER bytes are 'hdr' (0 = corrupt)
+  inline size_t recordSize(const uint8_t* hdr) {
+    if (hdr[0] == TYPE_FRAME) return FRAME_BYTES;
+    if (hdr[0] == TYPE_CAPTURE) return CAPTURE_HEADER + 2u * get16(hdr + 5);
+    return 0;
+  }
+}
@@ -0,0 +1,251 @@
+// File Overview: Implements the RMT OOK capture task: legacy RMT RX driver setup on core 0,
+// ring-buffer item conversion into pulse arrays, decoding, the capture recorder and the
+// periodic interrupt/decode-time report.
+#include "RmtCapture.hpp"
+#include <driver/rmt.h>
+#include <freertos/queue.h>
+#include <freertos/ringbuf.h>
+#include "esp_timer.h"
+#include "RfRecord.hpp"
+
+namespace {
+  // S3: channels 4..7 are RX-only; two memory blocks hold 96 items (192 edges)
+  constexpr rmt_channel_t CHANNEL     = RMT_CHANNEL_4;
+  constexpr uint8_t  MEM_BLOCKS       = 2;
+  constexpr size_t   RINGBUF_BYTES    = 4096;
+  constexpr uint8_t  FILTER_APB_TICKS = 240;     // drop glitches shorter than 3us (80MHz APB)
+  constexpr uint8_t  FRAME_QUEUE_LEN  = 8;
+  constexpr uint32_t REPORT_MS        = 60000;
+
+  TaskHandle_t  g_task = nullptr;
+  QueueHandle_t g_frames = nullptr;
+  OokDecoder    g_decoder;
+  uint8_t       g_pin = 0;
+  // Decoder settings written by the loop task, applied before each capture
+  volatile uint8_t  g_tolerance = 60;
+  volatile uint8_t  g_families = OokDecoder::ALL_FAMILIES;
+  volatile uint16_t g_minPulseUs = OokDecoder::MIN_PULSE_US;
+  volatile uint8_t  g_glitchDiv = 8;
+
+  RmtCapture::Stats g_stats;
+  portMUX_TYPE  g_mux = portMUX_INITIALIZER_UNLOCKED;
+
+  OokPulse g_pulses[OokDecoder::MAX_PULSES];
+
+  // Recorder ring; head/tail are running byte counts (index = count % size)
+  uint8_t*      g_rec = nullptr;
+  uint32_t      g_recHead = 0, g_recTail = 0;
+  bool          g_recOn = false;
+  portMUX_TYPE  g_recMux = portMUX_INITIALIZER_UNLOCKED;
+
+  inline uint8_t& recAt(uint32_t i) { return g_rec[i % RmtCapture::RECORD_BYTES]; }
+
+  // Caller holds g_recMux. Whole records only: evict from the tail until it fits.
+  void recAppend(const uint8_t* hdr, size_t hdrLen, const uint16_t* words, size_t nWords) {
+    const size_t len = hdrLen + 2 * nWords;
+    if (len > RmtCapture::RECORD_BYTES) return;
+    while (RmtCapture::RECORD_BYTES - (g_recHead - g_recTail) < len) {
+      uint8_t h[RfRecord::CAPTURE_HEADER];
+      for (size_t k = 0; k < sizeof(h); ++k) h[k] = recAt(g_recTail + k);
+      const size_t sz = RfRecord::recordSize(h);
+      if (!sz) { g_recTail = g_recHead; break; }   // cannot happen; start over rather than loop
+      g_recTail += sz;
+    }
+    for (size_t k = 0; k < hdrLen; ++k) recAt(g_recHead++) = hdr[k];
+    for (size_t k = 0; k < nWords; ++k) {
+      recAt(g_recHead++) = (uint8_t)words[k];
+      recAt(g_recHead++) = (uint8_t)(words[k] >> 8);
+    }
+  }
+
+  void recordCapture(const rmt_item32_t* items, size_t count, uint32_t tMs) {
+    static uint16_t words[2 * 96];
+    size_t n = 0;
+    for (size_t i = 0; i < count && n + 2 <= sizeof(words) / sizeof(words[0]); ++i) {
+      if (!items[i].duration0) break;
+      words[n++] = RfRecord::packPulse(items[i].duration0, items[i].level0);
+      if (!items[i].duration1) break;
+      words[n++] = RfRecord::packPulse(items[i].duration1, items[i].level1);
+    }
+    uint8_t hdr[RfRecord::CAPTURE_HEADER];
+    hdr[0] = RfRecord::TYPE_CAPTURE;
+    RfRecord::put32(hdr + 1, tMs);
+    RfRecord::put16(hdr + 5, (uint16_t)n);
+    portENTER_CRITICAL(&g_recMux);
+    if (g_recOn) recAppend(hdr, sizeof(hdr), words, n);
+    portEXIT_CRITICAL(&g_recMux);
+  }
+
+  void recordFrame(const OokFrame& f, uint32_t tMs) {
+    uint8_t r[RfRecord::FRAME_BYTES];
+    r[0] = RfRecord::TYPE_FRAME;
+    RfRecord::put32(r + 1, tMs);
+    RfRecord::put32(r + 5, f.value);
+    r[9] = f.bits;
+    r[10] = f.protocol;
+    portENTER_CRITICAL(&g_recMux);
+    if (g_recOn) recAppend(r, sizeof(r), nullptr, 0);
+    portEXIT_CRITICAL(&g_recMux);
+  }
+
+  // Returns the pulse count, or MAX_PULSES + 1 when the capture is too long to be a frame
+  size_t toPulses(const rmt_item32_t* items, size_t count) {
+    size_t n = 0;
+    for (size_t i = 0; i < count; ++i) {
+      const uint16_t d[2] = {(uint16_t)items[i].duration0, (uint16_t)items[i].duration1};
+      const uint8_t  l[2] = {(uint8_t)items[i].level0, (uint8_t)items[i].level1};
+      for (uint8_t k = 0; k < 2; ++k) {
+        if (d[k] == 0) return n;                 // end marker: the idle level that ended the capture
+        if (n >= OokDecoder::MAX_PULSES) return OokDecoder::MAX_PULSES + 1;
+        g_pulses[n++] = OokPulse{d[k], l[k]};
+      }
+    }
+    return n;
+  }
+
+  // Measured figures only: edge and interrupt rates from the driver's items,
+  // and the capture task's own time (esp_timer around convert + decode)
+  void report(const RmtCapture::Stats& now, const RmtCapture::Stats& prev, uint32_t spanMs) {
+    const float s = spanMs / 1000.0f;
+    const float edges = (now.edges - prev.edges) / s;
+    const float caps = (now.captures - prev.captures) / s;
+    const float decode = (now.decodeUs - prev.decodeUs) / s;
+    Serial.printf("[RF] RMT %.0f edges/s in %.0f interrupts/s, decode %.0f us/s (%.3f%% of core 0), gated %lu\n",
+                  edges, caps, decode, decode / 1e4f,
+                  (unsigned long)(now.decoder.gated - prev.decoder.gated));
+  }
+
+  void captureTask(void*) {
+    // The driver's ISR is allocated on the installing core: keep it off core 1
+    rmt_config_t cfg = RMT_DEFAULT_CONFIG_RX((gpio_num_t)g_pin, CHANNEL);
+    cfg.clk_div = 80;                            // 1us ticks
+    cfg.mem_block_num = MEM_BLOCKS;
+    cfg.rx_config.filter_en = true;
+    cfg.rx_config.filter_ticks_thresh = FILTER_APB_TICKS;
+    cfg.rx_config.idle_threshold = RmtCapture::IDLE_US;
+    RingbufHandle_t rb = nullptr;
+    if (rmt_config(&cfg) != ESP_OK || rmt_driver_install(CHANNEL, RINGBUF_BYTES, 0) != ESP_OK ||
+        rmt_get_ringbuf_handle(CHANNEL, &rb) != ESP_OK || !rb) {
+      Serial.println("[RF] RMT RX setup failed");
+      g_task = nullptr;
+      vTaskDelete(nullptr);
+      return;
+    }
+    rmt_rx_start(CHANNEL, true);
+
+    RmtCapture::Stats prev;
+    uint32_t reportAt = millis() + REPORT_MS;
+    uint32_t windowStart = millis();
+    for (;;) {
+      size_t bytes = 0;
+      rmt_item32_t* items = (rmt_item32_t*)xRingbufferReceive(rb, &bytes, pdMS_TO_TICKS(250));
+      if (items) {
+        const uint32_t t0 = (uint32_t)esp_timer_get_time();
+        const size_t count = bytes / sizeof(rmt_item32_t);
+        const size_t n = toPulses(items, count);
+        const uint32_t tMs = millis();
+        if (g_recOn) recordCapture(items, count, tMs);
+        vRingbufferReturnItem(rb, items);
+
+        OokFrame f;
+        g_decoder.setFamilies(g_families);
+        g_decoder.setTolerance(g_tolerance);
+        g_decoder.setGate(g_minPulseUs, g_glitchDiv);
+        const bool got = g_decoder.decode(g_pulses, n, f);
+        if (got) {
+          xQueueSend(g_frames, &f, 0);
+          if (g_recOn) recordFrame(f, tMs);
+        }
+        const uint32_t dt = (uint32_t)esp_timer_get_time() - t0;
+
+        portENTER_CRITICAL(&g_mux);
+        g_stats.edges += count * 2;
+        g_stats.captures++;
+        g_stats.decodeUs += dt;
+        g_stats.decoder = g_decoder.stats();
+        portEXIT_CRITICAL(&g_mux);
+      }
+
+      const uint32_t nowMs = millis();
+      if ((int32_t)(nowMs - reportAt) >= 0) {
+        const RmtCapture::Stats now = RmtCapture::stats();
+        report(now, prev, nowMs - windowStart);
+        prev = now;
+        windowStart = nowMs;
+        reportAt = nowMs + REPORT_MS;
+      }
+    }
+  }
+}
+
+namespace RmtCapture {
+
+bool begin(uint8_t pin, uint8_t tolerancePct){
+  if (g_task) return true;
+  g_pin = pin;
+  g_tolerance = tolerancePct;
+  g_frames = xQueueCreate(FRAME_QUEUE_LEN, sizeof(OokFrame));
+  if (!g_frames) return false;
+  // Core 0 with the sampler, below the NimBLE host
+  return xTaskCreatePinnedToCore(captureTask, "rfcap", 4096, nullptr, 3, &g_task, 0) == pdPASS;
+}
+
+bool take(OokFrame& out){
+  return g_frames && xQueueReceive(g_frames, &out, 0) == pdTRUE;
+}
+
+void setFamilies(uint8_t mask){
+  g_families = mask;
+}
+
+void setTolerance(uint8_t pct){
+  g_tolerance = pct;
+}
+
+void setGate(uint16_t minPulseUs, uint8_t glitchDiv){
+  g_minPulseUs = minPulseUs;
+  g_glitchDiv = glitchDiv;
+}
+
+Stats stats(){
+  portENTER_CRITICAL(&g_mux);
+  Stats s = g_stats;
+  portEXIT_CRITICAL(&g_mux);
+  return s;
+}
+
+void setRecording(bool on){
+  if (on && !g_rec) {
+    g_rec = (uint8_t*)malloc(RECORD_BYTES);
+    if (!g_rec) {
+      Serial.println("[RF] Recorder: out of memory");
+      return;
+    }
+  }
+  portENTER_CRITICAL(&g_recMux);
+  if (on) g_recHead = g_recTail = 0;
+  g_recOn = on && g_rec;
+  portEXIT_CRITICAL(&g_recMux);
+}
+
+bool recording(){ return g_recOn; }
+
+size_t recordSize(){
+  portENTER_CRITICAL(&g_recMux);
+  const size_t n = sizeof(RfRecord::MAGIC) + (g_recHead - g_recTail);
+  portEXIT_CRITICAL(&g_recMux);
+  return n;
+}
+
+size_t readRecord(size_t pos, uint8_t* out, size_t max){
+  if (g_recOn || !out) return 0;
+  const size_t total = recordSize();
+  size_t n = 0;
+  for (; n < max && pos < total; ++n, ++pos) {
+    out[n] = pos < sizeof(RfRecord::MAGIC) ? RfRecord::MAGIC[pos]
+                                           : recAt(g_recTail + (uint32_t)(pos - sizeof(RfRecord::MAGIC)));
+  }
+  return n;
+}
+
+} // namespace RmtCapture
@@ -0,0 +1,46 @@
+// File Overview: Declares the RMT-based OOK receiver front end: the peripheral timestamps
+// the SYN480R pulse trains in hardware and a core-0 task decodes completed captures.
+#pragma once
+#include <Arduino.h>
+#include "OokDecoder.hpp"
+
+// rc-switch took an interrupt on every DATA edge. An idle SYN480R outputs
+// AGC hiss, so that was thousands of interrupts/s on the protection core.
+// Here the RMT channel records edges into its own memory and raises one
+// interrupt per capture (ended by an idle gap) or per overflow; the decoder
+// and its noise gate run on whole captures in task context on core 0.
+namespace RmtCapture {
+  // rc-switch's separation limit: a longer quiet level ends a capture (the sync gap)
+  static constexpr uint16_t IDLE_US = 4300;
+
+  struct Stats {
+    uint32_t edges = 0;          // pulses delivered by the peripheral
+    uint32_t captures = 0;       // ring-buffer items (one interrupt each)
+    uint32_t decodeUs = 0;       // task time spent converting and decoding
+    OokDecoder::Stats decoder;
+  };
+
+  bool begin(uint8_t pin, uint8_t tolerancePct);
+
+  // Loop task: next repeat-confirmed frame, if any
+  bool take(OokFrame& out);
+
+  // Decoder settings, applied from the next capture: registry mask
+  // (OokDecoder::familyBit), timing tolerance and noise gate
+  void setFamilies(uint8_t mask);
+  void setTolerance(uint8_t pct);
+  void setGate(uint16_t minPulseUs, uint8_t glitchDiv);
+
+  // Cumulative counters since begin()
+  Stats stats();
+
+  // Recorder: every raw capture plus each decoded frame, timestamped, into a
+  // RAM ring (oldest records dropped when full) - see RfRecord.hpp
+  static constexpr size_t RECORD_BYTES = 16384;
+  void   setRecording(bool on);        // on = start a fresh recording
+  bool   recording();
+  size_t recordSize();                 // stream bytes, magic included
+
+  // Stream bytes from 'pos'; only while recording is off (the ring is frozen)
+  size_t readRecord(size_t pos, uint8_t* out, size_t max);
+}
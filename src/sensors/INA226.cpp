@@ -87,6 +87,14 @@ float INA226::readCurrentA(){
   return s_invertLoad ? -a : a;
 }
 
+bool INA226::readCurrentIfReady(float& a){
+  if (!PRESENT) return false;
+  uint16_t me = rd16_or0(ADDR_LOAD, 0x06);
+  if (!(me & (1u << 3))) return false;   // CVRF
+  a = readCurrentA();
+  return true;
+}
+
 bool INA226::ocpActive(){
   if (!PRESENT) return false;
   float a = fabsf(readCurrentA());
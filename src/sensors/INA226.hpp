@@ -12,6 +12,9 @@ namespace INA226 {
   float  readBusV();
   float  readCurrentA();
   bool   ocpActive();
+  // True (and 'a' set) only once per finished conversion; reading the
+  // Mask/Enable register clears the conversion-ready flag
+  bool   readCurrentIfReady(float& a);
 
   // Optional polarity inversion for load current
   void   setInvert(bool on);
@@ -0,0 +1,75 @@
+// File Overview: Implements the load-current sampler task (conversion-ready polling of the
+// load INA226) and the lock-free single-producer broadcast ring.
+#include "LoadSampler.hpp"
+#include "esp_timer.h"
+#include "INA226.hpp"
+
+namespace {
+  static_assert((LoadSampler::RING_SIZE & (LoadSampler::RING_SIZE - 1)) == 0, "RING_SIZE must be a power of two");
+  constexpr uint32_t RING_MASK = LoadSampler::RING_SIZE - 1;
+
+  LoadSampler::Sample g_ring[LoadSampler::RING_SIZE];
+  volatile uint32_t   g_head = 0;          // next sequence number to write
+  TaskHandle_t        g_task = nullptr;
+
+  volatile float    g_rateHz = 0.0f;
+  uint32_t          g_rateStartUs = 0;
+  uint32_t          g_rateStartSeq = 0;
+
+  // Wire (arduino-esp32 2.x) serializes transactions with its own lock, so the
+  // loop's reads of the same sensors interleave safely with this task.
+  void samplerTask(void*) {
+    for (;;) {
+      float a;
+      if (INA226::readCurrentIfReady(a)) {
+        const uint32_t seq = g_head;
+        g_ring[seq & RING_MASK] = LoadSampler::Sample{(uint32_t)esp_timer_get_time(), a};
+        __atomic_store_n(&g_head, seq + 1, __ATOMIC_RELEASE);
+
+        const uint32_t nowUs = g_ring[seq & RING_MASK].tUs;
+        if (nowUs - g_rateStartUs >= 1000000u) {
+          g_rateHz = (float)(seq + 1 - g_rateStartSeq) * 1e6f / (float)(nowUs - g_rateStartUs);
+          g_rateStartUs = nowUs;
+          g_rateStartSeq = seq + 1;
+        }
+      }
+      // A conversion takes ~2.7ms; polling each tick catches every one
+      vTaskDelay(1);
+    }
+  }
+}
+
+namespace LoadSampler {
+
+void begin(){
+  if (g_task || !INA226::PRESENT) return;
+  g_rateStartUs = (uint32_t)esp_timer_get_time();
+  // Core 0, below the NimBLE host: the loop (core 1) keeps its timing
+  xTaskCreatePinnedToCore(samplerTask, "ldsamp", 3072, nullptr, 2, &g_task, 0);
+}
+
+size_t take(Reader& r, Sample* out, size_t max){
+  const uint32_t head = __atomic_load_n(&g_head, __ATOMIC_ACQUIRE);
+  if (!r.primed) {
+    r.cursor = head;
+    r.primed = true;
+    return 0;
+  }
+  // Leave a margin: the producer may be writing the oldest slot right now
+  if (head - r.cursor > RING_SIZE - 8) {
+    uint32_t fresh = head - (RING_SIZE / 2);
+    r.lost += fresh - r.cursor;
+    r.cursor = fresh;
+  }
+  size_t n = 0;
+  while (n < max && r.cursor != head) {
+    out[n++] = g_ring[r.cursor & RING_MASK];
+    r.cursor++;
+  }
+  return n;
+}
+
+uint32_t produced(){ return __atomic_load_n(&g_head, __ATOMIC_ACQUIRE); }
+float    rateHz(){ return g_rateHz; }
+
+} // namespace LoadSampler
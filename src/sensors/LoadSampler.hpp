@@ -0,0 +1,31 @@
+// File Overview: Declares the load-current sampler task that reads every INA226 conversion
+// into a broadcast ring, so analysis (flicker, spectra, recording) runs at the sensor's
+// full rate without adding work to the protection loop.
+#pragma once
+#include <Arduino.h>
+
+// One producer (the sampler task), any number of loop-side readers. Each
+// reader keeps its own cursor; a reader that falls more than RING_SIZE behind
+// (e.g. the loop was parked in a modal) is resynced and told how much it lost.
+namespace LoadSampler {
+  static constexpr uint32_t RING_SIZE = 512;       // power of two, ~1.4s at 370 S/s
+
+  struct Sample {
+    uint32_t tUs;      // esp_timer time of the read (low 32 bits)
+    float    amps;     // signed, as INA226::readCurrentA()
+  };
+
+  struct Reader {
+    uint32_t cursor = 0;
+    uint32_t lost = 0;           // samples skipped by overruns, cumulative
+    bool     primed = false;     // first take() starts at the newest sample
+  };
+
+  void begin();                  // after INA226::begin(); no-op without the sensor
+
+  // Copy up to 'max' new samples for this reader; returns the count
+  size_t take(Reader& r, Sample* out, size_t max);
+
+  uint32_t produced();           // total samples since boot
+  float    rateHz();             // measured over the last second
+}
@@ -0,0 +1,85 @@
+// File Overview: Implements the load-current block analysis: ring consumption with 50%
+// overlap into a sliding block, handed to SpectrumBlock for mean/RMS and the FFT, and
+// the latest result shared with other tasks.
+#include "LoadSpectrum.hpp"
+#include <math.h>
+#include "LoadSampler.hpp"
+
+namespace {
+  using LoadSpectrum::BLOCK;
+  using LoadSpectrum::HOP;
+
+  constexpr uint32_t FRESH_MS = 1500;    // older results fall back to snapshots
+
+  LoadSampler::Reader g_reader;
+  float    g_amps[BLOCK];          // sliding block, oldest first
+  uint32_t g_tUs[BLOCK];
+  uint16_t g_fill = 0;
+
+  SpectrumBlock g_block;
+  bool     g_ready = false;
+
+  LoadSpectrum::Result g_last;
+  portMUX_TYPE g_mux = portMUX_INITIALIZER_UNLOCKED;
+
+  void analyse(uint32_t nowMs) {
+    LoadSpectrum::Result r;
+    g_block.analyse(g_amps, g_tUs[BLOCK - 1] - g_tUs[0], r);
+    r.atMs = nowMs;
+    portENTER_CRITICAL(&g_mux);
+    g_last = r;
+    portEXIT_CRITICAL(&g_mux);
+  }
+}
+
+namespace LoadSpectrum {
+
+void begin(){
+  if (!g_block.begin()) {
+    Serial.println("[SPEC] esp-dsp FFT init failed");
+    return;
+  }
+  g_ready = true;
+}
+
+bool service(uint32_t nowMs){
+  if (!g_ready) return false;
+  LoadSampler::Sample buf[32];
+  bool analysed = false;
+  uint32_t lost = g_reader.lost;
+  size_t got;
+  while ((got = LoadSampler::take(g_reader, buf, 32)) > 0) {
+    if (g_reader.lost != lost) {
+      lost = g_reader.lost;
+      g_fill = 0;   // gap: the block would not be contiguous
+    }
+    for (size_t i = 0; i < got; ++i) {
+      g_amps[g_fill] = buf[i].amps;
+      g_tUs[g_fill] = buf[i].tUs;
+      if (++g_fill < BLOCK) continue;
+      analyse(nowMs);
+      analysed = true;
+      // Slide by HOP for 50% overlap
+      memmove(g_amps, g_amps + HOP, (BLOCK - HOP) * sizeof(float));
+      memmove(g_tUs, g_tUs + HOP, (BLOCK - HOP) * sizeof(uint32_t));
+      g_fill = BLOCK - HOP;
+    }
+  }
+  return analysed;
+}
+
+float rmsA(uint32_t nowMs){
+  if (!g_last.valid || nowMs - g_last.atMs > FRESH_MS) return NAN;
+  return g_last.rmsA;
+}
+
+Result last(){
+  portENTER_CRITICAL(&g_mux);
+  Result r = g_last;
+  portEXIT_CRITICAL(&g_mux);
+  return r;
+}
+
+bool accelerated(){ return SpectrumBlock::accelerated(); }
+
+} // namespace LoadSpectrum
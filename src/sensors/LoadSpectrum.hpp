@@ -0,0 +1,34 @@
+// File Overview: Declares the block spectral analysis of the load current: true RMS and
+// average over each block of sampler-ring conversions plus its dominant ripple tones.
+#pragma once
+#include <Arduino.h>
+#include "SpectrumBlock.hpp"
+
+// PWM LED drivers and electric-brake controllers draw pulsed current, so one
+// readCurrentA() snapshot lands anywhere between the pulse floor and peak. A
+// block of every conversion (see LoadSampler) gives a stable average and true
+// RMS; a Hann-windowed FFT of the same block names the strongest ripple tones.
+// The INA226 only converts ~370 times/s, so tones above ~185 Hz show up folded
+// (aliased) - the reported frequency is the apparent one, still useful to tell
+// a steady lamp from a pulsing load and to match a known source.
+namespace LoadSpectrum {
+  static constexpr uint16_t BLOCK = SpectrumBlock::N;   // ~0.7 s
+  static constexpr uint16_t HOP   = BLOCK / 2;          // new result every ~0.35 s
+  static constexpr uint8_t  PEAKS = SpectrumBlock::PEAKS;
+
+  using Result = SpectrumBlock::Result;
+
+  void begin();
+
+  // Loop task: consume new samples; true when a block was analysed
+  bool service(uint32_t nowMs);
+
+  // Latest RMS while it is recent enough to replace a snapshot; NAN otherwise
+  float rmsA(uint32_t nowMs);
+
+  // Any task: copy of the latest result
+  Result last();
+
+  // True when analysis uses the esp-dsp vector routines
+  bool accelerated();
+}
@@ -0,0 +1,133 @@
+// File Overview: Implements the block analysis: mean/RMS, Hann-windowed radix-2 FFT
+// (esp-dsp on target, portable C++ otherwise), median noise floor and dominant-tone picking.
+#include "SpectrumBlock.hpp"
+#include <math.h>
+#include <string.h>
+
+#if __has_include(<esp_dsp.h>)
+#include <esp_dsp.h>
+#define SPECBLOCK_HAVE_DSP 1
+#else
+#define SPECBLOCK_HAVE_DSP 0
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static_assert((SpectrumBlock::N & (SpectrumBlock::N - 1)) == 0, "N must be a power of two");
+
+bool SpectrumBlock::begin() {
+#if SPECBLOCK_HAVE_DSP
+  if (dsps_fft2r_init_fc32(nullptr, N) != ESP_OK) return false;
+  dsps_wind_hann_f32(_window, N);
+#else
+  for (uint16_t i = 0; i < N; ++i) _window[i] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / (N - 1));
+  for (uint16_t k = 0; k < N / 2; ++k) {
+    _cos[k] = cosf(2.0f * (float)M_PI * k / N);
+    _sin[k] = sinf(2.0f * (float)M_PI * k / N);
+  }
+#endif
+  _ready = true;
+  return true;
+}
+
+bool SpectrumBlock::accelerated() { return SPECBLOCK_HAVE_DSP != 0; }
+
+// In-place FFT of _fft; the portable path is an iterative radix-2 DIT
+void SpectrumBlock::fft() {
+#if SPECBLOCK_HAVE_DSP
+  dsps_fft2r_fc32(_fft, N);
+  dsps_bit_rev_fc32(_fft, N);
+#else
+  float* d = _fft;
+  for (uint16_t i = 1, j = 0; i < N; ++i) {
+    uint16_t bit = N >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) {
+      float tr = d[2 * i], ti = d[2 * i + 1];
+      d[2 * i] = d[2 * j];     d[2 * i + 1] = d[2 * j + 1];
+      d[2 * j] = tr;           d[2 * j + 1] = ti;
+    }
+  }
+  for (uint16_t len = 2; len <= N; len <<= 1) {
+    const uint16_t step = N / len;
+    for (uint16_t i = 0; i < N; i += len) {
+      for (uint16_t k = 0; k < len / 2; ++k) {
+        const float wr = _cos[k * step], wi = -_sin[k * step];
+        float* a = &d[2 * (i + k)];
+        float* b = &d[2 * (i + k + len / 2)];
+        const float tr = b[0] * wr - b[1] * wi;
+        const float ti = b[0] * wi + b[1] * wr;
+        b[0] = a[0] - tr;  b[1] = a[1] - ti;
+        a[0] += tr;        a[1] += ti;
+      }
+    }
+  }
+#endif
+}
+
+// Median of the magnitude bins as the noise floor (copy, partial selection)
+float SpectrumBlock::noiseFloor() {
+  const uint16_t n = N / 2 - 1;
+  memcpy(_tmp, &_mag[1], n * sizeof(float));
+  const uint16_t mid = n / 2;
+  for (uint16_t i = 0; i <= mid; ++i) {
+    uint16_t m = i;
+    for (uint16_t j = i + 1; j < n; ++j) if (_tmp[j] < _tmp[m]) m = j;
+    const float t = _tmp[i]; _tmp[i] = _tmp[m]; _tmp[m] = t;
+  }
+  return _tmp[mid];
+}
+
+void SpectrumBlock::analyse(const float* amps, uint32_t spanUs, Result& out) {
+  Result r;
+  float sum = 0.0f, sumSq = 0.0f;
+  for (uint16_t i = 0; i < N; ++i) {
+    sum += amps[i];
+    sumSq += amps[i] * amps[i];
+  }
+  r.meanA = sum / N;
+  r.rmsA = sqrtf(sumSq / N);
+  const float acRms = sqrtf(fmaxf(0.0f, sumSq / N - r.meanA * r.meanA));
+  r.ripplePct = fabsf(r.meanA) > 0.05f ? acRms * 100.0f / fabsf(r.meanA) : 0.0f;
+  r.sampleHz = spanUs ? (float)(N - 1) * 1e6f / (float)spanUs : 0.0f;
+  if (!_ready) { out = r; return; }
+
+  // Windowed, DC removed: the mean would otherwise leak into the low bins
+  for (uint16_t i = 0; i < N; ++i) {
+    _fft[2 * i] = (amps[i] - r.meanA) * _window[i];
+    _fft[2 * i + 1] = 0.0f;
+  }
+  fft();
+  // Hann coherent gain 0.5: single-sided peak amplitude = |X| * 2 / (N * 0.5)
+  const float scale = 4.0f / N;
+  for (uint16_t k = 0; k < N / 2; ++k) {
+    _mag[k] = sqrtf(_fft[2 * k] * _fft[2 * k] + _fft[2 * k + 1] * _fft[2 * k + 1]) * scale;
+  }
+
+  const float floorA = noiseFloor() * TONE_OVER_FLOOR;
+  const float binHz = r.sampleHz / N;
+  for (uint16_t k = 2; k < N / 2 - 1; ++k) {
+    const float m = _mag[k];
+    if (m < MIN_TONE_A || m < floorA || m < _mag[k - 1] || m < _mag[k + 1]) continue;
+    // Parabolic interpolation between bins
+    const float a = _mag[k - 1], c = _mag[k + 1];
+    const float den = a - 2.0f * m + c;
+    const float off = den != 0.0f ? 0.5f * (a - c) / den : 0.0f;
+    const float hz = (k + off) * binHz;
+    // Keep the strongest PEAKS, descending
+    uint8_t pos = r.peakCount;
+    while (pos > 0 && r.ampA[pos - 1] < m) --pos;
+    if (pos >= PEAKS) continue;
+    const uint8_t last = r.peakCount < PEAKS ? r.peakCount : PEAKS - 1;
+    for (uint8_t j = last; j > pos; --j) { r.freqHz[j] = r.freqHz[j - 1]; r.ampA[j] = r.ampA[j - 1]; }
+    r.freqHz[pos] = hz;
+    r.ampA[pos] = m;
+    if (r.peakCount < PEAKS) r.peakCount++;
+  }
+
+  r.valid = r.sampleHz > 0.0f;
+  out = r;
+}
@@ -0,0 +1,47 @@
+// File Overview: Declares the block analysis math behind LoadSpectrum: mean, true RMS,
+// ripple, and the dominant tones of a Hann-windowed radix-2 FFT over one block of samples.
+#pragma once
+#include <stdint.h>
+
+// Plain C++ (samples and their time span are passed in) like BurstVoter, so
+// scripts/load_spectrum can check it on a PC against known sine and DC inputs.
+// esp-dsp does the FFT on target; elsewhere a portable radix-2 FFT runs.
+class SpectrumBlock {
+public:
+  static constexpr uint16_t N     = 256;         // power of two
+  static constexpr uint8_t  PEAKS = 3;
+  static constexpr float    MIN_TONE_A      = 0.05f;  // smaller tones are sensor noise
+  static constexpr float    TONE_OVER_FLOOR = 6.0f;   // x median bin magnitude
+
+  struct Result {
+    bool     valid = false;
+    uint32_t atMs = 0;           // set by the caller after analyse()
+    float    sampleHz = 0.0f;
+    float    meanA = 0.0f;       // signed average
+    float    rmsA = 0.0f;        // true RMS (includes DC)
+    float    ripplePct = 0.0f;   // AC RMS as % of |mean|
+    uint8_t  peakCount = 0;
+    float    freqHz[PEAKS] = {};
+    float    ampA[PEAKS] = {};   // tone amplitude (peak, A)
+  };
+
+  // Window and twiddles (esp-dsp tables on target); false if esp-dsp init failed
+  bool begin();
+
+  // 'amps' = N samples, oldest first, evenly spread over 'spanUs' (first to last)
+  void analyse(const float* amps, uint32_t spanUs, Result& out);
+
+  // True when analysis uses the esp-dsp vector routines
+  static bool accelerated();
+
+private:
+  void  fft();
+  float noiseFloor();
+
+  float _window[N];
+  float _fft[N * 2];             // interleaved re/im
+  float _mag[N / 2];
+  float _tmp[N / 2];             // noiseFloor() scratch
+  float _cos[N / 2], _sin[N / 2];
+  bool  _ready = false;
+};
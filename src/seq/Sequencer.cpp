@@ -0,0 +1,272 @@
+// File Overview: Implements the relay sequence engine: NVS program storage, the
+// esp_timer step/flash scheduler, loop-side current sampling, and verdicts.
+#include "Sequencer.hpp"
+#include <math.h>
+#include "prefs.hpp"
+#include "flasher.hpp"
+#include "power/Protector.hpp"
+
+// Global instance
+Sequencer sequencer;
+
+void Sequencer::begin(Preferences* prefs) {
+  _prefs = prefs;
+  if (!_timer) {
+    esp_timer_create_args_t args = {};
+    args.callback = &Sequencer::timerThunk;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "seq";
+    if (esp_timer_create(&args, &_timer) != ESP_OK) {
+      _timer = nullptr;
+      Serial.println("[SEQ] esp_timer_create failed");
+    }
+  }
+}
+
+// LEFT 3s -> RIGHT 3s -> BRAKE+TAIL 5s -> hazard flash 10s
+void Sequencer::defaultProgram(SeqProgram& p) {
+  p = SeqProgram{};
+  strncpy(p.name, "Basic", sizeof(p.name) - 1);
+  const uint8_t lampMin = 3;   // 0.3A: something is connected and lit
+  p.steps[0] = {relayBit(R_LEFT), 0, 3000, lampMin, 0};
+  p.steps[1] = {relayBit(R_RIGHT), 0, 3000, lampMin, 0};
+  p.steps[2] = {(uint8_t)(relayBit(R_BRAKE) | relayBit(R_TAIL)), 0, 5000, lampMin, 0};
+  p.steps[3] = {(uint8_t)(relayBit(R_LEFT) | relayBit(R_RIGHT)), SEQ_STEP_FLASH, 10000, lampMin, 0};
+  p.stepCount = 4;
+}
+
+bool Sequencer::load(uint8_t slot, SeqProgram& out) const {
+  if (slot >= SLOT_COUNT) return false;
+  char key[8];
+  snprintf(key, sizeof(key), KEY_SEQ_FMT, (unsigned)slot);
+  if (_prefs && _prefs->getBytesLength(key) == sizeof(SeqProgram) &&
+      _prefs->getBytes(key, &out, sizeof(SeqProgram)) == sizeof(SeqProgram) &&
+      out.stepCount > 0 && out.stepCount <= SeqProgram::MAX_STEPS) {
+    out.name[SeqProgram::NAME_LEN - 1] = '\0';
+    return true;
+  }
+  if (slot == 0) { defaultProgram(out); return true; }
+  return false;
+}
+
+bool Sequencer::requestStart(uint8_t slot) {
+  if (slot >= SLOT_COUNT) return false;
+  _reqStart = (int8_t)slot;
+  return true;
+}
+
+void Sequencer::requestStop() {
+  _reqStop = true;
+}
+
+bool Sequencer::requestStore(uint8_t slot, const SeqProgram& program) {
+  if (slot >= SLOT_COUNT || program.stepCount == 0 || program.stepCount > SeqProgram::MAX_STEPS) return false;
+  portENTER_CRITICAL(&_mux);
+  _reqStoreProg = program;
+  _reqStoreSlot = (int8_t)slot;
+  portEXIT_CRITICAL(&_mux);
+  return true;
+}
+
+void Sequencer::service(float loadA, bool allowed, uint32_t nowMs) {
+  (void)nowMs;
+
+  // Persist uploads here so NVS writes stay on the loop task
+  if (_reqStoreSlot >= 0) {
+    SeqProgram p;
+    int8_t slot;
+    portENTER_CRITICAL(&_mux);
+    p = _reqStoreProg;
+    slot = _reqStoreSlot;
+    _reqStoreSlot = -1;
+    portEXIT_CRITICAL(&_mux);
+    p.name[SeqProgram::NAME_LEN - 1] = '\0';
+    for (uint8_t i = 0; i < p.stepCount; ++i) p.steps[i].mask &= RELAY_MASK_OUTPUTS;
+    if (_prefs) {
+      char key[8];
+      snprintf(key, sizeof(key), KEY_SEQ_FMT, (unsigned)slot);
+      _prefs->putBytes(key, &p, sizeof(p));
+    }
+  }
+
+  if (_reqStop) {
+    _reqStop = false;
+    _reqStart = -1;
+    if (_running) stopRun(SeqVerdict::Aborted);
+  }
+  if (_reqStart >= 0) {
+    uint8_t slot = (uint8_t)_reqStart;
+    _reqStart = -1;
+    if (!_running && allowed) startRun(slot);
+  }
+  if (_running && !allowed) {
+    stopRun(SeqVerdict::Aborted);
+    return;
+  }
+
+  if (!_running || isnan(loadA)) return;
+  const float a = fabsf(loadA);
+  const int64_t nowUs = esp_timer_get_time();
+  portENTER_CRITICAL(&_mux);
+  if (_running && _lit) {
+    const int64_t settleUs = (_prog.steps[_step].flags & SEQ_STEP_FLASH) ? (_flashOnUs / 3)
+                                                                          : (int64_t)STEP_SETTLE_MS * 1000;
+    if ((nowUs - _litSinceUs) >= settleUs) {
+      _sumA += a;
+      if (a > _peakA) _peakA = a;
+      if (_samples < 0xFFFF) _samples++;
+    }
+  }
+  portEXIT_CRITICAL(&_mux);
+}
+
+bool Sequencer::takeResult(SeqResult& out) {
+  bool ready = false;
+  portENTER_CRITICAL(&_mux);
+  if (_resultReady) {
+    out = _result;
+    _resultReady = false;
+    ready = true;
+  }
+  portEXIT_CRITICAL(&_mux);
+  return ready;
+}
+
+const char* Sequencer::verdictName(SeqVerdict v) {
+  switch (v) {
+    case SeqVerdict::Pass:    return "pass";
+    case SeqVerdict::Fail:    return "fail";
+    case SeqVerdict::Aborted: return "abort";
+    default:                  return "none";
+  }
+}
+
+void Sequencer::startRun(uint8_t slot) {
+  SeqProgram p;
+  if (!_timer || !load(slot, p)) return;
+  esp_timer_stop(_timer);
+  Flasher::stop();   // the program owns every output while it runs
+
+  const int64_t nowUs = esp_timer_get_time();
+  portENTER_CRITICAL(&_mux);
+  _prog = p;
+  _slot = slot;
+  _result = SeqResult{};
+  _result.slot = slot;
+  memcpy(_result.name, _prog.name, sizeof(_result.name));
+  _result.stepCount = _prog.stepCount;
+  _resultReady = false;
+  // Flash steps use the flasher's configured rate/duty
+  const int64_t periodUs = 60000000LL / Flasher::fpm();
+  _flashOnUs = periodUs * Flasher::dutyPct() / 100;
+  _flashOffUs = periodUs - _flashOnUs;
+  _running = true;
+  enterStep(0, nowUs);
+  int64_t next = (_stepEndUs < _nextToggleUs) ? _stepEndUs : _nextToggleUs;
+  portEXIT_CRITICAL(&_mux);
+
+  esp_timer_start_once(_timer, (uint64_t)(next - nowUs));
+  Serial.printf("[SEQ] Start slot %u \"%s\" (%u steps)\n", (unsigned)slot, p.name, (unsigned)p.stepCount);
+}
+
+void Sequencer::stopRun(SeqVerdict verdict) {
+  if (_timer) esp_timer_stop(_timer);
+  portENTER_CRITICAL(&_mux);
+  if (_running) {
+    _running = false;
+    _result.verdict = verdict;
+    _resultReady = true;
+    relaysUpdate(RELAY_MASK_OUTPUTS, 0);
+  }
+  portEXIT_CRITICAL(&_mux);
+  Serial.printf("[SEQ] Stopped (%s) after %u/%u steps\n", verdictName(verdict),
+                (unsigned)_result.stepsDone, (unsigned)_result.stepCount);
+}
+
+// Called with _mux held
+void Sequencer::enterStep(uint8_t idx, int64_t startUs) {
+  const SeqStep& s = _prog.steps[idx];
+  _step = idx;
+  _stepStartUs = startUs;
+  _stepEndUs = startUs + (int64_t)s.durationMs * 1000;
+  _lit = true;
+  _litSinceUs = startUs;
+  _nextToggleUs = (s.flags & SEQ_STEP_FLASH) ? (startUs + _flashOnUs) : INT64_MAX;
+  _sumA = 0.0f;
+  _peakA = 0.0f;
+  _samples = 0;
+  relaysUpdate(RELAY_MASK_OUTPUTS, s.mask);
+}
+
+// Called with _mux held
+void Sequencer::closeStep() {
+  const SeqStep& s = _prog.steps[_step];
+  SeqStepResult& r = _result.steps[_step];
+  r.measured = (_samples > 0);
+  float avg = r.measured ? (_sumA / (float)_samples) : 0.0f;
+  auto toDeci = [](float a) -> uint8_t {
+    float d = a * 10.0f + 0.5f;
+    return (uint8_t)(d > 255.0f ? 255.0f : d);
+  };
+  r.avgDeciA = toDeci(avg);
+  r.peakDeciA = toDeci(_peakA);
+  if (s.minDeciA == 0 && s.maxDeciA == 0) {
+    r.pass = true;                 // informational step
+  } else {
+    r.pass = r.measured &&
+             (s.minDeciA == 0 || r.avgDeciA >= s.minDeciA) &&
+             (s.maxDeciA == 0 || r.avgDeciA <= s.maxDeciA);
+  }
+  _result.stepsDone = _step + 1;
+}
+
+void Sequencer::timerThunk(void* arg) {
+  static_cast<Sequencer*>(arg)->onTimer();
+}
+
+void Sequencer::onTimer() {
+  const int64_t nowUs = esp_timer_get_time();
+  int64_t next = 0;
+  // Don't keep stepping while the loop is parked in a fault modal
+  ProtectionState ps;
+  bool fault = protector.tryState(ps) && ps.anyLatched();
+  portENTER_CRITICAL(&_mux);
+  if (!_running) { portEXIT_CRITICAL(&_mux); return; }
+  if (fault) {
+    _running = false;
+    _result.verdict = SeqVerdict::Aborted;
+    _resultReady = true;
+    relaysUpdate(RELAY_MASK_OUTPUTS, 0);
+    portEXIT_CRITICAL(&_mux);
+    return;
+  }
+
+  // Step boundaries chain from the previous deadline, not from 'now'
+  while (_running && nowUs >= _stepEndUs) {
+    closeStep();
+    if ((uint8_t)(_step + 1) >= _prog.stepCount) {
+      relaysUpdate(RELAY_MASK_OUTPUTS, 0);
+      bool pass = true;
+      for (uint8_t i = 0; i < _prog.stepCount; ++i) pass = pass && _result.steps[i].pass;
+      _result.verdict = pass ? SeqVerdict::Pass : SeqVerdict::Fail;
+      _resultReady = true;
+      _running = false;
+    } else {
+      enterStep(_step + 1, _stepEndUs);
+    }
+  }
+  if (_running && nowUs >= _nextToggleUs) {
+    _lit = !_lit;
+    _litSinceUs = _nextToggleUs;
+    _nextToggleUs += _lit ? _flashOnUs : _flashOffUs;
+    relaysUpdate(RELAY_MASK_OUTPUTS, _lit ? _prog.steps[_step].mask : 0);
+  }
+  if (_running) next = (_stepEndUs < _nextToggleUs) ? _stepEndUs : _nextToggleUs;
+  portEXIT_CRITICAL(&_mux);
+
+  if (next) {
+    int64_t delayUs = next - esp_timer_get_time();
+    esp_timer_start_once(_timer, (uint64_t)(delayUs > 50 ? delayUs : 50));
+  }
+}
@@ -0,0 +1,124 @@
+// File Overview: Declares the relay sequence engine that runs stored trailer test
+// programs (timed relay steps with current limits) on an esp_timer and produces a
+// per-step pass/fail verdict.
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+#include "esp_timer.h"
+#include "relays.hpp"
+
+// One program step: which outputs are ON, for how long, and the load current
+// window the lit lamps must fall in. Limits are in tenths of an amp (0..25.5A,
+// the display/OCP range); 0 means "no bound".
+struct SeqStep {
+  uint8_t  mask = 0;          // RelayIndex bits (outputs only)
+  uint8_t  flags = 0;         // SEQ_STEP_*
+  uint16_t durationMs = 0;
+  uint8_t  minDeciA = 0;
+  uint8_t  maxDeciA = 0;
+};
+
+static constexpr uint8_t SEQ_STEP_FLASH = 0x01;   // flash the mask at the flasher's rate/duty
+
+struct SeqProgram {
+  static constexpr uint8_t MAX_STEPS = 16;
+  static constexpr uint8_t NAME_LEN = 12;
+  char    name[NAME_LEN] = {0};
+  uint8_t stepCount = 0;
+  SeqStep steps[MAX_STEPS];
+};
+
+enum class SeqVerdict : uint8_t { None = 0, Pass, Fail, Aborted };
+
+struct SeqStepResult {
+  uint8_t avgDeciA = 0;       // mean current while lit, after settling
+  uint8_t peakDeciA = 0;
+  bool    measured = false;   // at least one sample was taken
+  bool    pass = false;
+};
+
+struct SeqResult {
+  uint8_t       slot = 0;
+  char          name[SeqProgram::NAME_LEN] = {0};
+  uint8_t       stepCount = 0;
+  uint8_t       stepsDone = 0;
+  SeqVerdict    verdict = SeqVerdict::None;
+  SeqStepResult steps[SeqProgram::MAX_STEPS];
+};
+
+// Steps are switched from an esp_timer callback against absolute deadlines, so
+// step lengths don't inherit loop() jitter. Current is sampled from the loop's
+// telemetry and folded into the running step. Start/stop/store requests may come
+// from the BLE task; they are handed to the loop through service().
+class Sequencer {
+public:
+  static constexpr uint8_t SLOT_COUNT = 4;
+
+  void begin(Preferences* prefs);
+
+  // Loop task: apply deferred requests, enforce run conditions, and sample current.
+  // 'allowed' is false outside RF mode or while any protection latch is active.
+  void service(float loadA, bool allowed, uint32_t nowMs);
+
+  // Any task
+  bool requestStart(uint8_t slot);
+  void requestStop();
+  bool requestStore(uint8_t slot, const SeqProgram& program);
+
+  bool running() const { return _running; }
+  uint8_t runningSlot() const { return _slot; }
+  uint8_t currentStep() const { return _step; }
+  uint8_t stepCount() const { return _prog.stepCount; }
+
+  bool load(uint8_t slot, SeqProgram& out) const;
+
+  // Loop task: true once per finished run, copying its result
+  bool takeResult(SeqResult& out);
+  const SeqResult& lastResult() const { return _result; }
+
+  static const char* verdictName(SeqVerdict v);
+
+private:
+  static void timerThunk(void* arg);
+  void onTimer();
+  void startRun(uint8_t slot);
+  void stopRun(SeqVerdict verdict);
+  void enterStep(uint8_t idx, int64_t startUs);
+  void closeStep();
+  static void defaultProgram(SeqProgram& p);
+
+  Preferences* _prefs = nullptr;
+  esp_timer_handle_t _timer = nullptr;
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+  // Run state (shared with the timer callback under _mux)
+  volatile bool _running = false;
+  uint8_t    _slot = 0;
+  uint8_t    _step = 0;
+  SeqProgram _prog;
+  int64_t    _stepStartUs = 0;
+  int64_t    _stepEndUs = 0;
+  int64_t    _nextToggleUs = 0;
+  int64_t    _litSinceUs = 0;
+  int64_t    _flashOnUs = 0;
+  int64_t    _flashOffUs = 0;
+  bool       _lit = false;
+
+  // Current accumulators for the running step
+  float    _sumA = 0.0f;
+  float    _peakA = 0.0f;
+  uint16_t _samples = 0;
+
+  SeqResult _result;
+  bool      _resultReady = false;
+
+  // Deferred requests
+  volatile int8_t _reqStart = -1;
+  volatile bool   _reqStop = false;
+  volatile int8_t _reqStoreSlot = -1;
+  SeqProgram      _reqStoreProg;
+
+  static constexpr uint32_t STEP_SETTLE_MS  = 250;   // skip relay bounce and lamp inrush
+};
+
+extern Sequencer sequencer;
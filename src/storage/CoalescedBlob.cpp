@@ -0,0 +1,41 @@
+// File Overview: Implements the write-coalescing NVS blob (rate-limited writes of a
+// caller-owned RAM image).
+#include "CoalescedBlob.hpp"
+
+void CoalescedBlob::begin(Preferences* prefs, const char* key, void* data, size_t len,
+                          uint32_t minIntervalMs, uint32_t maxDelayMs) {
+  _prefs = prefs;
+  _key = key;
+  _data = data;
+  _len = len;
+  _minIntervalMs = minIntervalMs;
+  _maxDelayMs = maxDelayMs < minIntervalMs ? minIntervalMs : maxDelayMs;
+  _dirty = false;
+}
+
+bool CoalescedBlob::load() {
+  if (!_prefs || !_key || _prefs->getBytesLength(_key) != _len) return false;
+  return _prefs->getBytes(_key, _data, _len) == _len;
+}
+
+void CoalescedBlob::markDirty(uint32_t nowMs) {
+  if (!_dirty) {
+    _dirty = true;
+    _dirtySinceMs = nowMs;
+  }
+}
+
+void CoalescedBlob::service(uint32_t nowMs, bool quiet) {
+  if (!_dirty) return;
+  const bool rateOk = (_writes == 0) || (nowMs - _lastWriteMs) >= _minIntervalMs;
+  if (!rateOk) return;
+  if (quiet || (nowMs - _dirtySinceMs) >= _maxDelayMs) flush(nowMs);
+}
+
+void CoalescedBlob::flush(uint32_t nowMs) {
+  if (!_dirty || !_prefs || !_key) return;
+  _prefs->putBytes(_key, _data, _len);
+  _dirty = false;
+  _lastWriteMs = nowMs;
+  _writes++;
+}
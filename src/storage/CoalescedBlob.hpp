@@ -0,0 +1,44 @@
+// File Overview: Declares a write-coalescing wrapper for one NVS blob: callers mark the
+// RAM copy dirty as often as they like and the blob is written at a bounded rate, or
+// immediately when a flush is forced (before OTA, on a supply fault).
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+
+// The RAM image is owned by the caller; this only decides when to copy it to
+// flash. At most one write per minInterval, and no dirty data older than
+// maxDelay (counters that change every second would otherwise be written every
+// minInterval, which is the point: bounded, predictable NVS wear).
+class CoalescedBlob {
+public:
+  void begin(Preferences* prefs, const char* key, void* data, size_t len,
+             uint32_t minIntervalMs, uint32_t maxDelayMs);
+
+  // Copy the stored blob into the RAM image; false if absent or a different size
+  bool load();
+
+  void markDirty(uint32_t nowMs);
+  bool dirty() const { return _dirty; }
+
+  // Loop task: write if due. 'quiet' lets a pending write go out at minInterval
+  // instead of waiting for maxDelay (e.g. when the outputs are idle).
+  void service(uint32_t nowMs, bool quiet);
+
+  // Write now if dirty
+  void flush(uint32_t nowMs);
+
+  uint32_t writes() const { return _writes; }
+
+private:
+  Preferences* _prefs = nullptr;
+  const char*  _key = nullptr;
+  void*        _data = nullptr;
+  size_t       _len = 0;
+  uint32_t     _minIntervalMs = 0;
+  uint32_t     _maxDelayMs = 0;
+
+  bool     _dirty = false;
+  uint32_t _dirtySinceMs = 0;
+  uint32_t _lastWriteMs = 0;
+  uint32_t _writes = 0;
+};
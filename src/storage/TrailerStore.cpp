@@ -0,0 +1,340 @@
+// File Overview: Implements the trailer baseline store: SPIFFS record file and index
+// maintenance, name lookups by binary search, and the per-channel drift comparison.
+#include "TrailerStore.hpp"
+#include <SPIFFS.h>
+#include <math.h>
+#include "prefs.hpp"
+
+TrailerStore trailerStore;
+
+namespace {
+  constexpr const char* DATA_PATH  = "/trailers.dat";
+  constexpr const char* INDEX_PATH = "/trailers.idx";
+
+  struct IndexHeader {
+    uint32_t magic;
+    uint16_t count;
+    uint16_t slots;       // data file length in records when the index was written
+    uint32_t generation;  // store generation the index matches (see bumpGeneration)
+  };
+}
+
+void TrailerStore::normalize(const char* in, char* out) {
+  uint8_t n = 0;
+  while (in && *in == ' ') ++in;
+  while (in && *in && n < TrailerProfile::NAME_LEN - 1) {
+    char c = *in++;
+    out[n++] = (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+  }
+  while (n && out[n - 1] == ' ') --n;
+  memset(out + n, 0, TrailerProfile::NAME_LEN - n);
+}
+
+void TrailerStore::begin(Preferences* prefs) {
+  _prefs = prefs;
+  // Formats the (empty) partition on first boot
+  if (!SPIFFS.begin(true)) {
+    Serial.println("[TRL] SPIFFS mount failed; trailer profiles disabled");
+    return;
+  }
+  if (!SPIFFS.exists(DATA_PATH)) {
+    File f = SPIFFS.open(DATA_PATH, FILE_WRITE);
+    f.close();
+  }
+  _data = SPIFFS.open(DATA_PATH, "r+");
+  if (!_data) {
+    Serial.println("[TRL] Cannot open trailer data file");
+    return;
+  }
+  _ready = true;
+  if (_prefs) _generation = _prefs->getULong(KEY_TRAILER_GEN, 0);
+  if (!loadIndex()) rebuildIndex();
+
+  if (_prefs) {
+    char name[TrailerProfile::NAME_LEN] = {0};
+    _prefs->getString(KEY_TRAILER_ACTIVE, name, sizeof(name));
+    if (name[0] && find(name, _active)) _haveActive = true;
+  }
+  Serial.printf("[TRL] %u trailer profile(s)%s%s\n", (unsigned)_count,
+                _haveActive ? ", active " : "", _haveActive ? _active.name : "");
+}
+
+bool TrailerStore::loadIndex() {
+  File f = SPIFFS.open(INDEX_PATH, FILE_READ);
+  if (!f) return false;
+  IndexHeader h{};
+  bool ok = f.read(reinterpret_cast<uint8_t*>(&h), sizeof(h)) == sizeof(h) &&
+            h.magic == INDEX_MAGIC && h.count <= MAX_PROFILES &&
+            h.generation == _generation && h.slots == _data.size() / sizeof(Record);
+  if (ok) {
+    const size_t bytes = (size_t)h.count * sizeof(IndexEntry);
+    ok = f.read(reinterpret_cast<uint8_t*>(_index), bytes) == bytes;
+  }
+  f.close();
+  if (!ok) return false;
+  _count = h.count;
+  memset(_slotUsed, 0, sizeof(_slotUsed));
+  for (uint16_t i = 0; i < _count; ++i) {
+    const uint16_t s = _index[i].slot;
+    if (s >= MAX_PROFILES) return false;
+    _slotUsed[s >> 3] |= (uint8_t)(1u << (s & 7));
+  }
+  return true;
+}
+
+// One sequential pass over the data file: only when the index file is missing
+// or stale (first boot, power lost between the data and index writes)
+void TrailerStore::rebuildIndex() {
+  _count = 0;
+  memset(_slotUsed, 0, sizeof(_slotUsed));
+  size_t slots = _data.size() / sizeof(Record);
+  if (slots > MAX_PROFILES) slots = MAX_PROFILES;
+  _data.seek(0, SeekSet);
+  for (uint16_t s = 0; s < (uint16_t)slots; ++s) {
+    Record rec;
+    if (_data.read(reinterpret_cast<uint8_t*>(&rec), sizeof(rec)) != sizeof(rec)) break;
+    if (rec.used != RECORD_USED || rec.version != RECORD_VERSION) continue;
+    rec.p.name[TrailerProfile::NAME_LEN - 1] = '\0';
+    char name[TrailerProfile::NAME_LEN];
+    normalize(rec.p.name, name);
+    // A second record with the same name (never written by saveLast) stays free
+    if (!name[0] || findOrdinal(name, nullptr) >= 0) continue;
+    insertEntry(name, s);
+  }
+  saveIndex();
+  Serial.printf("[TRL] Index rebuilt (%u profiles)\n", (unsigned)_count);
+}
+
+void TrailerStore::saveIndex() {
+  File f = SPIFFS.open(INDEX_PATH, FILE_WRITE);
+  if (!f) return;
+  IndexHeader h{INDEX_MAGIC, _count, (uint16_t)(_data.size() / sizeof(Record)), _generation};
+  f.write(reinterpret_cast<const uint8_t*>(&h), sizeof(h));
+  f.write(reinterpret_cast<const uint8_t*>(_index), (size_t)_count * sizeof(IndexEntry));
+  f.close();
+}
+
+// Called before a data file change that the index must follow (slot taken or
+// freed). NVS commits the new generation first, so losing power anywhere between
+// here and saveIndex() leaves an index with an older generation, rebuilt at boot.
+void TrailerStore::bumpGeneration() {
+  _generation++;
+  if (_prefs) _prefs->putULong(KEY_TRAILER_GEN, _generation);
+}
+
+// Names are zero-padded to NAME_LEN, so memcmp orders them like strcmp
+uint16_t TrailerStore::lowerBound(const char* name) const {
+  uint16_t lo = 0, hi = _count;
+  while (lo < hi) {
+    const uint16_t mid = (uint16_t)((lo + hi) / 2);
+    if (memcmp(_index[mid].name, name, TrailerProfile::NAME_LEN) < 0) lo = mid + 1;
+    else                                                            hi = mid;
+  }
+  return lo;
+}
+
+// 'name' normalized and not yet in the index; 'slot' marked used
+void TrailerStore::insertEntry(const char* name, uint16_t slot) {
+  const uint16_t at = lowerBound(name);
+  memmove(&_index[at + 1], &_index[at], (_count - at) * sizeof(IndexEntry));
+  memcpy(_index[at].name, name, TrailerProfile::NAME_LEN);
+  _index[at].slot = slot;
+  _count++;
+  _slotUsed[slot >> 3] |= (uint8_t)(1u << (slot & 7));
+}
+
+bool TrailerStore::readSlot(uint16_t slot, TrailerProfile& out) {
+  if (_cacheSlot == (int32_t)slot) { out = _cache; return true; }
+  Record rec;
+  if (!_data.seek((uint32_t)slot * sizeof(Record), SeekSet)) return false;
+  if (_data.read(reinterpret_cast<uint8_t*>(&rec), sizeof(rec)) != sizeof(rec)) return false;
+  if (rec.used != RECORD_USED || rec.version != RECORD_VERSION) return false;
+  rec.p.name[TrailerProfile::NAME_LEN - 1] = '\0';
+  _cache = rec.p;
+  _cacheSlot = slot;
+  out = rec.p;
+  return true;
+}
+
+bool TrailerStore::writeSlot(uint16_t slot, const TrailerProfile* p) {
+  Record rec{};
+  if (p) {
+    rec.used = RECORD_USED;
+    rec.version = RECORD_VERSION;
+    rec.p = *p;
+  }
+  _cacheSlot = -1;
+  // Seeking to the end extends the file for a new slot
+  if (!_data.seek((uint32_t)slot * sizeof(Record), SeekSet)) return false;
+  const bool ok = _data.write(reinterpret_cast<const uint8_t*>(&rec), sizeof(rec)) == sizeof(rec);
+  _data.flush();
+  return ok;
+}
+
+int TrailerStore::freeSlot() const {
+  for (uint16_t s = 0; s < MAX_PROFILES; ++s) {
+    if (!(_slotUsed[s >> 3] & (1u << (s & 7)))) return s;
+  }
+  return -1;
+}
+
+// Index position of 'name' (already normalized) or -1: one binary search, and
+// one record read only when the caller wants the profile
+int TrailerStore::findOrdinal(const char* name, TrailerProfile* out) {
+  const uint16_t i = lowerBound(name);
+  if (i >= _count || memcmp(_index[i].name, name, TrailerProfile::NAME_LEN) != 0) return -1;
+  if (out && !readSlot(_index[i].slot, *out)) return -1;
+  return i;
+}
+
+bool TrailerStore::at(uint16_t ordinal, TrailerProfile& out) {
+  if (!_ready || ordinal >= _count) return false;
+  return readSlot(_index[ordinal].slot, out);
+}
+
+bool TrailerStore::find(const char* name, TrailerProfile& out) {
+  if (!_ready) return false;
+  char norm[TrailerProfile::NAME_LEN];
+  normalize(name, norm);
+  return norm[0] && findOrdinal(norm, &out) >= 0;
+}
+
+bool TrailerStore::saveLast(const char* name) {
+  if (!_ready || !_haveLast || _last.aborted) return false;
+  TrailerProfile p;
+  normalize(name, p.name);
+  if (!p.name[0]) return false;
+  for (uint8_t i = 0; i < WiringReport::CHANNELS; ++i) {
+    const WireChannelResult& r = _last.ch[i];
+    p.ch[i].cls = (uint8_t)r.cls;
+    p.ch[i].settledDeciA = r.settledDeciA;
+    p.ch[i].peakDeciA = r.peakDeciA;
+    p.ch[i].dropCentiV = r.dropCentiV;
+  }
+
+  const int existing = findOrdinal(p.name, nullptr);
+  if (existing >= 0) {
+    if (!writeSlot(_index[existing].slot, &p)) return false;
+  } else {
+    const int slot = freeSlot();
+    if (slot < 0 || _count >= MAX_PROFILES) {
+      Serial.println("[TRL] Store full");
+      return false;
+    }
+    bumpGeneration();
+    if (!writeSlot((uint16_t)slot, &p)) return false;
+    insertEntry(p.name, (uint16_t)slot);
+    saveIndex();
+  }
+  if (_haveActive && strncmp(_active.name, p.name, TrailerProfile::NAME_LEN) == 0) _active = p;
+  Serial.printf("[TRL] Saved \"%s\" (%u profiles)\n", p.name, (unsigned)_count);
+  return true;
+}
+
+bool TrailerStore::remove(const char* name) {
+  if (!_ready) return false;
+  char norm[TrailerProfile::NAME_LEN];
+  normalize(name, norm);
+  const int i = norm[0] ? findOrdinal(norm, nullptr) : -1;
+  if (i < 0) return false;
+  const uint16_t slot = _index[i].slot;
+  bumpGeneration();
+  writeSlot(slot, nullptr);
+  memmove(&_index[i], &_index[i + 1], (_count - i - 1) * sizeof(IndexEntry));
+  _count--;
+  _slotUsed[slot >> 3] &= (uint8_t)~(1u << (slot & 7));
+  saveIndex();
+  if (_haveActive && strncmp(_active.name, norm, TrailerProfile::NAME_LEN) == 0) setActive(nullptr);
+  Serial.printf("[TRL] Removed \"%s\"\n", norm);
+  return true;
+}
+
+bool TrailerStore::setActive(const char* name) {
+  if (!name || !name[0]) {
+    _haveActive = false;
+    if (_prefs) _prefs->remove(KEY_TRAILER_ACTIVE);
+    return true;
+  }
+  TrailerProfile p;
+  if (!find(name, p)) return false;
+  _active = p;
+  _haveActive = true;
+  if (_prefs) _prefs->putString(KEY_TRAILER_ACTIVE, p.name);
+  return true;
+}
+
+bool TrailerStore::noteReport(const WiringReport& r, TrailerDrift& out) {
+  if (r.aborted) return false;
+  _last = r;
+  _haveLast = true;
+  if (!_haveActive) return false;
+  compare(_active, r, out);
+  if (out.driftedMask) {
+    Serial.printf("[TRL] \"%s\": drift on mask 0x%02X\n", out.name, (unsigned)out.driftedMask);
+  }
+  return true;
+}
+
+bool TrailerStore::request(Op op, const char* name) {
+  if (op == Op::None) return false;
+  portENTER_CRITICAL(&_mux);
+  _pendingOp = op;
+  memset(_pendingName, 0, sizeof(_pendingName));
+  if (name) strncpy(_pendingName, name, sizeof(_pendingName) - 1);
+  portEXIT_CRITICAL(&_mux);
+  return true;
+}
+
+bool TrailerStore::service(bool& ok) {
+  if (_pendingOp == Op::None) return false;
+  char name[TrailerProfile::NAME_LEN];
+  portENTER_CRITICAL(&_mux);
+  const Op op = _pendingOp;
+  memcpy(name, _pendingName, sizeof(name));
+  _pendingOp = Op::None;
+  portEXIT_CRITICAL(&_mux);
+  switch (op) {
+    case Op::Save:   ok = saveLast(name); break;
+    case Op::Select: ok = setActive(name); break;
+    case Op::Remove: ok = remove(name); break;
+    case Op::Query:  ok = _ready; break;
+    default:         ok = false; break;
+  }
+  return true;
+}
+
+bool TrailerStore::compare(const TrailerProfile& ref, const WiringReport& now, TrailerDrift& out) {
+  out = TrailerDrift{};
+  memcpy(out.name, ref.name, sizeof(out.name));
+  for (uint8_t i = 0; i < WiringReport::CHANNELS; ++i) {
+    const TrailerChannelRef& a = ref.ch[i];
+    const WireChannelResult& b = now.ch[i];
+    uint8_t f = 0;
+
+    const WireClass refCls = (WireClass)a.cls;
+    if (refCls != b.cls && refCls != WireClass::NotRun && b.cls != WireClass::NotRun) f |= TRL_DRIFT_CLASS;
+
+    const float refA = a.settledDeciA / 10.0f;
+    const float nowA = b.settledDeciA / 10.0f;
+    const float tolA = fmaxf(MIN_DELTA_A, refA * DELTA_FRAC);
+    if (nowA < refA - tolA) f |= TRL_DRIFT_LOW;
+    if (nowA > refA + tolA) f |= TRL_DRIFT_HIGH;
+
+    if (refCls == WireClass::Incandescent && b.cls == WireClass::Incandescent &&
+        a.settledDeciA && b.settledDeciA) {
+      const float refRatio = (float)a.peakDeciA / a.settledDeciA;
+      const float nowRatio = (float)b.peakDeciA / b.settledDeciA;
+      if (fabsf(nowRatio - refRatio) > refRatio * INRUSH_FRAC) f |= TRL_DRIFT_INRUSH;
+    }
+
+    if (a.dropCentiV || b.dropCentiV) {
+      const float refV = a.dropCentiV / 100.0f;
+      const float nowV = b.dropCentiV / 100.0f;
+      if (fabsf(nowV - refV) > fmaxf(MIN_VDROP_V, refV * VDROP_FRAC)) f |= TRL_DRIFT_VDROP;
+    }
+
+    out.flags[i] = f;
+    if (f) out.driftedMask |= relayBit((RelayIndex)i);
+  }
+  return out.driftedMask != 0;
+}
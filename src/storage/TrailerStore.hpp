@@ -0,0 +1,135 @@
+// File Overview: Declares the SPIFFS-backed trailer baseline store: named per-trailer
+// wiring signatures (settled current, inrush peak, output sag per channel) with a
+// sorted in-RAM index, and the drift comparison run after each wiring diagnostic.
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include <Preferences.h>
+#include "diag/WiringDiag.hpp"
+
+struct TrailerChannelRef {
+  uint8_t cls = 0;              // WireClass
+  uint8_t settledDeciA = 0;
+  uint8_t peakDeciA = 0;
+  uint8_t dropCentiV = 0;       // output sag with this channel on
+};
+
+struct TrailerProfile {
+  static constexpr uint8_t NAME_LEN = 20;
+  char              name[NAME_LEN] = {0};    // stored upper-case
+  TrailerChannelRef ch[WiringReport::CHANNELS];
+};
+
+// Per-channel drift bits of a comparison against the stored baseline
+static constexpr uint8_t TRL_DRIFT_LOW    = 0x01;   // current fell (lamp out, bad ground)
+static constexpr uint8_t TRL_DRIFT_HIGH   = 0x02;   // current rose (extra load, leakage)
+static constexpr uint8_t TRL_DRIFT_INRUSH = 0x04;   // filament inrush changed shape
+static constexpr uint8_t TRL_DRIFT_VDROP  = 0x08;   // output sag changed (connection resistance)
+static constexpr uint8_t TRL_DRIFT_CLASS  = 0x10;   // load type changed (open/short/cross/LED<->bulb)
+
+struct TrailerDrift {
+  char    name[TrailerProfile::NAME_LEN] = {0};
+  uint8_t flags[WiringReport::CHANNELS] = {};
+  uint8_t driftedMask = 0;      // relayBit() of channels with any flag
+};
+
+// Profiles live in one fixed-record file (slot = offset / record size); the
+// index is a name-sorted array of {full normalized name, slot} kept in RAM
+// (22 B x MAX_PROFILES = 11 KB) and mirrored to its own file, so a lookup is
+// a binary search plus at most one record read, however many names share a
+// prefix, and browsing in name order never touches the other records. The data
+// file stays open, so a knob-driven list only pays for seek + read. The index
+// header carries a generation counter mirrored in NVS; a mismatch at boot
+// (power lost between the data and index writes) rebuilds it from the data.
+class TrailerStore {
+public:
+  static constexpr uint16_t MAX_PROFILES = 512;
+
+  void begin(Preferences* prefs);          // mounts SPIFFS, loads or rebuilds the index
+  bool ready() const { return _ready; }
+
+  // Loop task: apply a deferred BLE request; true (with 'ok') when one ran
+  bool service(bool& ok);
+
+  uint16_t count() const { return _count; }
+  bool     at(uint16_t ordinal, TrailerProfile& out);     // name order
+  bool     find(const char* name, TrailerProfile& out);
+
+  // Loop task: store the last finished diagnostic under 'name' (replaces an existing one)
+  bool saveLast(const char* name);
+  bool remove(const char* name);
+  bool setActive(const char* name);       // nullptr / "" clears
+
+  bool hasLastReport() const { return _haveLast; }
+  bool hasActive() const { return _haveActive; }
+  const TrailerProfile& active() const { return _active; }
+
+  // Loop task, once per finished diagnostic: kept for saveLast() and, with an
+  // active trailer, compared against it. True when 'out' holds a comparison.
+  bool noteReport(const WiringReport& r, TrailerDrift& out);
+
+  // Any task: staged for service()
+  enum class Op : uint8_t { None, Save, Select, Remove, Query };
+  bool request(Op op, const char* name);
+
+  static bool compare(const TrailerProfile& ref, const WiringReport& now, TrailerDrift& out);
+
+private:
+  struct IndexEntry {
+    char     name[TrailerProfile::NAME_LEN];   // normalized, zero-padded
+    uint16_t slot;
+  };
+  struct Record {
+    uint8_t        used;          // RECORD_USED, anything else = free slot
+    uint8_t        version;
+    uint16_t       reserved;
+    TrailerProfile p;
+  };
+
+  bool   loadIndex();
+  void   rebuildIndex();
+  void   saveIndex();
+  void   bumpGeneration();
+  bool   readSlot(uint16_t slot, TrailerProfile& out);
+  bool   writeSlot(uint16_t slot, const TrailerProfile* p);   // nullptr frees the slot
+  int    findOrdinal(const char* name, TrailerProfile* out);
+  uint16_t lowerBound(const char* name) const;
+  void   insertEntry(const char* name, uint16_t slot);
+  int    freeSlot() const;
+  static void normalize(const char* in, char* out);
+
+  static constexpr uint8_t RECORD_USED = 0xA5;
+  static constexpr uint8_t RECORD_VERSION = 1;
+  static constexpr uint32_t INDEX_MAGIC = 0x54524C33;   // "TRL3" (full-name keys)
+
+  Preferences* _prefs = nullptr;
+  bool         _ready = false;
+  File         _data;
+
+  IndexEntry   _index[MAX_PROFILES];
+  uint16_t     _count = 0;
+  uint8_t      _slotUsed[MAX_PROFILES / 8] = {};
+  uint32_t     _generation = 0;
+
+  // One-record cache: moving the list highlight redraws the row just read
+  int32_t        _cacheSlot = -1;
+  TrailerProfile _cache;
+
+  TrailerProfile _active;
+  bool           _haveActive = false;
+  WiringReport   _last;
+  bool           _haveLast = false;
+
+  portMUX_TYPE  _mux = portMUX_INITIALIZER_UNLOCKED;
+  volatile Op   _pendingOp = Op::None;
+  char          _pendingName[TrailerProfile::NAME_LEN] = {0};
+
+  // Drift tolerances
+  static constexpr float MIN_DELTA_A     = 0.3f;
+  static constexpr float DELTA_FRAC      = 0.15f;  // of the reference current
+  static constexpr float INRUSH_FRAC     = 0.30f;  // peak/settled ratio change
+  static constexpr float MIN_VDROP_V     = 0.10f;
+  static constexpr float VDROP_FRAC      = 0.30f;
+};
+
+extern TrailerStore trailerStore;
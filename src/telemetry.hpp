@@ -1,13 +1,25 @@
 // File Overview: Simple struct bundling the live voltage/current measurements and latch
 // states that flow between the sensor, protection, and UI layers.
 #pragma once
+#include <math.h>
 struct Telemetry {
   float srcV = 0.0f;
   float loadA = 0.0f;
+  float loadRmsA = NAN;    // true RMS over the last sampler block (NAN = none recent)
   float outV = 0.0f;       // 12V buck output voltage (from LOAD INA226 bus voltage)
   bool  lvpLatched = false;
   bool  ocpLatched = false;
   bool  outvLatched = false; // Output Voltage Low/Fault latched
+  bool  revLatched = false;  // Reverse current (back-feed) trip latched
+  bool  revWarn = false;     // Sustained reverse current below trip level
   uint16_t cooldownSecsRemaining = 0; // Cooldown timer: 0=inactive, >0=active countdown
   bool cooldownActive = false;        // True when in cooldown (unit disabled)
+  bool lvpWarn = false;               // Predicted sag at present load is near/below LVP cutoff
+  uint16_t battRintMilliOhm = 0;      // Fitted battery internal resistance (0 = not yet fitted)
+  uint8_t battSohPct = 0xFF;          // Battery state of health 0..100% (0xFF = unknown)
+  bool seqRunning = false;            // Stored test sequence is driving the outputs
+  bool diagRunning = false;           // Wiring diagnostic is driving the outputs
+  int8_t bleedOn = -1;                // Channel-bleed suspect: channel switched ON...
+  int8_t bleedInto = -1;              // ...and the OFF channel whose load it also drives
+  bool wiggleActive = false;          // Harness wiggle (flicker) test is listening
 };